@@ -29,14 +29,36 @@ HEADERS += \
 	external/CppUtils-Network/NetAddress.hpp \
 	external/CppUtils-Network/Socket.hpp \
 	external/CppUtils-Network/SystemErrorInfo.hpp \
+	include/OpenRGB/Animation.hpp \
+	include/OpenRGB/Canvas.hpp \
 	include/OpenRGB/Client.hpp \
 	include/OpenRGB/Color.hpp \
+	include/OpenRGB/ColorConversion.hpp \
+	include/OpenRGB/ColorCorrection.hpp \
+	include/OpenRGB/ColorKernels.hpp \
+	include/OpenRGB/ConcurrentClient.hpp \
 	include/OpenRGB/DeviceInfo.hpp \
+	include/OpenRGB/Effects.hpp \
 	include/OpenRGB/Exceptions.hpp \
+	include/OpenRGB/FrameScheduler.hpp \
+	include/OpenRGB/Layout.hpp \
+	include/OpenRGB/Server.hpp \
+	include/OpenRGB/ShardedClient.hpp \
+	include/OpenRGB/Snapshot.hpp \
+	include/OpenRGB/Span.hpp \
 	include/OpenRGB/SystemErrorType.hpp \
+	include/OpenRGB/ThreadPool.hpp \
+	include/OpenRGB/TrafficLog.hpp \
+	src/ColorNames.hpp \
+	src/CorrectionRegistry.hpp \
+	src/CorrectionSegment.hpp \
+	src/CpuFeatures.hpp \
+	src/MappedFile.hpp \
+	src/MessageCodec.hpp \
 	src/MiscUtils.hpp \
 	src/ProtocolCommon.hpp \
-	src/ProtocolMessages.hpp
+	src/ProtocolMessages.hpp \
+	src/StateMirror.hpp
 
 SOURCES += \
 	external/CppUtils-Essential/BinaryStream.cpp \
@@ -49,13 +71,31 @@ SOURCES += \
 	external/CppUtils-Network/NetAddress.cpp \
 	external/CppUtils-Network/Socket.cpp \
 	external/CppUtils-Network/SystemErrorInfo.cpp \
+	src/Animation.cpp \
+	src/Canvas.cpp \
 	src/Client.cpp \
 	src/Color.cpp \
+	src/ColorConversion.cpp \
+	src/ColorCorrection.cpp \
+	src/ConcurrentClient.cpp \
+	src/CorrectionRegistry.cpp \
+	src/ColorKernels.cpp \
+	src/CpuFeatures.cpp \
 	src/DeviceInfo.cpp \
+	src/Effects.cpp \
 	src/Exceptions.cpp \
+	src/FrameScheduler.cpp \
+	src/Layout.cpp \
+	src/MappedFile.cpp \
 	src/MiscUtils.cpp \
 	src/ProtocolCommon.cpp \
 	src/ProtocolMessages.cpp \
+	src/Server.cpp \
+	src/ShardedClient.cpp \
+	src/Snapshot.cpp \
+	src/StateMirror.cpp \
+	src/ThreadPool.cpp \
+	src/TrafficLog.cpp \
 	src/test/main.cpp
 
 DISTFILES += \
@@ -69,3 +109,5 @@ release {
 }
 
 win32: LIBS += -lws2_32
+unix: QMAKE_CXXFLAGS += -pthread
+unix: LIBS += -pthread
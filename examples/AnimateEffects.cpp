@@ -0,0 +1,102 @@
+//======================================================================================================================
+//  animate layered effects on all devices at a steady frame rate until an INTERRUPT signal
+//    - variant handling errors by checking return values
+//======================================================================================================================
+
+/// \file
+
+#include <cstdio>    // printf
+#include <csignal>   // signal
+#include <memory>    // unique_ptr
+#include <chrono>    // duration_cast
+using namespace std::chrono;
+
+#include "OpenRGB/Client.hpp"
+#include "OpenRGB/Effects.hpp"
+#include "OpenRGB/FrameScheduler.hpp"
+using orgb::ConnectStatus;
+using orgb::RequestStatus;
+using orgb::enumString;
+using orgb::DeviceListResult;
+using orgb::Device;
+using orgb::Color;
+
+
+static volatile bool keepRunning = false;
+
+void signalFunc( int )
+{
+	keepRunning = false;
+}
+
+static void printHistogram( const char * name, const orgb::TimeHistogram & histogram )
+{
+	printf( "%-8s mean %6lld us, p99 %6lld us, max %6lld us\n", name,
+		(long long)duration_cast< microseconds >( histogram.mean() ).count(),
+		(long long)duration_cast< microseconds >( histogram.percentile( 0.99 ) ).count(),
+		(long long)duration_cast< microseconds >( histogram.max() ).count()
+	);
+}
+
+int main( int /*argc*/, char * /*argv*/ [] )
+{
+	static const char * hostName = "127.0.0.1";  // you can also use the NetBIOS computer name
+
+	orgb::Client client( "My OpenRGB Client" );
+
+	// a clean way to quit the application without killing it by force
+	keepRunning = true;
+	signal( SIGINT, signalFunc );
+
+	ConnectStatus connectStatus = client.connect( hostName );
+	if (connectStatus != ConnectStatus::Success)
+	{
+		printf( "connection failed: %s (error code: %d)\n", enumString( connectStatus ), int( client.getLastSystemError() ) );
+		return 1;
+	}
+
+	DeviceListResult result = client.requestDeviceList();
+	if (result.status != RequestStatus::Success)
+	{
+		printf( "failed to get device list: %s (error code: %d)\n", enumString( result.status ), int( client.getLastSystemError() ) );
+		return 1;
+	}
+
+	// some devices don't accept colors until you set them to custom mode
+	for (const Device & device : result.devices)
+		client.switchToCustomMode( device );
+
+	orgb::EffectEngine engine( result.devices );
+	engine.addLayer( std::unique_ptr< orgb::GradientLayer >( new orgb::GradientLayer( Color::Blue, Color::Magenta ) ) );
+	auto & wave = engine.addLayer( std::unique_ptr< orgb::WaveLayer >( new orgb::WaveLayer( Color::White, 0.5f, 0.5f ) ) );
+	wave.blendMode = orgb::BlendMode::Add;
+	wave.opacity = 128;
+
+	// OpenRGB doesn't handle too many requests at once, 20 frames per second is safe for a few devices
+	orgb::FrameScheduler scheduler( 20.0 );
+	scheduler.run(
+		[&]( const orgb::FrameScheduler::Frame & frame )
+		{
+			engine.render( frame.time );
+			return keepRunning;
+		},
+		[&]( const orgb::FrameScheduler::Frame & )
+		{
+			RequestStatus status = engine.push( client );
+			if (status != RequestStatus::Success)
+			{
+				printf( "failed to send colors: %s (error code: %d)\n", enumString( status ), int( client.getLastSystemError() ) );
+				return false;
+			}
+			return keepRunning;
+		}
+	);
+
+	const orgb::FrameStats & stats = scheduler.stats();
+	printf( "frames: %llu, skipped: %llu\n", (unsigned long long)stats.frames, (unsigned long long)stats.skippedFrames );
+	printHistogram( "jitter", stats.jitter );
+	printHistogram( "render", stats.renderTime );
+	printHistogram( "send", stats.sendTime );
+
+	return 0;
+}
@@ -0,0 +1,222 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: pre-rendered animations stored in files that are played directly from memory mapping
+//======================================================================================================================
+
+#ifndef OPENRGB_ANIMATION_INCLUDED
+#define OPENRGB_ANIMATION_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+#include "SystemErrorType.hpp"  // HACK: read the comment at the top of that header file
+
+#include <cstdint>
+#include <cstdio>  // FILE
+#include <string>
+#include <vector>
+#include <memory>  // unique_ptr<MappedFile>
+#include <chrono>  // microseconds
+
+
+namespace orgb {
+
+
+class MappedFile;
+class Client;
+enum class RequestStatus;
+
+
+//======================================================================================================================
+//  animation file format
+//
+//  Numbers are stored in the native byte order of the writer, like in the device list snapshot. The frames contain
+//  the colors of all LEDs of all devices in the order of FrameBuffer, so a raw frame is used directly from the mapped
+//  file without any decoding.
+//
+//  AnimationHeader
+//  uint32_t device_led_counts [device_count]
+//  ... frames, each aligned to 4 bytes ...
+//  AnimationFrameEntry frame_table [frame_count]
+//
+//  A raw frame is an array of led_count colors. A delta frame contains only the colors that changed since
+//  the previous frame, as a sequence of runs: uint32_t first, uint32_t count, Color colors [count].
+
+/// current version of the animation format, files of other versions are refused
+constexpr uint32_t animationFormatVersion = 1;
+
+/// Beginning of every animation file.
+struct AnimationHeader
+{
+	char      magic [8];           ///< must always be "ORGBANIM"
+	uint32_t  format_version;      ///< see animationFormatVersion
+	uint32_t  byte_order;          ///< 0x01020304 written in the native byte order of the writer
+	uint64_t  total_size;          ///< size of the whole file including this header
+	uint64_t  layout_fingerprint;  ///< see layoutFingerprint()
+	uint32_t  device_count;
+	uint32_t  led_count;           ///< number of colors in one frame
+	uint32_t  frame_count;
+	uint32_t  frame_period_us;     ///< time between frames in microseconds
+	uint64_t  frame_table_offset;  ///< from the beginning of the file
+};
+
+enum class AnimationFrameType : uint32_t
+{
+	Raw   = 0,
+	Delta = 1,
+};
+
+/// Entry of the frame table at the end of an animation file.
+struct AnimationFrameEntry
+{
+	uint64_t            offset;  ///< from the beginning of the file
+	uint32_t            size;    ///< in bytes
+	AnimationFrameType  type;
+};
+
+/// Hash of the names and LED counts of all devices and zones.
+/** An animation can only be played on a device list with the same fingerprint it was recorded for. */
+uint64_t layoutFingerprint( const DeviceList & devices ) noexcept;
+
+
+//======================================================================================================================
+
+/// All the possible ways how an operation with an animation can end up
+enum class AnimationStatus
+{
+	Success,             ///< The operation was successful.
+	CannotOpenFile,      ///< The file could not be opened, created or mapped into memory. Call getLastSystemError() for more info.
+	CannotWriteFile,     ///< The file could not be written or replaced, check errno (GetLastError() on Windows) for more info.
+	InvalidFormat,       ///< The data are not an animation or they are damaged.
+	VersionNotSupported, ///< The animation was written by an incompatible version of this library or on a different architecture.
+	WrongFrameSize,      ///< The number of colors in the frame doesn't match the number of LEDs of the animation.
+	NotOpen,             ///< The writer has not been opened or it has already been finished.
+	UnexpectedError,     ///< Internal error of this library. This should not happen unless there is a mistake in the code, please create a github issue.
+};
+const char * enumString( AnimationStatus status ) noexcept;
+
+
+//======================================================================================================================
+/// Records frames into an animation file.
+/** Frames that differ from the previous one only in a few LEDs are stored as deltas, unless they are keyframes.
+  * Keyframes are stored whole, so that the player can jump to any frame quickly. */
+
+class AnimationWriter
+{
+
+ public:
+
+	AnimationWriter() noexcept;
+	~AnimationWriter() noexcept;
+
+	AnimationWriter( const AnimationWriter & other ) = delete;
+	AnimationWriter & operator=( const AnimationWriter & other ) = delete;
+
+	/// Creates the file and remembers the layout of the devices.
+	/** \param keyframeInterval every n-th frame is stored whole, 1 turns the delta compression off */
+	AnimationStatus open( const std::string & filePath, const DeviceList & devices, double framesPerSecond,
+	                      uint32_t keyframeInterval = 30 ) noexcept;
+
+	/// Appends a frame with the colors of all LEDs in the order of FrameBuffer.
+	AnimationStatus addFrame( Span< const Color > colors ) noexcept;
+
+	/// Writes the frame table and makes the file visible under its name.
+	/** The file is written under a temporary name until now, so players never see an incomplete animation. */
+	AnimationStatus finish() noexcept;
+
+	/// Abandons the animation and deletes the temporary file.
+	void cancel() noexcept;
+
+	bool isOpen() const noexcept  { return _file != nullptr; }
+
+ private:
+
+	AnimationStatus writeBytes( const void * data, size_t size ) noexcept;
+
+	FILE * _file;
+	std::string _filePath;
+	std::string _tempPath;
+	AnimationHeader _header;
+	uint32_t _keyframeInterval;
+	uint64_t _position;
+	std::vector< Color > _previous;
+	std::vector< uint8_t > _deltaBuffer;
+	std::vector< AnimationFrameEntry > _frames;
+
+};
+
+
+//======================================================================================================================
+/// Plays an animation file mapped directly into memory.
+/** Raw frames are returned as views into the mapping and sent from there, only the delta frames are applied
+  * to an internal buffer. Multiple players of the same file share its pages in memory. */
+
+class AnimationPlayer
+{
+
+ public:
+
+	AnimationPlayer() noexcept;
+	~AnimationPlayer() noexcept;
+
+	// The mapping cannot be shared.
+	AnimationPlayer( const AnimationPlayer & other ) = delete;
+	AnimationPlayer( AnimationPlayer && other ) noexcept;
+	AnimationPlayer & operator=( AnimationPlayer && other ) noexcept;
+
+	/// Maps the animation file into memory and validates it.
+	AnimationStatus open( const std::string & filePath ) noexcept;
+
+	/// Releases the mapping, all the frames obtained from this player become invalid.
+	void close() noexcept;
+
+	bool isOpen() const noexcept  { return _header != nullptr; }
+
+	uint32_t frameCount() const noexcept  { return _header ? _header->frame_count : 0; }
+	uint32_t ledCount() const noexcept    { return _header ? _header->led_count : 0; }
+	std::chrono::microseconds framePeriod() const noexcept  { return std::chrono::microseconds( _header ? _header->frame_period_us : 0 ); }
+
+	/// Tells whether the animation was recorded for devices with the same layout.
+	bool matches( const DeviceList & devices ) const noexcept;
+
+	/// Colors of all LEDs in a frame, in the order of FrameBuffer.
+	/** The result is valid until the next call of frame(...), push(...) or close(). Playing the frames in order
+	  * is the fastest, jumping back costs decoding from the nearest keyframe. */
+	Span< const Color > frame( uint32_t frameIdx ) noexcept;
+
+	/// Sends a frame to all the devices.
+	/** The devices must match the animation, see matches(...). Returns the first failure, but still tries to update
+	  * the remaining devices. */
+	RequestStatus push( Client & client, const DeviceList & devices, uint32_t frameIdx ) noexcept;
+
+	/// Returns the system error code that caused the last failure.
+	system_error_t getLastSystemError() const noexcept  { return _lastSystemError; }
+
+ private:
+
+	void applyDelta( const AnimationFrameEntry & entry ) noexcept;
+
+	// a pointer so that we don't have to include the OS dependant mapping here
+	std::unique_ptr< MappedFile > _file;
+	const AnimationHeader * _header;
+	Span< const uint32_t > _deviceLedCounts;
+	Span< const AnimationFrameEntry > _frames;
+
+	std::vector< Color > _decoded;  ///< result of applying the delta frames
+	uint32_t _decodedIdx;           ///< which frame is currently in _decoded, or UINT32_MAX
+
+	system_error_t _lastSystemError;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_ANIMATION_INCLUDED
@@ -0,0 +1,102 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: 2D pixel grid mapped to the LEDs of a matrix zone
+//======================================================================================================================
+
+#ifndef OPENRGB_CANVAS_INCLUDED
+#define OPENRGB_CANVAS_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// 2D grid of pixels covering a matrix zone, like a keyboard or an LED panel.
+/** Effects draw into the pixels as into an image and scatter(...) then moves the colors to the LEDs of the zone
+  * in one pass over a precomputed index, so there is no lookup of the matrix map per pixel.
+  * Zones that aren't matrices are treated as a single row of all their LEDs. */
+
+class Canvas
+{
+
+ public:
+
+	/// Value of Zone::matrix_values meaning there is no LED at this position.
+	static constexpr uint32_t NoLed = 0xFFFFFFFF;
+
+	Canvas() noexcept : _width( 0 ), _height( 0 ), _ledCount( 0 ) {}
+	explicit Canvas( const Zone & zone )  { reset( zone ); }
+
+	/// Rebuilds the mapping for a zone, call it after every new Client::requestDeviceList() or zone resize.
+	/** All the pixels are set to black. */
+	void reset( const Zone & zone );
+
+	uint32_t width() const noexcept     { return _width; }
+	uint32_t height() const noexcept    { return _height; }
+	uint32_t ledCount() const noexcept  { return _ledCount; }
+
+	/// All the pixels, row by row.
+	Span< Color > pixels() noexcept              { return Span< Color >( _pixels.data(), size_t( _width ) * _height ); }
+	Span< const Color > pixels() const noexcept  { return Span< const Color >( _pixels.data(), size_t( _width ) * _height ); }
+
+	/// Pixels of a single row.
+	Span< Color > row( uint32_t y ) noexcept              { return Span< Color >( &_pixels[ size_t( y ) * _width ], _width ); }
+	Span< const Color > row( uint32_t y ) const noexcept  { return Span< const Color >( &_pixels[ size_t( y ) * _width ], _width ); }
+
+	Color & at( uint32_t x, uint32_t y ) noexcept              { return _pixels[ size_t( y ) * _width + x ]; }
+	const Color & at( uint32_t x, uint32_t y ) const noexcept  { return _pixels[ size_t( y ) * _width + x ]; }
+
+	/// Sets all the pixels to one color.
+	void clear( Color color = Color::Black ) noexcept;
+
+	/// Index of the LED within the zone at this position, or NoLed.
+	uint32_t ledIndex( uint32_t x, uint32_t y ) const noexcept;
+
+	/// Writes the pixels into the colors of the zone's LEDs, LEDs that have no pixel are set to black.
+	/** \param ledColors colors of the zone's LEDs, must have at least ledCount() elements */
+	void scatter( Span< Color > ledColors ) const noexcept;
+
+	/// Reads the colors of the zone's LEDs into the pixels, positions without an LED are set to black.
+	/** \param ledColors colors of the zone's LEDs, must have at least ledCount() elements */
+	void gather( Span< const Color > ledColors ) noexcept;
+
+	/// Scatters the pixels into an internal array that can be sent directly via Client::setZoneColors().
+	Span< const Color > ledColors() noexcept;
+
+ private:
+
+	uint32_t _width;
+	uint32_t _height;
+	uint32_t _ledCount;
+
+	/// width * height pixels followed by one extra that stays black, so that unmapped LEDs don't need a branch
+	std::vector< Color > _pixels;
+
+	/// index of the pixel for each LED of the zone
+	std::vector< uint32_t > _pixelOfLed;
+
+	/// index of the LED for each pixel, or NoLed
+	std::vector< uint32_t > _ledOfPixel;
+
+	std::vector< Color > _ledColors;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_CANVAS_INCLUDED
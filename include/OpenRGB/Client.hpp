@@ -11,11 +11,17 @@
 
 #include "DeviceInfo.hpp"
 #include "Color.hpp"
+#include "ColorCorrection.hpp"
+#include "Span.hpp"
 #include "SystemErrorType.hpp"  // HACK: read the comment at the top of that header file
 
 #include <string>  // client name
 #include <memory>  // unique_ptr<Socket>
+#include <vector>  // send buffer
+#include <array>   // header buffer
+#include <deque>   // abandoned replies
 #include <chrono>  // timeout
+#include <atomic>  // CancellationToken
 
 namespace own {
 	class TcpSocket;
@@ -25,6 +31,13 @@ namespace own {
 namespace orgb {
 
 
+class Client;
+class CorrectionRegistry;
+class StateMirror;
+class TrafficRecorder;
+struct Header;
+enum class MessageType : uint32_t;
+
 constexpr uint16_t defaultPort = 6742;
 
 
@@ -56,6 +69,7 @@ enum class RequestStatus
 	NoReply,            ///< No reply has arrived from the server in given timeout. In case this happens too often, you may try to increase the timeout.
 	ReceiveError,       ///< There has been some other error while trying to receive a reply. Call getLastSystemError() for more info.
 	InvalidReply,       ///< The reply from the server is invalid.
+	Cancelled,          ///< The request was cancelled through its CancellationToken.
 	UnexpectedError,    ///< Internal error of this library. This should not happen unless there is a mistake in the code, please create a github issue.
 };
 const char * enumString( RequestStatus status ) noexcept;
@@ -65,6 +79,7 @@ enum class UpdateStatus
 {
 	UpToDate,           ///< The current device list seems up to date.
 	OutOfDate,          ///< Server has sent a notification message indicating that the device list has changed. Call requestDeviceList() again.
+	NotConnected,       ///< The client is not connected. Call connect() first.
 	ConnectionClosed,   ///< Server has closed the connection.
 	UnexpectedMessage,  ///< Server has sent some other kind of message that we didn't expect.
 	CantRestoreSocket,  ///< Error has occured while trying to restore socket to its original state and the socket has been closed. Call getLastSystemError() for more info. This should never happen, but one never knows.
@@ -73,6 +88,49 @@ enum class UpdateStatus
 };
 const char * enumString( UpdateStatus status ) noexcept;
 
+/// Flag for aborting a blocking request from another thread, see RequestLimits.
+class CancellationToken
+{
+	std::atomic< bool > _cancelled;
+
+ public:
+
+	CancellationToken() noexcept : _cancelled( false ) {}
+
+	/// Makes the requests waiting with this token give up as soon as possible.
+	void cancel() noexcept  { _cancelled.store( true ); }
+
+	/// Makes the token usable for the next requests.
+	void reset() noexcept  { _cancelled.store( false ); }
+
+	bool isCancelled() const noexcept  { return _cancelled.load(); }
+};
+
+/// Bounds of a single blocking request, passed to the overloads of the request methods that wait for a reply.
+/** Without its own deadline, the request waits for every part of a reply as long as the timeout of the client allows.
+  * When a request gives up, the connection stays usable, the rest of the abandoned reply is skipped before the next
+  * reply is read. */
+struct RequestLimits
+{
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point deadline;       ///< the request gives up with RequestStatus::NoReply when the reply isn't complete by then
+	const CancellationToken * token;  ///< the request gives up with RequestStatus::Cancelled soon after this is cancelled, may be null
+
+	/// No deadline of its own and no token, the same as calling the overload without limits.
+	RequestLimits() noexcept : deadline( Clock::time_point::max() ), token( nullptr ) {}
+
+	/// The whole request must finish within the timeout counted from now.
+	explicit RequestLimits( std::chrono::milliseconds timeout, const CancellationToken * token = nullptr ) noexcept
+		: deadline( Clock::now() + timeout ), token( token ) {}
+
+	/// The request can be cancelled, otherwise it waits as long as the timeout of the client allows.
+	explicit RequestLimits( const CancellationToken & token ) noexcept
+		: deadline( Clock::time_point::max() ), token( &token ) {}
+
+	bool hasDeadline() const noexcept  { return deadline != Clock::time_point::max(); }
+};
+
 /// Result and output of a device list request
 struct DeviceListResult
 {
@@ -95,6 +153,14 @@ struct DeviceInfoResult
 	// The device has to be a pointer because user is not allowed to use the constructors.
 };
 
+/// Result and output of a device request that doesn't parse devices that haven't changed
+struct DeviceChangeResult
+{
+	RequestStatus status;  ///< whether the request suceeded or why it didn't
+	bool changed;          ///< false when the device is the same as in the previous reply for this device index
+	std::unique_ptr< Device > device;  ///< output of a successfull request, null when the device hasn't changed
+};
+
 /// Result and output of a profile list request
 struct ProfileListResult
 {
@@ -102,6 +168,36 @@ struct ProfileListResult
 	std::vector< std::string > profiles;  ///< output of a successfull request
 };
 
+/// State of a device as it was last set through a Client, see Client::enableStateMirror().
+struct DeviceState
+{
+	uint32_t activeMode;         ///< index of the active mode
+	Span< const Color > colors;  ///< colors of all LEDs of the device, in the order of Device::leds
+};
+
+
+//======================================================================================================================
+/// Interface for reacting to the messages that the server sends on its own, see Client::addNotificationListener().
+/** The methods are called from inside the Client call that has received the message, which can be any request,
+  * checkForDeviceUpdates() or processNotifications(). The client is in the middle of receiving at that moment,
+  * so the listener must not use it, remember what happened and react after the call returns. An exception thrown
+  * by a listener is caught and reported to stderr, the remaining listeners are still notified. */
+
+class NotificationListener
+{
+
+ public:
+
+	virtual ~NotificationListener() = default;
+
+	/// The server has changed its device list, requestDeviceList() needs to be called again.
+	virtual void deviceListUpdated( Client & /*client*/ ) {}
+
+	/// The server has sent a message of a type this library doesn't know yet, its body is skipped.
+	virtual void unknownNotification( Client & /*client*/, uint32_t /*messageType*/, uint32_t /*deviceIdx*/ ) {}
+
+};
+
 
 //======================================================================================================================
 /// OpenRGB network client.
@@ -120,8 +216,9 @@ class Client
 	// The connection cannot be shared.
 	Client( const Client & other ) = delete;
 
-	Client( Client && other ) noexcept = default;
-	Client & operator=( Client && other ) noexcept = default;
+	// Defined in the cpp, where the internal classes behind the pointers are complete.
+	Client( Client && other ) noexcept;
+	Client & operator=( Client && other ) noexcept;
 
 	/// Tells whether the client is currently connected to a server.
 	bool isConnected() const noexcept;
@@ -136,52 +233,143 @@ class Client
 	bool disconnect() noexcept;
 
 	/// Sets a timeout for receiving request answers.
+	/** It applies to every part of a reply separately, use the RequestLimits overloads to bound a whole request.
+	  * When called before connect(), it's applied when the connection is made. */
 	bool setTimeout( std::chrono::milliseconds timeout ) noexcept;
 
 	/// Queries the server for information about all its RGB devices.
 	DeviceListResult requestDeviceList() noexcept;
 
+	/// Variant of requestDeviceList() that gives up at the deadline of the limits or when their token is cancelled.
+	/** The deadline bounds the download of the whole list, not only of a single device. */
+	DeviceListResult requestDeviceList( const RequestLimits & limits ) noexcept;
+
 	/// Queries the server for the number of its RGB devices.
 	/** This is useful when for some reason you want to request the devices manually one by one. */
 	DeviceCountResult requestDeviceCount() noexcept;
 
+	/// Variant of requestDeviceCount() that gives up at the deadline of the limits or when their token is cancelled.
+	DeviceCountResult requestDeviceCount( const RequestLimits & limits ) noexcept;
+
 	/// Queries the server for information about a single RGB devices.
 	/** After you set a color or change a mode, you can optionally use this to update */
 	DeviceInfoResult requestDeviceInfo( uint32_t deviceIdx ) noexcept;
 
+	/// Variant of requestDeviceInfo() that gives up at the deadline of the limits or when their token is cancelled.
+	DeviceInfoResult requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits ) noexcept;
+
+	/// Queries the server for information about a single RGB device, but parses the reply only when it has changed.
+	/** The client remembers a hash of the last reply for every device index it requested with this function. When
+	  * the new reply is the same, the device is not parsed and the one you received before is still up to date.
+	  * Use this for polling the devices, parsing a device costs much more than hashing it. */
+	DeviceChangeResult requestDeviceInfoIfChanged( uint32_t deviceIdx ) noexcept;
+
+	/// Variant of requestDeviceInfoIfChanged() that gives up at the deadline of the limits or when their token is cancelled.
+	DeviceChangeResult requestDeviceInfoIfChanged( uint32_t deviceIdx, const RequestLimits & limits ) noexcept;
+
 	/// Checks if the device list you downloaded earlier via requestDeviceList() hasn't been changed on the server.
 	/** In case it has been changed, you need to call requestDeviceList() again. */
 	UpdateStatus checkForDeviceUpdates() noexcept;
 
+	/// Receives all the messages that have already arrived and passes the notifications to the listeners.
+	/** Doesn't wait for anything, call it whenever your application has time, for example once per frame.
+	  * Unlike checkForDeviceUpdates() it always reads the socket, even when the device list is already known to be
+	  * out of date. Returns the same statuses as checkForDeviceUpdates(). */
+	UpdateStatus processNotifications() noexcept;
+
 	/// Switches the device to a directly controlled color mode.
 	/** This seems unsupported by many RGB controllers, and it's probably deprecated in the OpenRGB app. */
 	RequestStatus switchToCustomMode( const Device & device ) noexcept;
 
 	/// Updates the parameters of a mode and also switches the device to this mode.
 	/** If you just want to switch the mode, use one of the Mode objects received from the server via requestDeviceList().
-	  * If you want to change the parameters of a mode, create a copy of the Mode object, change the parameters of the copy
-	  * and pass the copy to this function. */
+	  * If you want to change the parameters of a mode, use the overload with ModeParams. */
 	RequestStatus changeMode( const Device & device, const Mode & mode ) noexcept;
 
+	/// Switches the device to a mode and sends the parameters instead of those stored in the mode.
+	/** Neither the mode nor the colors of the params are copied, so this is suitable for changing the speed or brightness
+	  * many times per second. */
+	RequestStatus changeMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept;
+
 	/// Saves the mode parameters into the device memory to make it persistent??
 	/** I don't really know what this does, ask the OpenRGB devs. */
 	RequestStatus saveMode( const Device & device, const Mode & mode ) noexcept;
 
+	/// Variant of saveMode( const Device &, const Mode & ) that saves the parameters instead of those stored in the mode.
+	RequestStatus saveMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept;
+
 	/// Sets one unified color for the whole device.
 	RequestStatus setDeviceColor( const Device & device, Color color ) noexcept;
 
 	/// Sets a color of a particular zone of a device.
 	RequestStatus setZoneColor( const Zone & zone, Color color ) noexcept;
 
+	/// Sets individual colors of all LEDs of a device in one request.
+	/** The colors should contain one color for each LED of the device, in the order of Device::leds. */
+	RequestStatus setDeviceColors( const Device & device, Span< const Color > colors ) noexcept;
+
+	/// Sets individual colors of all LEDs of a zone in one request.
+	/** The colors should contain one color for each LED of the zone. */
+	RequestStatus setZoneColors( const Zone & zone, Span< const Color > colors ) noexcept;
+
 	/// Resizes a zone of leds, if the device supports it.
 	RequestStatus setZoneSize( const Zone & zone, uint32_t newSize ) noexcept;
 
 	/// Sets a color of a single selected LED.
 	RequestStatus setLEDColor( const LED & led, Color color ) noexcept;
 
+	/// Registers a color correction that will be applied to all colors sent to this device.
+	/** Replaces the previous correction of this device. */
+	void setColorCorrection( const Device & device, const ColorCorrection & correction );
+
+	/// Registers a color correction that will be applied to all colors sent to this zone.
+	/** It has priority over the correction of the whole device. setLEDColor() cannot tell which zone the LED belongs to,
+	  * so it uses the correction of the whole device. */
+	void setColorCorrection( const Zone & zone, const ColorCorrection & correction );
+
+	/// Stops correcting the colors of this device. Corrections of its zones stay.
+	void removeColorCorrection( const Device & device ) noexcept;
+
+	/// Stops correcting the colors of this zone. The correction of its device will be used again.
+	void removeColorCorrection( const Zone & zone ) noexcept;
+
+	/// Removes all the registered color corrections.
+	void clearColorCorrections() noexcept;
+
+	/// Starts writing all the messages sent and received by this client into the recorder, nullptr stops it.
+	/** The recorder is not owned by the client and must stay alive as long as it's set.
+	  * The messages the client throws away without reading their body, like the replies to the requests that gave up
+	  * waiting or the notifications it doesn't know, are not recorded. */
+	void setTrafficRecorder( TrafficRecorder * recorder ) noexcept;
+
+	/// Starts calling the listener for every notification received by this client.
+	/** The listener is not owned by the client and must stay alive until it's removed. */
+	void addNotificationListener( NotificationListener * listener );
+
+	/// Stops calling the listener.
+	void removeNotificationListener( NotificationListener * listener ) noexcept;
+
+	/// Starts or stops keeping a local copy of the colors and the active mode of every device.
+	/** The copy is filled from every device list or device info received after enabling it and then updated by every
+	  * successfully sent request, so that the current state can be read by mirroredState() without asking the server.
+	  * The copy holds the colors as they were passed in, before any color correction. Changes made by other clients,
+	  * switchToCustomMode() and setZoneSize() are not reflected, request the device again to see them. */
+	void enableStateMirror( bool enable );
+
+	/// Fills the state mirror from a device list received before the mirror was enabled.
+	void seedStateMirror( const DeviceList & devices );
+
+	/// Returns the state of the device as it was last set through this client.
+	/** When the mirror is disabled or the device was not received since enabling it, returns the state stored in the
+	  * device. The colors are valid until the next request of the device list or this device, or disabling the mirror. */
+	DeviceState mirroredState( const Device & device ) const noexcept;
+
 	/// Queries the server for a list of saved profiles.
 	ProfileListResult requestProfileList();
 
+	/// Variant of requestProfileList() that gives up at the deadline of the limits or when their token is cancelled.
+	ProfileListResult requestProfileList( const RequestLimits & limits );
+
 	/// Saves the current configuration of all devices under a new profile name.
 	RequestStatus saveProfile( const std::string & profileName );
 
@@ -215,23 +403,59 @@ class Client
 	  * \throws SystemError when there was an error inside the operating system */
 	DeviceList requestDeviceListX();
 
+	/// Exception-throwing variant of requestDeviceList( const RequestLimits & ).
+	/** \throws UserError when the client is not connected or the request was cancelled
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received before the deadline
+	  * \throws SystemError when there was an error inside the operating system */
+	DeviceList requestDeviceListX( const RequestLimits & limits );
+
 	/// Exception-throwing variant of requestDeviceCount().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received
 	  * \throws SystemError when there was an error inside the operating system */
 	uint32_t requestDeviceCountX();
 
+	/// Exception-throwing variant of requestDeviceCount( const RequestLimits & ).
+	/** \throws UserError when the client is not connected or the request was cancelled
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received before the deadline
+	  * \throws SystemError when there was an error inside the operating system */
+	uint32_t requestDeviceCountX( const RequestLimits & limits );
+
 	/// Exception-throwing variant of requestDeviceInfo().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received
 	  * \throws SystemError when there was an error inside the operating system */
 	std::unique_ptr< Device > requestDeviceInfoX( uint32_t deviceIdx );
 
+	/// Exception-throwing variant of requestDeviceInfo( uint32_t, const RequestLimits & ).
+	/** \throws UserError when the client is not connected or the request was cancelled
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received before the deadline
+	  * \throws SystemError when there was an error inside the operating system */
+	std::unique_ptr< Device > requestDeviceInfoX( uint32_t deviceIdx, const RequestLimits & limits );
+
+	/// Exception-throwing variant of requestDeviceInfoIfChanged(). Returns null when the device hasn't changed.
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received
+	  * \throws SystemError when there was an error inside the operating system */
+	std::unique_ptr< Device > requestDeviceInfoIfChangedX( uint32_t deviceIdx );
+
+	/// Exception-throwing variant of requestDeviceInfoIfChanged( uint32_t, const RequestLimits & ).
+	/** \throws UserError when the client is not connected or the request was cancelled
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received before the deadline
+	  * \throws SystemError when there was an error inside the operating system */
+	std::unique_ptr< Device > requestDeviceInfoIfChangedX( uint32_t deviceIdx, const RequestLimits & limits );
+
 	/// Exception-throwing variant of checkForDeviceUpdates().
 	/** \throws ConnectionError when the server closes the connection or sends an invalid packet
 	  * \throws SystemError when there was an error inside the operating system */
 	bool isDeviceListOutdatedX();
 
+	/// Exception-throwing variant of processNotifications(), returns whether the device list is out of date.
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when the server closes the connection or sends an invalid packet
+	  * \throws SystemError when there was an error inside the operating system */
+	bool processNotificationsX();
+
 	/// Exception-throwing variant of switchToCustomMode().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent
@@ -244,12 +468,24 @@ class Client
 	  * \throws SystemError when there was an error inside the operating system */
 	void changeModeX( const Device & device, const Mode & mode );
 
+	/// Exception-throwing variant of changeMode( const Device &, const Mode &, const ModeParams & ).
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when a request couldn't be sent
+	  * \throws SystemError when there was an error inside the operating system */
+	void changeModeX( const Device & device, const Mode & mode, const ModeParams & params );
+
 	/// Exception-throwing variant of saveMode().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent
 	  * \throws SystemError when there was an error inside the operating system */
 	void saveModeX( const Device & device, const Mode & mode );
 
+	/// Exception-throwing variant of saveMode( const Device &, const Mode &, const ModeParams & ).
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when a request couldn't be sent
+	  * \throws SystemError when there was an error inside the operating system */
+	void saveModeX( const Device & device, const Mode & mode, const ModeParams & params );
+
 	/// Exception-throwing variant of setDeviceColor().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent
@@ -262,6 +498,18 @@ class Client
 	  * \throws SystemError when there was an error inside the operating system */
 	void setZoneColorX( const Zone & zone, Color color );
 
+	/// Exception-throwing variant of setDeviceColors().
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when a request couldn't be sent
+	  * \throws SystemError when there was an error inside the operating system */
+	void setDeviceColorsX( const Device & device, Span< const Color > colors );
+
+	/// Exception-throwing variant of setZoneColors().
+	/** \throws UserError when the client is not connected
+	  * \throws ConnectionError when a request couldn't be sent
+	  * \throws SystemError when there was an error inside the operating system */
+	void setZoneColorsX( const Zone & zone, Span< const Color > colors );
+
 	/// Exception-throwing variant of setZoneSize().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent
@@ -280,6 +528,12 @@ class Client
 	  * \throws SystemError when there was an error inside the operating system */
 	std::vector< std::string > requestProfileListX();
 
+	/// Exception-throwing variant of requestProfileList( const RequestLimits & ).
+	/** \throws UserError when the client is not connected or the request was cancelled
+	  * \throws ConnectionError when a request couldn't be sent or no valid reply was received before the deadline
+	  * \throws SystemError when there was an error inside the operating system */
+	std::vector< std::string > requestProfileListX( const RequestLimits & limits );
+
 	/// Exception-throwing variant of saveProfile().
 	/** \throws UserError when the client is not connected
 	  * \throws ConnectionError when a request couldn't be sent
@@ -314,18 +568,21 @@ class Client
 	ConnectStatus _connect( const std::string & host, uint16_t port );
 	bool _disconnect() noexcept;
 	bool _setTimeout( std::chrono::milliseconds timeout ) noexcept;
-	DeviceListResult _requestDeviceList();
-	DeviceCountResult _requestDeviceCount();
-	DeviceInfoResult _requestDeviceInfo( uint32_t deviceIdx );
+	DeviceListResult _requestDeviceList( const RequestLimits & limits );
+	DeviceCountResult _requestDeviceCount( const RequestLimits & limits );
+	DeviceInfoResult _requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits );
+	DeviceChangeResult _requestDeviceInfoIfChanged( uint32_t deviceIdx, const RequestLimits & limits );
 	UpdateStatus _checkForDeviceUpdates() noexcept;
 	RequestStatus _switchToCustomMode( const Device & device );
-	RequestStatus _changeMode( const Device & device, const Mode & mode );
-	RequestStatus _saveMode( const Device & device, const Mode & mode );
+	RequestStatus _changeMode( const Device & device, const Mode & mode, const ModeParams & params );
+	RequestStatus _saveMode( const Device & device, const Mode & mode, const ModeParams & params );
 	RequestStatus _setDeviceColor( const Device & device, Color color );
 	RequestStatus _setZoneColor( const Zone & zone, Color color );
+	RequestStatus _setDeviceColors( const Device & device, Span< const Color > colors );
+	RequestStatus _setZoneColors( const Zone & zone, Span< const Color > colors );
 	RequestStatus _setZoneSize( const Zone & zone, uint32_t newSize );
 	RequestStatus _setLEDColor( const LED & led, Color color );
-	ProfileListResult _requestProfileList();
+	ProfileListResult _requestProfileList( const RequestLimits & limits );
 	RequestStatus _saveProfile( const std::string & profileName );
 	RequestStatus _loadProfile( const std::string & profileName );
 	RequestStatus _deleteProfile( const std::string & profileName );
@@ -340,13 +597,41 @@ class Client
 		Message message;
 	};
 	template< typename Message >
-	RecvResult< Message > awaitMessage() noexcept;
+	RecvResult< Message > awaitMessage( const RequestLimits & limits ) noexcept;
+
+	/// Receives the header and the body of a message into _recvBuffer, without parsing the body.
+	RequestStatus awaitMessageBody( MessageType expectedType, Header & header, const RequestLimits & limits ) noexcept;
+
+	/// Receives the rest of the bytes, received counts the bytes already there and is updated even when it fails.
+	RequestStatus receiveBytes( uint8_t * data, size_t size, size_t & received, const RequestLimits & limits ) noexcept;
+	/// Receives a header into _headerBuffer, continuing the one whose receiving was interrupted last time.
+	/** When the header doesn't start with the magic, it searches the following bytes for it. */
+	RequestStatus receiveHeader( Header & header, const RequestLimits & limits ) noexcept;
+	/// Reads and throws away the rest of a message that nobody waits for.
+	RequestStatus skipUnwantedBody( const RequestLimits & limits ) noexcept;
+	/// Tells whether a message of this type is a late reply to a request that gave up waiting, and forgets it if so.
+	bool takeAbandonedReply( MessageType type ) noexcept;
 
 	UpdateStatus checkForUpdateMessageArrival() noexcept;
+	/// Calls the listeners of the notification with this header.
+	void notifyListeners( const Header & header ) noexcept;
+
+	// used by the ShardedClient, whose other connections never request the device list themselves
+	friend class ShardedClient;
+
+	// used by the ConcurrentClient to write many requests that don't expect a reply at once
+	friend class ConcurrentClient;
+	/// Makes the following requests only append their messages to _batchBuffer instead of sending them.
+	void beginBatch() noexcept;
+	/// Sends all the messages appended since beginBatch() in one write.
+	RequestStatus endBatch() noexcept;
+	/// Number of bytes appended since beginBatch().
+	size_t batchSize() const noexcept  { return _batchBuffer.size(); }
 
 #ifndef NO_EXCEPTIONS
 	void connectStatusToException( ConnectStatus status );
 	void requestStatusToException( RequestStatus status );
+	bool updateStatusToException( UpdateStatus status );
 #endif // NO_EXCEPTIONS
 
  private:
@@ -360,6 +645,41 @@ class Client
 
 	bool _isDeviceListOutOfDate;
 
+	std::chrono::milliseconds _timeout;        ///< set by the user
+	std::chrono::milliseconds _socketTimeout;  ///< currently set on the socket, it changes while waiting with RequestLimits
+
+	// a pointer so that the registry stays internal to the library
+	std::unique_ptr< CorrectionRegistry > _colorCorrections;
+
+	// null when the mirror is disabled
+	std::unique_ptr< StateMirror > _stateMirror;
+
+	// kept between the requests, so that sending colors every frame doesn't allocate
+	std::vector< uint8_t > _sendBuffer;
+	std::vector< uint8_t > _recvBuffer;
+
+	// Receiving state that survives a request giving up, so that the next request can find where its reply starts.
+	std::array< uint8_t, 16 > _headerBuffer;  ///< Header::size()
+	size_t _headerReceived;   ///< bytes of a header whose receiving was interrupted
+	size_t _bodyToSkip;       ///< bytes of an abandoned or unexpected message that haven't been received yet
+	std::deque< MessageType > _abandonedReplies;  ///< types of the replies that haven't started arriving yet, oldest first
+
+	// hashes of the last ReplyControllerData bodies received by requestDeviceInfoIfChanged(), indexed by device
+	struct PayloadHash
+	{
+		bool valid;
+		uint64_t value;
+	};
+	std::vector< PayloadHash > _deviceInfoHashes;
+
+	TrafficRecorder * _trafficRecorder;
+
+	// not owned, see addNotificationListener()
+	std::vector< NotificationListener * > _listeners;
+
+	bool _batching;
+	std::vector< uint8_t > _batchBuffer;
+
 };
 
 
@@ -9,6 +9,8 @@
 #define OPENRGB_COLOR_INCLUDED
 
 
+#include "Span.hpp"  // StringView
+
 #include <cstdint>
 #include <iosfwd>
 #include <string>
@@ -37,13 +39,15 @@ class Color
 	uint8_t padding;
 
 	Color() noexcept = default;
-	Color( uint8_t red, uint8_t green, uint8_t blue ) noexcept : r( red ), g( green ), b( blue ) {}
+	Color( uint8_t red, uint8_t green, uint8_t blue ) noexcept : r( red ), g( green ), b( blue ), padding( 0 ) {}
 
 	/// Attempts to deduce a color from a string description.
 	/** Possible ways to define a color are:
 	  * 1. hex number of 6 digits, for example "AB34EF", may be preceeded by '#' character
-	  * 2. a word, for example "red", "cyan", "black", case doesn't matter */
-	bool fromString( const std::string & str ) noexcept;
+	  * 2. a word, for example "red", "cyan", "cornflowerblue", case doesn't matter.
+	  *    All the CSS color names are supported, except that "green" is 00FF00 like Color::Green.
+	  * Does not allocate any memory. */
+	bool fromString( StringView str ) noexcept;
 
 	// predefined basic colors for instant use
 	static const Color Black;
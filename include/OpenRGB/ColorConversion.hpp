@@ -0,0 +1,95 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: conversions between RGB and HSV/HSL color spaces
+//======================================================================================================================
+
+#ifndef OPENRGB_COLOR_CONVERSION_INCLUDED
+#define OPENRGB_COLOR_CONVERSION_INCLUDED
+
+
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  The hue covers the whole circle with 16 bits, 0 is red, 21845 is green, 43691 is blue and 65535 is just below red
+//  again, so hue cycling effects can simply keep adding to it and let it overflow. The remaining channels are 8-bit,
+//  255 means full saturation, value or lightness.
+
+/// Color in hue-saturation-value representation
+struct HSV
+{
+	uint16_t h;
+	uint8_t s;
+	uint8_t v;
+
+	HSV() noexcept = default;
+	HSV( uint16_t hue, uint8_t saturation, uint8_t value ) noexcept : h( hue ), s( saturation ), v( value ) {}
+};
+
+/// Color in hue-saturation-lightness representation
+struct HSL
+{
+	uint16_t h;
+	uint8_t s;
+	uint8_t l;
+
+	HSL() noexcept = default;
+	HSL( uint16_t hue, uint8_t saturation, uint8_t lightness ) noexcept : h( hue ), s( saturation ), l( lightness ) {}
+};
+
+/// Converts an angle in degrees to the 16-bit hue used by HSV and HSL.
+constexpr uint16_t hueFromDegrees( uint32_t degrees ) noexcept
+{
+	return uint16_t( ((degrees % 360) * 65536 + 180) / 360 );
+}
+
+
+//======================================================================================================================
+//  Conversions of single colors.
+//
+//  All the conversions use fixed-point arithmetic, the results differ from an exact floating point conversion by at most
+//  1 in each 8-bit channel. The padding of the resulting Color is always 0.
+
+Color hsvToRgb( HSV hsv ) noexcept;
+Color hslToRgb( HSL hsl ) noexcept;
+HSV rgbToHsv( Color color ) noexcept;
+HSL rgbToHsl( Color color ) noexcept;
+
+
+//======================================================================================================================
+//  Conversions of whole arrays, meant for effects that recalculate every LED each frame.
+//
+//  The conversions to RGB are implemented with SSE2, AVX2 or NEON instructions where the CPU supports them, the best
+//  implementation is selected at runtime on the first call. The conversions from RGB use lookup tables instead of
+//  divisions. All implementations give bit-exact same results as the single color variants above.
+//
+//  Only as many colors as the shorter of the arrays has are converted.
+
+void hsvToRgb( Span< const HSV > src, Span< Color > dst ) noexcept;
+void hslToRgb( Span< const HSL > src, Span< Color > dst ) noexcept;
+void rgbToHsv( Span< const Color > src, Span< HSV > dst ) noexcept;
+void rgbToHsl( Span< const Color > src, Span< HSL > dst ) noexcept;
+
+/// Fills the colors with a rainbow, the hue of each next color is shifted by hueStep.
+/** Hue cycling effects just increase startHue each frame. */
+void fillRainbow( Span< Color > dst, uint16_t startHue, uint16_t hueStep, uint8_t saturation = 255, uint8_t value = 255 ) noexcept;
+
+/// Name of the instruction set that was selected for the conversions of arrays, for diagnostic purposes.
+const char * colorConversionsImplementation() noexcept;
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_COLOR_CONVERSION_INCLUDED
@@ -0,0 +1,81 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: per-device correction of colors via lookup tables
+//======================================================================================================================
+
+#ifndef OPENRGB_COLOR_CORRECTION_INCLUDED
+#define OPENRGB_COLOR_CORRECTION_INCLUDED
+
+
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Correction of colors for a particular device, compensating for how differently devices render the same color.
+/** The correction is precalculated into a 256-entry table for each channel, so applying it costs only 3 table lookups
+  * per color no matter how it was defined. Register it via Client::setColorCorrection() and it will be applied
+  * automatically to every color sent to the device or zone. */
+
+class ColorCorrection
+{
+
+ public:
+
+	/// Creates a correction that leaves the colors unchanged.
+	ColorCorrection() noexcept;
+
+	/// Creates a correction from its usual parameters.
+	/** \param gamma exponent applied to each channel, values above 1 make the dark colors darker
+	  * \param gains multiplier of each channel / 255, use it for white balance, for example (255, 200, 180)
+	  *              if the device renders white too bluish
+	  * \param brightnessCap the highest value any channel can reach, all values are scaled down proportionally,
+	  *                      so that the hue doesn't change */
+	ColorCorrection( float gamma, Color gains = Color( 255, 255, 255 ), uint8_t brightnessCap = 255 ) noexcept;
+
+	/// Returns the corrected color.
+	Color apply( Color color ) const noexcept
+	{
+		Color corrected( _red[ color.r ], _green[ color.g ], _blue[ color.b ] );
+		corrected.padding = color.padding;
+		return corrected;
+	}
+
+	/// Writes the corrected colors into dst, it may be the same array as src.
+	/** Only as many colors as the shorter of the arrays has are written. */
+	void apply( Span< const Color > src, Span< Color > dst ) const noexcept;
+
+	/// Tells whether this correction doesn't change any color.
+	bool isIdentity() const noexcept;
+
+	// direct access to the tables for custom corrections
+	uint8_t * redTable() noexcept    { return _red; }
+	uint8_t * greenTable() noexcept  { return _green; }
+	uint8_t * blueTable() noexcept   { return _blue; }
+	const uint8_t * redTable() const noexcept    { return _red; }
+	const uint8_t * greenTable() const noexcept  { return _green; }
+	const uint8_t * blueTable() const noexcept   { return _blue; }
+
+ private:
+
+	uint8_t _red [256];
+	uint8_t _green [256];
+	uint8_t _blue [256];
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_COLOR_CORRECTION_INCLUDED
@@ -0,0 +1,68 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: bulk operations over arrays of colors
+//======================================================================================================================
+
+#ifndef OPENRGB_COLOR_KERNELS_INCLUDED
+#define OPENRGB_COLOR_KERNELS_INCLUDED
+
+
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  Operations over whole arrays of colors, meant for effects that recalculate thousands of LEDs every frame.
+//
+//  Each operation is implemented with SSE2, AVX2 or NEON instructions where the CPU supports them, the best
+//  implementation is selected at runtime on the first call. All implementations give bit-exact same results.
+//  Define NO_SIMD when building the library to leave only the portable implementation.
+//
+//  Operations taking multiple arrays process only as many colors as the shortest of them has.
+//  The destination may be the same array as any of the sources.
+//  All 8-bit multiplications are calculated as round( x * y / 255 ), so that 255 means "keep the original value".
+
+/// Sets all the colors to the same value.
+void fillColors( Span< Color > dst, Color color ) noexcept;
+
+/// Multiplies all channels of all colors by brightness / 255.
+void scaleColors( Span< Color > dst, uint8_t brightness ) noexcept;
+
+/// Multiplies each channel of all colors by the corresponding channel of factors / 255.
+/** Useful for tinting or white-balancing. */
+void scaleColors( Span< Color > dst, Color factors ) noexcept;
+
+/// Linear interpolation between two arrays, dst = from + (to - from) * weight / 255.
+void blendColors( Span< Color > dst, Span< const Color > from, Span< const Color > to, uint8_t weight ) noexcept;
+
+/// Additive compositing with saturation, dst = min( dst + src, 255 ).
+void addColors( Span< Color > dst, Span< const Color > src ) noexcept;
+
+/// Lighten compositing, dst = max( dst, src ) for each channel separately.
+void maxColors( Span< Color > dst, Span< const Color > src ) noexcept;
+
+/// Multiply compositing, dst = dst * src / 255 for each channel separately.
+void multiplyColors( Span< Color > dst, Span< const Color > src ) noexcept;
+
+/// Fills the colors with a linear gradient, the first color will be exactly from and the last exactly to.
+/** A single color is set to to. */
+void fillGradient( Span< Color > dst, Color from, Color to ) noexcept;
+
+/// Name of the instruction set that was selected for these operations, for diagnostic purposes.
+const char * colorKernelsImplementation() noexcept;
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_COLOR_KERNELS_INCLUDED
@@ -0,0 +1,159 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: thread-safe client whose requests are executed by a dedicated I/O thread
+//======================================================================================================================
+
+#ifndef OPENRGB_CONCURRENT_CLIENT_INCLUDED
+#define OPENRGB_CONCURRENT_CLIENT_INCLUDED
+
+
+#include "Client.hpp"
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+#include <string>
+#include <memory>   // unique_ptr<Impl>
+#include <future>
+#include <atomic>
+#include <utility>  // declval
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Client that can be used from many threads at once.
+/** The requests of all threads are put into a lock-free queue and executed in order by a single I/O thread that owns
+  * the connection. Submitting a request costs one atomic exchange no matter how many threads submit at the same time,
+  * the caller gets a future that becomes ready when the request is done.
+  *
+  * Requests that don't wait for a reply (colors, modes, zone sizes) and arrive together are written to the socket
+  * in one write. Requests that wait for a reply are executed one by one and their replies are given to their futures
+  * in the order of submitting.
+  *
+  * The I/O thread is started by the constructor and stopped by the destructor, after it finishes all the submitted
+  * requests. The devices, zones, LEDs and modes passed to the methods must stay valid until the returned future
+  * becomes ready, the colors are copied. */
+
+class ConcurrentClient
+{
+
+ public:
+
+	/// Creates a client of specified or default name and starts the I/O thread. Does not connect anywhere yet.
+	explicit ConcurrentClient( const std::string & clientName = "orgb::ConcurrentClient" );
+
+	/// Takes over an existing client, which may be already connected, and starts the I/O thread.
+	explicit ConcurrentClient( Client && client );
+
+	/// Finishes all the submitted requests and stops the I/O thread.
+	/** No other thread may submit requests during the destruction. */
+	~ConcurrentClient() noexcept;
+
+	ConcurrentClient( const ConcurrentClient & other ) = delete;
+	ConcurrentClient & operator=( const ConcurrentClient & other ) = delete;
+
+	//-- requests, see the methods of the Client with the same name --------------------------------------------------
+
+	std::future< ConnectStatus > connect( const std::string & host, uint16_t port = defaultPort );
+	std::future< bool > disconnect();
+
+	std::future< DeviceListResult > requestDeviceList();
+	std::future< DeviceInfoResult > requestDeviceInfo( uint32_t deviceIdx );
+	std::future< UpdateStatus > checkForDeviceUpdates();
+
+	std::future< RequestStatus > switchToCustomMode( const Device & device );
+	std::future< RequestStatus > changeMode( const Device & device, const Mode & mode );
+	std::future< RequestStatus > setDeviceColor( const Device & device, Color color );
+	std::future< RequestStatus > setZoneColor( const Zone & zone, Color color );
+	std::future< RequestStatus > setDeviceColors( const Device & device, Span< const Color > colors );
+	std::future< RequestStatus > setZoneColors( const Zone & zone, Span< const Color > colors );
+	std::future< RequestStatus > setZoneSize( const Zone & zone, uint32_t newSize );
+	std::future< RequestStatus > setLEDColor( const LED & led, Color color );
+
+	/// Calls func( Client & ) on the I/O thread, use it for the operations that don't have their own method here.
+	/** An exception thrown by func is passed to the future. */
+	template< typename Func >
+	auto execute( Func func ) -> std::future< decltype( func( std::declval< Client & >() ) ) >
+	{
+		using Result = decltype( func( std::declval< Client & >() ) );
+		auto job = std::unique_ptr< FuncJob< Result, Func > >( new FuncJob< Result, Func >( std::move( func ) ) );
+		auto future = job->promise.get_future();
+		submit( std::move( job ) );
+		return future;
+	}
+
+ private:
+
+	/// Request waiting in the queue, the queue is intrusive so that submitting allocates only the job itself.
+	struct Job
+	{
+		std::atomic< Job * > next { nullptr };
+
+		virtual ~Job() {}
+
+		/// Jobs that only send a message can be written together with their neighbours.
+		virtual bool isSendOnly() const noexcept  { return false; }
+
+		/// Executes the request, a send-only job only appends its message to the batch.
+		virtual void run( Client & client ) noexcept = 0;
+
+		/// Called for send-only jobs after the batch has been written.
+		virtual void finish( RequestStatus /*batchStatus*/ ) noexcept {}
+	};
+
+	template< typename Result, typename Func >
+	struct FuncJob : public Job
+	{
+		std::promise< Result > promise;
+		Func func;
+
+		FuncJob( Func && func ) : func( std::move( func ) ) {}
+
+		virtual void run( Client & client ) noexcept override
+		{
+			try {
+				setResult( promise, func, client );
+			} catch (...) {
+				promise.set_exception( std::current_exception() );
+			}
+		}
+	};
+
+	template< typename Result, typename Func >
+	static void setResult( std::promise< Result > & promise, Func & func, Client & client )
+	{
+		promise.set_value( func( client ) );
+	}
+	template< typename Func >
+	static void setResult( std::promise< void > & promise, Func & func, Client & client )
+	{
+		func( client );
+		promise.set_value();
+	}
+
+	struct SendJob;
+
+	void submit( std::unique_ptr< Job > job );
+	std::future< RequestStatus > submitSend( std::unique_ptr< SendJob > job );
+
+	void ioLoop() noexcept;
+
+	struct Impl;
+	// a pointer so that the queue, the thread and the client stay internal to the library
+	std::unique_ptr< Impl > _impl;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_CONCURRENT_CLIENT_INCLUDED
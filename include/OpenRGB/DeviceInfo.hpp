@@ -12,10 +12,12 @@
 #include "Exceptions.hpp"
 
 #include "Color.hpp"
+#include "Span.hpp"
 
 #include <string>
 #include <vector>
 #include <memory>  // unique_ptr<Device>
+#include <algorithm>  // min
 
 
 namespace orgb {
@@ -91,6 +93,9 @@ enum class ZoneType : uint32_t
 const char * enumString( ZoneType ) noexcept;
 
 
+struct ModeParams;
+
+
 //======================================================================================================================
 /// Represents a particular LED on an RGB device.
 
@@ -136,10 +141,11 @@ class Zone
 	const uint32_t     leds_min;       ///< minimum size of the zone
 	const uint32_t     leds_max;       ///< maximum size of the zone
 	const uint32_t     leds_count;     ///< current size of the zone
+	const uint32_t     start_idx;      ///< index of the first LED of the zone in Device::leds and Device::colors, not sent by the server but calculated when the device is received
 	// optional
 	const uint32_t     matrix_height;  ///< if the zone type is matrix, this is its height
 	const uint32_t     matrix_width;   ///< if the zone type is matrix, this is its width
-	const std::vector< uint32_t >  matrix_values;  ///< TODO: what is this?
+	const std::vector< uint32_t >  matrix_values;  ///< LED index within the zone for each cell of the matrix, row by row, 0xFFFFFFFF where there is no LED
 
  private:  // for internal use only
 
@@ -199,11 +205,27 @@ class Mode
 	friend struct SaveMode;
 	Mode();
 	size_t calcSize( uint32_t protocolVersion ) const noexcept;
+	size_t calcSize( uint32_t protocolVersion, const ModeParams & params ) const noexcept;
 	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion ) const;
+	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion, const ModeParams & params ) const;
 	bool deserialize( own::BinaryInputStream & stream, uint32_t protocolVersion, uint32_t idx, uint32_t parentIdx ) noexcept;
 
 };
 
+/// The parameters of a Mode that can be changed, for sending them without copying the whole Mode.
+/** Initialize it from the mode and change only what you need. The colors are not copied, they must stay valid until
+  * the params are sent. */
+struct ModeParams
+{
+	uint32_t             speed;       ///< see Mode::speed
+	uint32_t             brightness;  ///< see Mode::brightness
+	Direction            direction;   ///< see Mode::direction
+	Span< const Color >  colors;      ///< see Mode::colors
+
+	explicit ModeParams( const Mode & mode ) noexcept
+		: speed( mode.speed ), brightness( mode.brightness ), direction( mode.direction ), colors( mode.colors ) {}
+};
+
 
 //======================================================================================================================
 /// Represents an RGB-capable device. Device can have modes, zones and individual LEDs.
@@ -234,6 +256,20 @@ class Device
 
  public:
 
+	/// LEDs of a zone of this device, the range of the zone is calculated when the device is received.
+	Span< const LED > zoneLEDs( const Zone & zone ) const noexcept
+	{
+		return Span< const LED >( leds.data() + zone.start_idx, std::min( size_t( zone.leds_count ), leds.size() - zone.start_idx ) );
+	}
+
+	/// Colors of the LEDs of a zone of this device, the range of the zone is calculated when the device is received.
+	Span< const Color > zoneColors( const Zone & zone ) const noexcept
+	{
+		// the server should send one color for each LED, but let's not trust it
+		size_t first = std::min( size_t( zone.start_idx ), colors.size() );
+		return Span< const Color >( colors.data() + first, std::min( size_t( zone.leds_count ), colors.size() - first ) );
+	}
+
 	/// Finds the first mode with a specific name.
 	/** \returns nullptr when mode with this name is not found. */
 	const Mode * findMode( const std::string & name ) const noexcept
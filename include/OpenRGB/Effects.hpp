@@ -0,0 +1,355 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: layered effects rendered into a frame buffer of all LEDs
+//======================================================================================================================
+
+#ifndef OPENRGB_EFFECTS_INCLUDED
+#define OPENRGB_EFFECTS_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <memory>  // unique_ptr<Layer>
+#include <chrono>  // milliseconds
+
+
+namespace orgb {
+
+
+class Client;
+class ThreadPool;
+enum class RequestStatus;
+
+
+//======================================================================================================================
+/// Colors of all LEDs of all devices in one contiguous array.
+/** The LEDs of each device are stored in the same order as in Device::leds and the devices follow each other in the
+  * order of the DeviceList, so the colors of any device can be sent directly with Client::setDeviceColors()
+  * and the colors of any zone with Client::setZoneColors(). */
+
+class FrameBuffer
+{
+
+ public:
+
+	/// Range of the frame buffer occupied by one device.
+	struct DeviceRange
+	{
+		uint32_t deviceIdx;
+		uint32_t first;      ///< index of the first LED of the device in the frame buffer
+		uint32_t count;      ///< number of LEDs of the device
+		uint32_t firstZone;  ///< index of the device's first zone in zones()
+		uint32_t zoneCount;  ///< number of zones of the device
+	};
+
+	/// Range of the frame buffer occupied by one zone.
+	struct ZoneRange
+	{
+		uint32_t deviceIdx;
+		uint32_t zoneIdx;
+		uint32_t first;  ///< index of the first LED of the zone in the frame buffer
+		uint32_t count;  ///< number of LEDs of the zone
+	};
+
+	FrameBuffer() noexcept {}
+	explicit FrameBuffer( const DeviceList & devices )  { reset( devices ); }
+
+	/// Resizes the buffer for a new device list and sets all the colors to black.
+	void reset( const DeviceList & devices );
+
+	/// Rebuilds the buffer for a refreshed device list, without losing the colors that are still valid.
+	/** The devices whose number of LEDs didn't change keep their colors, the others are filled with the colors
+	  * reported by the server in Device::colors. Call it after Client::requestDeviceList() or after replacing
+	  * a device in the list with the result of Client::requestDeviceInfo(). */
+	void sync( const DeviceList & devices );
+
+	size_t size() const noexcept  { return _colors.size(); }
+
+	Span< Color > colors() noexcept              { return _colors; }
+	Span< const Color > colors() const noexcept  { return _colors; }
+
+	/// Colors of a single device, by its index in the DeviceList.
+	Span< Color > deviceColors( uint32_t deviceIdx ) noexcept
+	{
+		return Span< Color >( _colors.data() + _ranges[ deviceIdx ].first, _ranges[ deviceIdx ].count );
+	}
+	Span< const Color > deviceColors( uint32_t deviceIdx ) const noexcept
+	{
+		return Span< const Color >( _colors.data() + _ranges[ deviceIdx ].first, _ranges[ deviceIdx ].count );
+	}
+
+	/// Colors of a single zone, by the index of its device in the DeviceList and its index in Device::zones.
+	Span< Color > zoneColors( uint32_t deviceIdx, uint32_t zoneIdx ) noexcept
+	{
+		const ZoneRange & zone = _zones[ _ranges[ deviceIdx ].firstZone + zoneIdx ];
+		return Span< Color >( _colors.data() + zone.first, zone.count );
+	}
+	Span< const Color > zoneColors( uint32_t deviceIdx, uint32_t zoneIdx ) const noexcept
+	{
+		const ZoneRange & zone = _zones[ _ranges[ deviceIdx ].firstZone + zoneIdx ];
+		return Span< const Color >( _colors.data() + zone.first, zone.count );
+	}
+
+	/// Where each device is located in the buffer, in the order of the DeviceList.
+	Span< const DeviceRange > devices() const noexcept  { return _ranges; }
+
+	/// Where each zone is located in the buffer, the zones of each device follow each other.
+	Span< const ZoneRange > zones() const noexcept  { return _zones; }
+
+	/// Position of each LED within its device, 0 for the first LED and 65535 for the last one.
+	/** Effects that move along the LEDs use this, so that they look the same on devices with different LED counts. */
+	Span< const uint16_t > positions() const noexcept  { return _positions; }
+
+ private:
+
+	void buildTables( const DeviceList & devices );
+
+	std::vector< Color > _colors;
+	std::vector< uint16_t > _positions;
+	std::vector< DeviceRange > _ranges;
+	std::vector< ZoneRange > _zones;
+
+};
+
+
+//======================================================================================================================
+//  layers
+
+/// How the colors of a layer are combined with the colors of the layers below it.
+enum class BlendMode
+{
+	Normal,    ///< the layer covers the layers below
+	Add,       ///< the colors are added together, useful for lights
+	Lighten,   ///< the brighter of the two values is used for each channel
+	Multiply,  ///< the colors are multiplied, useful for masks and shading
+};
+const char * enumString( BlendMode mode ) noexcept;
+
+/// Base class of all effect layers.
+/** Derive from this to create your own effects. render(...) is called once per frame and must fully overwrite dst,
+  * it should not allocate any memory, prepare everything in resize(...) instead. */
+class Layer
+{
+
+ public:
+
+	BlendMode blendMode = BlendMode::Normal;
+	uint8_t opacity = 255;  ///< 0 means the layer is invisible, 255 means fully visible
+	bool enabled = true;
+
+	virtual ~Layer() {}
+
+	/// Called when the layer is added to an engine and whenever the frame buffer changes its size.
+	virtual void resize( const FrameBuffer & /*frame*/ ) {}
+
+	/// Renders the layer into dst, which has the same size and layout as the frame buffer.
+	/** \param time time since the start of the engine */
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept = 0;
+
+	/// Tells whether renderRange(...) can be called for different ranges from different threads at the same time.
+	/** Layers that keep a state between frames should leave this false, they will be rendered by render(...)
+	  * on the thread calling EffectEngine::render(). */
+	virtual bool isParallel() const noexcept  { return false; }
+
+	/// Renders only the LEDs [first, first + count) into the same positions of dst, see isParallel().
+	virtual void renderRange( const FrameBuffer & /*frame*/, Span< Color > /*dst*/, size_t /*first*/, size_t /*count*/,
+	                          std::chrono::milliseconds /*time*/ ) noexcept {}
+
+};
+
+/// The same color on all LEDs.
+class SolidLayer : public Layer
+{
+
+ public:
+
+	Color color;
+
+	SolidLayer( Color color ) noexcept : color( color ) {}
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override;
+	virtual bool isParallel() const noexcept override  { return true; }
+	virtual void renderRange( const FrameBuffer & frame, Span< Color > dst, size_t first, size_t count,
+	                          std::chrono::milliseconds time ) noexcept override;
+
+};
+
+/// Linear gradient from the first to the last LED of each device.
+class GradientLayer : public Layer
+{
+
+ public:
+
+	Color from;
+	Color to;
+
+	GradientLayer( Color from, Color to ) noexcept : from( from ), to( to ) {}
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override;
+
+};
+
+/// Sine wave of brightness moving along the LEDs of each device.
+class WaveLayer : public Layer
+{
+
+ public:
+
+	Color color;
+	float wavelength;  ///< length of one wave relative to the length of the device
+	float speed;       ///< waves per second passing through each LED, negative values move the wave backwards
+
+	WaveLayer( Color color, float wavelength = 0.5f, float speed = 1.0f ) noexcept
+		: color( color ), wavelength( wavelength ), speed( speed ) {}
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override;
+	virtual bool isParallel() const noexcept override  { return true; }
+	virtual void renderRange( const FrameBuffer & frame, Span< Color > dst, size_t first, size_t count,
+	                          std::chrono::milliseconds time ) noexcept override;
+
+};
+
+/// All LEDs slowly fading in and out.
+class BreathingLayer : public Layer
+{
+
+ public:
+
+	Color color;
+	float period;  ///< seconds per one breath
+
+	BreathingLayer( Color color, float period = 4.0f ) noexcept : color( color ), period( period ) {}
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override;
+	virtual bool isParallel() const noexcept override  { return true; }
+	virtual void renderRange( const FrameBuffer & frame, Span< Color > dst, size_t first, size_t count,
+	                          std::chrono::milliseconds time ) noexcept override;
+
+};
+
+/// Randomly flashing LEDs that fade out.
+class SparkleLayer : public Layer
+{
+
+ public:
+
+	Color color;
+	float sparksPerSecond;  ///< average number of new sparks per LED per second
+	float fadeTime;         ///< seconds until a spark fades out completely
+
+	SparkleLayer( Color color, float sparksPerSecond = 0.5f, float fadeTime = 0.5f, uint32_t seed = 1 ) noexcept
+		: color( color ), sparksPerSecond( sparksPerSecond ), fadeTime( fadeTime ), _random( seed ? seed : 1 ) {}
+
+	virtual void resize( const FrameBuffer & frame ) override;
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override;
+
+ private:
+
+	uint32_t nextRandom() noexcept;
+
+	std::vector< uint8_t > _levels;  ///< current brightness of each LED
+	std::chrono::milliseconds _lastTime { -1 };
+	float _pendingSparks = 0.0f;   ///< fractions of sparks carried over to the next frame
+	float _pendingFade = 0.0f;     ///< fractions of brightness carried over to the next frame
+	uint32_t _random;
+
+};
+
+
+//======================================================================================================================
+/// Composes layers of effects into a frame buffer and sends it to the devices.
+/** Typical usage is to call render() and push() once per frame. Apart from the first frame after adding layers
+  * or resetting the device list, neither of them allocates memory. */
+
+class EffectEngine
+{
+
+ public:
+
+	EffectEngine() noexcept {}
+
+	/// The device list must stay valid until reset(...) is called with another one or the engine is destroyed.
+	explicit EffectEngine( const DeviceList & devices )  { reset( devices ); }
+
+	/// Starts rendering for a new device list, all the colors of the frame are set to black.
+	void reset( const DeviceList & devices );
+
+	/// Continues rendering for a refreshed device list, call it after Client::requestDeviceList() or after replacing
+	/// a device in the list with the result of Client::requestDeviceInfo().
+	/** The frame is synchronized by FrameBuffer::sync(...) and the layers are resized for the new layout.
+	  * The device list must stay valid the same way as with reset(...). */
+	void sync( const DeviceList & devices );
+
+	/// Adds a layer on top of the existing ones and returns a reference to it for further configuration.
+	template< typename LayerType >
+	LayerType & addLayer( std::unique_ptr< LayerType > layer )
+	{
+		LayerType & ref = *layer;
+		ref.resize( _frame );
+		_layers.push_back( std::move( layer ) );
+		return ref;
+	}
+
+	/// Removes all layers.
+	void clearLayers() noexcept  { _layers.clear(); }
+
+	size_t layerCount() const noexcept  { return _layers.size(); }
+	Layer & layer( size_t idx ) noexcept  { return *_layers[ idx ]; }
+
+	/// Renders all the layers from the bottom to the top into the frame buffer.
+	/** \param time time since the start of the animation */
+	void render( std::chrono::milliseconds time ) noexcept;
+
+	/// Renders the frame split into ranges of LEDs processed by the threads of the pool.
+	/** Layers that are not parallel are rendered first on the calling thread, then each range goes through all
+	  * the layers and blending on one of the threads. The ranges never overlap and the result is the same as of
+	  * the single-threaded render(...), no matter which thread processed which range. */
+	void render( std::chrono::milliseconds time, ThreadPool & pool );
+
+	/// Sends the frame buffer to all the devices.
+	/** Returns the first failure, but still tries to update the remaining devices. */
+	RequestStatus push( Client & client ) noexcept;
+
+	/// The rendered frame, its layout can only be changed by reset(...) or sync(...).
+	const FrameBuffer & frame() const noexcept  { return _frame; }
+
+	/// Colors of the rendered frame, for adjusting them between render(...) and push(...).
+	Span< Color > frameColors() noexcept  { return _frame.colors(); }
+
+ private:
+
+	struct Chunk
+	{
+		uint32_t first;
+		uint32_t count;
+	};
+
+	/// Prepares the layer buffer, the chunks and the layers for the current layout of the frame.
+	void updateLayout();
+
+	void renderChunk( Chunk chunk, std::chrono::milliseconds time ) noexcept;
+
+	const DeviceList * _devices = nullptr;
+	FrameBuffer _frame;
+	std::vector< Color > _layerBuffer;
+	std::vector< Color > _serialLayersBuffer;  ///< pre-rendered layers that are not parallel, one after another
+	std::vector< Chunk > _chunks;  ///< ranges of LEDs rendered as separate tasks, never crossing devices
+	std::vector< std::unique_ptr< Layer > > _layers;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_EFFECTS_INCLUDED
@@ -0,0 +1,175 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: precise pacing of animation frames and statistics of their timing
+//======================================================================================================================
+
+#ifndef OPENRGB_FRAME_SCHEDULER_INCLUDED
+#define OPENRGB_FRAME_SCHEDULER_INCLUDED
+
+
+#include <cstdint>
+#include <chrono>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Distribution of durations in buckets of exponentially growing width.
+/** Bucket 0 counts durations below 1 microsecond, bucket i counts durations in [2^(i-1), 2^i) microseconds
+  * and the last bucket counts everything longer. Recording is a few instructions and never allocates,
+  * so it can be done every frame. */
+
+class TimeHistogram
+{
+
+ public:
+
+	static constexpr uint32_t bucketCount = 26;  ///< the last regular bucket ends at 2^24 us, about 16 seconds
+
+	TimeHistogram() noexcept  { clear(); }
+
+	void clear() noexcept;
+
+	void record( std::chrono::nanoseconds duration ) noexcept;
+
+	uint64_t count() const noexcept  { return _count; }
+	std::chrono::nanoseconds min() const noexcept  { return std::chrono::nanoseconds( _count ? _min : 0 ); }
+	std::chrono::nanoseconds max() const noexcept  { return std::chrono::nanoseconds( _max ); }
+	std::chrono::nanoseconds mean() const noexcept  { return std::chrono::nanoseconds( _count ? _sum / _count : 0 ); }
+
+	/// Returns an upper estimate of the duration that the given fraction of the records didn't exceed.
+	/** \param fraction for example 0.99 for the 99th percentile
+	  * The result is the upper bound of the bucket where the percentile falls, limited by the maximum. */
+	std::chrono::nanoseconds percentile( double fraction ) const noexcept;
+
+	/// Number of records in a bucket.
+	uint64_t bucket( uint32_t idx ) const noexcept  { return _buckets[ idx ]; }
+
+	/// Upper bound of a bucket in microseconds.
+	static uint64_t bucketLimit( uint32_t idx ) noexcept  { return uint64_t( 1 ) << idx; }
+
+ private:
+
+	uint64_t _buckets [bucketCount];
+	uint64_t _count;
+	int64_t _min;
+	int64_t _max;
+	int64_t _sum;
+
+};
+
+/// Timing statistics of the frames driven by a FrameScheduler.
+struct FrameStats
+{
+	uint64_t frames = 0;         ///< frames that were started
+	uint64_t skippedFrames = 0;  ///< frames that were skipped because the previous ones took too long
+	TimeHistogram jitter;        ///< how late each frame started after its deadline
+	TimeHistogram renderTime;    ///< from the start of a frame until FrameScheduler::markRendered()
+	TimeHistogram sendTime;      ///< from FrameScheduler::markRendered() until FrameScheduler::markSent()
+
+	void clear() noexcept
+	{
+		frames = skippedFrames = 0;
+		jitter.clear();
+		renderTime.clear();
+		sendTime.clear();
+	}
+};
+
+
+//======================================================================================================================
+/// Paces animation frames at a fixed rate.
+/** The deadlines of the frames are absolute points in time derived from the start, so the small delays
+  * of waking up don't accumulate into a drift like with sleeping for the period after each frame.
+  * The scheduler sleeps until shortly before the deadline and then spins for the rest, because the sleep of most
+  * systems is only precise to a millisecond or worse.
+  *
+  * When a frame takes so long that the next deadlines have already passed, those frames are skipped and the
+  * animation continues with the latest deadline, instead of sending several frames right after each other
+  * to catch up, which the OpenRGB server wouldn't handle anyway. */
+
+class FrameScheduler
+{
+
+ public:
+
+	using Clock = std::chrono::steady_clock;
+
+	/// Information about the frame that should be rendered now.
+	struct Frame
+	{
+		uint64_t idx;                   ///< index of the frame since the start, skipped frames are counted too
+		std::chrono::milliseconds time; ///< time of the frame's deadline since the start, use it to drive animations
+		Clock::time_point deadline;     ///< when the frame was supposed to start
+	};
+
+	explicit FrameScheduler( double framesPerSecond = 30.0 ) noexcept;
+
+	/// Changes the frame rate, it takes effect from the next frame.
+	void setFrameRate( double framesPerSecond ) noexcept;
+	Clock::duration period() const noexcept  { return _period; }
+
+	/// How long before the deadline the sleeping switches to spinning, 0 turns the spinning off.
+	/** The default is 1 millisecond. Bigger values make the deadlines more precise at the cost of CPU time. */
+	void setSpinThreshold( Clock::duration threshold ) noexcept  { _spinThreshold = threshold; }
+
+	/// Makes the next waitForNextFrame() return immediately with the frame 0.
+	void restart() noexcept  { _started = false; }
+
+	/// Waits until the deadline of the next frame and returns its information.
+	/** The first call after the construction or restart() returns immediately and starts the clock. */
+	Frame waitForNextFrame() noexcept;
+
+	/// Records that the current frame has been rendered, call it between rendering and sending.
+	void markRendered() noexcept;
+
+	/// Records that the current frame has been sent.
+	void markSent() noexcept;
+
+	/// Repeatedly waits for the next frame and calls render( frame ) and send( frame ) until one of them returns false.
+	template< typename RenderFunc, typename SendFunc >
+	void run( RenderFunc render, SendFunc send )
+	{
+		while (true)
+		{
+			Frame frame = waitForNextFrame();
+			if (!render( frame ))
+				break;
+			markRendered();
+			if (!send( frame ))
+				break;
+			markSent();
+		}
+	}
+
+	const FrameStats & stats() const noexcept  { return _stats; }
+	void clearStats() noexcept  { _stats.clear(); }
+
+ private:
+
+	Clock::duration _period;
+	Clock::duration _spinThreshold;
+
+	bool _started;
+	Clock::time_point _start;
+	Clock::time_point _nextDeadline;
+	uint64_t _nextFrameIdx;
+
+	Clock::time_point _frameStart;
+	Clock::time_point _renderEnd;
+
+	FrameStats _stats;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_FRAME_SCHEDULER_INCLUDED
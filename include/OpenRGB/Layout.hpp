@@ -0,0 +1,210 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: positions of all LEDs in a shared 3D space and per-LED evaluation of effects
+//======================================================================================================================
+
+#ifndef OPENRGB_LAYOUT_INCLUDED
+#define OPENRGB_LAYOUT_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+#include "Effects.hpp"
+#include "ColorKernels.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>  // milliseconds
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// Point in the space of the layout.
+struct Point3
+{
+	float x;
+	float y;
+	float z;
+
+	constexpr Point3() noexcept : x( 0.0f ), y( 0.0f ), z( 0.0f ) {}
+	constexpr Point3( float x, float y, float z ) noexcept : x( x ), y( y ), z( z ) {}
+};
+
+/// Result of loading a layout file.
+enum class LayoutStatus
+{
+	Success,          ///< The operation was successful.
+	CannotOpenFile,   ///< The layout file doesn't exist or cannot be read.
+	InvalidSyntax,    ///< A line of the layout file is not a valid command.
+	UnknownDevice,    ///< The layout file refers to a device that is not in the device list.
+	LedOutOfRange,    ///< The layout file refers to a LED index that the device doesn't have.
+	UnexpectedError,  ///< Internal error of this library. This should not happen unless there is a mistake in the code, please create a github issue.
+};
+const char * enumString( LayoutStatus status ) noexcept;
+
+
+//======================================================================================================================
+/// Positions of all LEDs of all devices in one coordinate space.
+/** The LEDs are in the same order as in FrameBuffer, so a result of evaluate(...) can be used directly as a frame.
+  *
+  * Each device has its own coordinates where one unit is the distance between neighbouring LEDs. They are derived
+  * automatically from the zones: LEDs of a linear zone go along the X axis, a matrix zone spans X and Y like it is
+  * drawn in Zone::matrix_values, and the zones of a device are stacked along the Y axis. The device is then placed
+  * into the shared space by its origin and scale. Both can be changed in code or by a layout file.
+  *
+  * The coordinates are stored as separate arrays of X, Y and Z, so that loops over them can be vectorized. */
+
+class Layout
+{
+
+ public:
+
+	Layout() noexcept {}
+	explicit Layout( const DeviceList & devices )  { reset( devices ); }
+
+	/// Derives the positions for a new device list, call it after every new Client::requestDeviceList().
+	/** The devices are initially placed next to each other along the Y axis. */
+	void reset( const DeviceList & devices );
+
+	/// Number of all LEDs.
+	size_t size() const noexcept  { return _x.size(); }
+
+	// final coordinates of all LEDs in the shared space
+	Span< const float > x() const noexcept  { return _x; }
+	Span< const float > y() const noexcept  { return _y; }
+	Span< const float > z() const noexcept  { return _z; }
+
+	Point3 position( size_t ledIdx ) const noexcept  { return Point3( _x[ ledIdx ], _y[ ledIdx ], _z[ ledIdx ] ); }
+
+	/// Places a device into the shared space.
+	/** \param origin where the point (0,0,0) of the device's own coordinates will be
+	  * \param scale size of one unit of the device's own coordinates in the shared space */
+	void placeDevice( uint32_t deviceIdx, Point3 origin, float scale = 1.0f ) noexcept;
+
+	/// Overrides the automatically derived position of a LED within its device's own coordinates.
+	void setLedPosition( uint32_t deviceIdx, uint32_t ledIdx, Point3 position ) noexcept;
+
+	/// Applies a layout file to the current device list.
+	/** The file is a text with one command per line, empty lines and lines starting with # are ignored:
+	  *   device "<device name>" <x> <y> <z> [<scale>]          - places the device, see placeDevice(...)
+	  *   led "<device name>" <led index> <x> <y> <z>          - moves a LED, see setLedPosition(...)
+	  * When the file is invalid, the commands before the invalid line stay applied and errorLine() tells the line. */
+	LayoutStatus load( const std::string & filePath ) noexcept;
+
+	/// Same as load(...), but the content of the layout file is given directly.
+	LayoutStatus parse( StringView text ) noexcept;
+
+	/// Number of the line where the last load(...) or parse(...) failed, starting from 1.
+	uint32_t errorLine() const noexcept  { return _errorLine; }
+
+	/// Calculates the color of every LED by calling kernel( x, y, z, time ) -> Color.
+	/** The kernel is inlined into a single loop over the coordinate arrays, so simple arithmetic kernels get
+	  * vectorized by the compiler. dst must have size() elements. */
+	template< typename Kernel >
+	void evaluate( Span< Color > dst, float time, Kernel kernel ) const
+	{
+		evaluate( dst, 0, size(), time, kernel );
+	}
+
+	/// Evaluates only a range of LEDs, use it to split the work between threads.
+	/** dst is the whole frame, only the elements [first, first + count) are written. */
+	template< typename Kernel >
+	void evaluate( Span< Color > dst, size_t first, size_t count, float time, Kernel kernel ) const
+	{
+		const float * xs = _x.data() + first;
+		const float * ys = _y.data() + first;
+		const float * zs = _z.data() + first;
+		Color * out = dst.data() + first;
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = kernel( xs[i], ys[i], zs[i], time );
+		}
+	}
+
+ private:
+
+	struct DevicePlacement
+	{
+		uint32_t firstLed;
+		uint32_t ledCount;
+		Point3 origin;
+		float scale;
+	};
+
+	void updateDevice( uint32_t deviceIdx ) noexcept;
+
+	// LED positions in the devices' own coordinates
+	std::vector< float > _localX;
+	std::vector< float > _localY;
+	std::vector< float > _localZ;
+
+	// LED positions in the shared space
+	std::vector< float > _x;
+	std::vector< float > _y;
+	std::vector< float > _z;
+
+	std::vector< DevicePlacement > _devices;
+	std::vector< std::string > _deviceNames;  // for resolving the names in layout files
+
+	uint32_t _errorLine = 0;
+
+};
+
+
+//======================================================================================================================
+/// Effect layer defined by a function of the LED position and time, see Layout::evaluate().
+/** Create it with makeShaderLayer(...), the layout must stay valid as long as the layer is used. */
+
+template< typename Kernel >
+class ShaderLayer : public Layer
+{
+
+ public:
+
+	ShaderLayer( const Layout & layout, Kernel kernel ) : _layout( layout ), _kernel( kernel ) {}
+
+	virtual void render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept override
+	{
+		renderRange( frame, dst, 0, dst.size(), time );
+	}
+
+	virtual bool isParallel() const noexcept override  { return true; }
+
+	virtual void renderRange( const FrameBuffer &, Span< Color > dst, size_t first, size_t count,
+	                          std::chrono::milliseconds time ) noexcept override
+	{
+		if (dst.size() == _layout.size())
+			_layout.evaluate( dst, first, count, float( time.count() ) / 1000.0f, _kernel );
+		else  // the layout was made for different devices, don't leave the previous frame there
+			fillColors( dst.subspan( first, count ), Color::Black );
+	}
+
+ private:
+
+	const Layout & _layout;
+	Kernel _kernel;
+
+};
+
+/// Creates a ShaderLayer for EffectEngine::addLayer(...), kernel( x, y, z, seconds ) -> Color.
+template< typename Kernel >
+std::unique_ptr< ShaderLayer< Kernel > > makeShaderLayer( const Layout & layout, Kernel kernel )
+{
+	return std::unique_ptr< ShaderLayer< Kernel > >( new ShaderLayer< Kernel >( layout, kernel ) );
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_LAYOUT_INCLUDED
@@ -0,0 +1,172 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: OpenRGB protocol server for exposing devices to OpenRGB clients
+//======================================================================================================================
+
+#ifndef OPENRGB_SERVER_INCLUDED
+#define OPENRGB_SERVER_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+#include "SystemErrorType.hpp"  // HACK: read the comment at the top of that header file
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>  // unique_ptr<Impl>
+#include <chrono>  // timeout
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// All the possible ways how an operation of the server can end up
+enum class ServerStatus
+{
+	Success,           ///< The operation was successful.
+	NotSupported,      ///< The server is not implemented on this operating system yet.
+	AlreadyRunning,    ///< The server is already listening. Call stop() first.
+	NotRunning,        ///< The server is not listening. Call start() first.
+	InvalidAddress,    ///< The address to listen on is not a valid IPv4 address.
+	CannotListen,      ///< The socket could not be bound to the address or port. Call getLastSystemError() for more info.
+	OtherSystemError,  ///< Other system error. Call getLastSystemError() for more info.
+	UnexpectedError,   ///< Internal error of this library. This should not happen unless there is a mistake in the code, please create a github issue.
+};
+const char * enumString( ServerStatus status ) noexcept;
+
+/// Information about a client connected to the server
+struct ServerClientInfo
+{
+	uint64_t id;               ///< unique for every connection during the lifetime of the server
+	std::string address;       ///< IP address of the client
+	std::string name;          ///< name announced by the client, empty until it does so
+	uint32_t protocolVersion;  ///< version negotiated with the client, 0 until it asks for it
+};
+
+
+//======================================================================================================================
+/// Receives the requests of the clients of a Server. Implement this to expose your devices.
+/** All the methods are called from the thread that runs the server. The device indexes are validated against
+  * deviceCount() before the requests reach the handler, everything else must be validated by the handler. */
+
+class ServerHandler
+{
+
+ public:
+
+	virtual ~ServerHandler() = default;
+
+	//-- device list ---------------------------------------------------------------------------------------------------
+
+	/// Number of devices exposed by the server.
+	virtual uint32_t deviceCount() = 0;
+
+	/// The device with this index, or nullptr if it doesn't exist and the request should be ignored.
+	/** The device must stay valid until the method returns. When the devices change, call
+	  * Server::notifyDeviceListUpdated(), so that the clients download them again. */
+	virtual const Device * device( uint32_t deviceIdx ) = 0;
+
+	//-- connections ---------------------------------------------------------------------------------------------------
+
+	virtual void clientConnected( const ServerClientInfo & /*client*/ ) {}
+	virtual void clientNamed( const ServerClientInfo & /*client*/ ) {}
+	virtual void clientDisconnected( const ServerClientInfo & /*client*/ ) {}
+
+	//-- device control ------------------------------------------------------------------------------------------------
+
+	virtual void resizeZone( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, uint32_t /*zoneIdx*/, uint32_t /*newSize*/ ) {}
+	virtual void updateLEDs( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, Span< const Color > /*colors*/ ) {}
+	virtual void updateZoneLEDs( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, uint32_t /*zoneIdx*/, Span< const Color > /*colors*/ ) {}
+	virtual void updateSingleLED( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, uint32_t /*ledIdx*/, Color /*color*/ ) {}
+	virtual void setCustomMode( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/ ) {}
+	virtual void updateMode( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, const Mode & /*mode*/ ) {}
+	virtual void saveMode( const ServerClientInfo & /*client*/, uint32_t /*deviceIdx*/, const Mode & /*mode*/ ) {}
+
+	//-- profiles ------------------------------------------------------------------------------------------------------
+
+	virtual std::vector< std::string > profileList( const ServerClientInfo & /*client*/ ) { return {}; }
+	virtual void saveProfile( const ServerClientInfo & /*client*/, const std::string & /*profileName*/ ) {}
+	virtual void loadProfile( const ServerClientInfo & /*client*/, const std::string & /*profileName*/ ) {}
+	virtual void deleteProfile( const ServerClientInfo & /*client*/, const std::string & /*profileName*/ ) {}
+
+};
+
+
+//======================================================================================================================
+/// OpenRGB protocol server.
+/** Accepts any number of clients and serves all of them from a single thread using non-blocking sockets.
+  * The requests are parsed by the same message structs the Client uses and passed to a ServerHandler.
+  *
+  * The library doesn't start any thread for the server, call run() or processEvents(...) from your own thread.
+  * Only interrupt() and notifyDeviceListUpdated() may be called from other threads.
+  *
+  * Currently implemented only on Linux. */
+
+class Server
+{
+
+ public:
+
+	/// Creates a server that passes the requests to the handler. Does not listen yet.
+	/** The handler is not owned by the server and must outlive it. */
+	Server( ServerHandler & handler ) noexcept;
+
+	/// Disconnects all the clients and stops listening.
+	~Server() noexcept;
+
+	Server( const Server & other ) = delete;
+	Server & operator=( const Server & other ) = delete;
+
+	/// Starts listening for clients on the IPv4 address and port.
+	/** \param port 0 lets the system choose a free port, see port() */
+	ServerStatus start( uint16_t port, const std::string & address = "0.0.0.0" ) noexcept;
+
+	/// Disconnects all the clients and stops listening.
+	void stop() noexcept;
+
+	bool isRunning() const noexcept;
+
+	/// The port the server listens on.
+	uint16_t port() const noexcept;
+
+	/// Number of currently connected clients.
+	size_t clientCount() const noexcept;
+
+	/// Waits up to the timeout for network events and handles all that have arrived.
+	ServerStatus processEvents( std::chrono::milliseconds timeout ) noexcept;
+
+	/// Handles the network events until interrupt() is called.
+	ServerStatus run() noexcept;
+
+	/// Makes run() return as soon as possible. Can be called from any thread or a signal handler.
+	void interrupt() noexcept;
+
+	/// Sends the DEVICE_LIST_UPDATED notification to all the connected clients. Can be called from any thread.
+	/** The notification is sent by the thread running the server during its next iteration. */
+	void notifyDeviceListUpdated() noexcept;
+
+	/// Returns the system error code that caused the last failure.
+	system_error_t getLastSystemError() const noexcept;
+
+ private:
+
+	struct Impl;
+	// a pointer so that we don't have to include the OS dependant networking headers here
+	std::unique_ptr< Impl > _impl;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_SERVER_INCLUDED
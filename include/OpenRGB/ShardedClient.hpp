@@ -0,0 +1,147 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: client spreading the devices over several connections to the same server
+//======================================================================================================================
+
+#ifndef OPENRGB_SHARDED_CLIENT_INCLUDED
+#define OPENRGB_SHARDED_CLIENT_INCLUDED
+
+
+#include "Client.hpp"
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+namespace orgb {
+
+
+class FrameBuffer;
+class ThreadPool;
+
+
+//======================================================================================================================
+
+/// How ShardedClient decides which connection serves which device
+enum class ShardingStrategy
+{
+	RoundRobin,  ///< device i goes to connection i % shardCount
+	ByLEDCount,  ///< the devices with most LEDs are spread first, each to the connection with the least LEDs so far
+};
+const char * enumString( ShardingStrategy strategy ) noexcept;
+
+
+//======================================================================================================================
+/// Client that opens several connections to the same server and sends the requests of each device through one of them.
+/** The OpenRGB app processes every client connection on its own thread, so a single connection is limited by what one
+  * server thread can push to the hardware. With the devices assigned to several connections, the updates of devices
+  * on different connections are processed in parallel.
+  *
+  * There is only one device list, downloaded through the first connection, the other connections receive only the
+  * requests of their devices. The assignment is made by requestDeviceList() or assignShards(). Color corrections,
+  * the state mirror and the traffic recorder belong to the individual connections, set them up through shard(). */
+
+class ShardedClient
+{
+
+ public:
+
+	/// Creates the clients for all the connections. Does not connect anywhere yet.
+	/** \param shardCount number of connections, 0 is treated as 1 */
+	explicit ShardedClient( size_t shardCount, const std::string & clientName = "orgb::ShardedClient",
+	                        ShardingStrategy strategy = ShardingStrategy::ByLEDCount );
+
+	~ShardedClient() noexcept;
+
+	// The connections cannot be shared.
+	ShardedClient( const ShardedClient & other ) = delete;
+
+	ShardedClient( ShardedClient && other ) noexcept = default;
+	ShardedClient & operator=( ShardedClient && other ) noexcept = default;
+
+	/// Number of the connections.
+	size_t shardCount() const noexcept  { return _shards.size(); }
+
+	/// The client of one connection, for things that are set up per connection or for driving it from your own thread.
+	Client & shard( size_t shardIdx ) noexcept  { return _shards[ shardIdx ]; }
+
+	/// Index of the connection that serves this device.
+	size_t shardOf( uint32_t deviceIdx ) const noexcept
+	{
+		// a device that appeared after the last assignment still gets a valid connection
+		return deviceIdx < _deviceShards.size() ? _deviceShards[ deviceIdx ] : deviceIdx % _shards.size();
+	}
+
+	/// Tells whether all the connections are connected.
+	bool isConnected() const noexcept;
+
+	//-- return-value-oriented exception-less API ----------------------------------------------------------------------
+
+	/// Opens all the connections.
+	/** When any of them fails, the others are closed again and the status of the failed one is returned. */
+	ConnectStatus connect( const std::string & host, uint16_t port = defaultPort ) noexcept;
+
+	/// Closes all the connections.
+	/** It will return false if any of them was not connected or some rare system error occurs. */
+	bool disconnect() noexcept;
+
+	/// Sets a timeout for receiving request answers on all the connections.
+	bool setTimeout( std::chrono::milliseconds timeout ) noexcept;
+
+	/// Queries the server for information about all its RGB devices and assigns the devices to the connections.
+	DeviceListResult requestDeviceList() noexcept;
+	DeviceListResult requestDeviceList( const RequestLimits & limits ) noexcept;
+
+	/// Queries the server for information about a single RGB device through the connection of this device.
+	DeviceInfoResult requestDeviceInfo( uint32_t deviceIdx ) noexcept;
+	DeviceInfoResult requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits ) noexcept;
+
+	/// Checks all the connections whether the device list has been changed on the server.
+	/** Every connection receives its own notification, so all of them are checked, otherwise the next check would
+	  * report the same change again. Errors take precedence over OutOfDate. */
+	UpdateStatus checkForDeviceUpdates() noexcept;
+
+	/// Assigns the devices to the connections, use it when you obtained the device list some other way.
+	void assignShards( const DeviceList & devices );
+
+	/// Changes the strategy for the next assignment.
+	void setShardingStrategy( ShardingStrategy strategy ) noexcept  { _strategy = strategy; }
+
+	RequestStatus switchToCustomMode( const Device & device ) noexcept;
+	RequestStatus changeMode( const Device & device, const Mode & mode ) noexcept;
+	RequestStatus changeMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept;
+	RequestStatus setDeviceColor( const Device & device, Color color ) noexcept;
+	RequestStatus setZoneColor( const Zone & zone, Color color ) noexcept;
+	RequestStatus setDeviceColors( const Device & device, Span< const Color > colors ) noexcept;
+	RequestStatus setZoneColors( const Zone & zone, Span< const Color > colors ) noexcept;
+	RequestStatus setZoneSize( const Zone & zone, uint32_t newSize ) noexcept;
+	RequestStatus setLEDColor( const LED & led, Color color ) noexcept;
+
+	/// Sends the colors of all devices from a frame, each through its connection.
+	/** With a pool, each connection is written from a different thread. The frame must have been built from
+	  * the same device list. Returns the first error, the other devices are still sent. */
+	RequestStatus setFrameColors( const DeviceList & devices, const FrameBuffer & frame, ThreadPool * pool = nullptr ) noexcept;
+
+ private:
+
+	std::vector< Client > _shards;
+	std::vector< uint32_t > _deviceShards;  ///< index of the connection of each device
+	ShardingStrategy _strategy;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_SHARDED_CLIENT_INCLUDED
@@ -0,0 +1,261 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: binary snapshot of a device list that can be shared between processes via memory mapping
+//======================================================================================================================
+
+#ifndef OPENRGB_SNAPSHOT_INCLUDED
+#define OPENRGB_SNAPSHOT_INCLUDED
+
+
+#include "DeviceInfo.hpp"
+#include "Color.hpp"
+#include "Span.hpp"
+#include "SystemErrorType.hpp"  // HACK: read the comment at the top of that header file
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>  // unique_ptr<MappedFile>
+
+
+namespace orgb {
+
+
+class MappedFile;
+
+
+//======================================================================================================================
+//  snapshot format
+//
+//  The snapshot is one contiguous block of memory. All references inside it are stored as offsets relative to the
+//  address of the reference itself, so the block can be mapped anywhere and each record can resolve its strings and
+//  arrays on its own without knowing where the block begins. Numbers are stored in the native byte order of the host,
+//  because the snapshot is meant to be shared between processes on the same machine.
+//
+//  SnapshotHeader
+//  SnapshotDevice [device_count]
+//  ... arrays of SnapshotMode, SnapshotZone, SnapshotLED, Color, uint32_t and strings referenced from the records ...
+
+/// current version of the snapshot format, snapshots of other versions are refused
+constexpr uint32_t snapshotFormatVersion = 1;
+
+/// Reference to a null-terminated string stored somewhere else in the snapshot.
+struct SnapshotString
+{
+	int32_t   offset;  ///< relative to the address of this struct
+	uint32_t  size;    ///< number of characters without the null terminator
+
+	StringView view() const noexcept
+	{
+		return StringView( reinterpret_cast< const char * >( this ) + offset, size );
+	}
+	const char * c_str() const noexcept
+	{
+		return reinterpret_cast< const char * >( this ) + offset;
+	}
+};
+
+/// Reference to an array stored somewhere else in the snapshot.
+template< typename Elem >
+struct SnapshotArray
+{
+	int32_t   offset;  ///< relative to the address of this struct
+	uint32_t  count;   ///< number of elements
+
+	Span< const Elem > view() const noexcept
+	{
+		return Span< const Elem >( reinterpret_cast< const Elem * >( reinterpret_cast< const char * >( this ) + offset ), count );
+	}
+};
+
+/// Snapshot of a LED, see LED.
+struct SnapshotLED
+{
+	SnapshotString  name;
+	uint32_t        value;
+
+	StringView getName() const noexcept  { return name.view(); }
+};
+
+/// Snapshot of a zone, see Zone.
+struct SnapshotZone
+{
+	SnapshotString  name;
+	ZoneType        type;
+	uint32_t        leds_min;
+	uint32_t        leds_max;
+	uint32_t        leds_count;
+	uint32_t        matrix_height;
+	uint32_t        matrix_width;
+	SnapshotArray< uint32_t >  matrix_values;
+
+	StringView getName() const noexcept  { return name.view(); }
+	Span< const uint32_t > getMatrixValues() const noexcept  { return matrix_values.view(); }
+};
+
+/// Snapshot of a mode, see Mode.
+struct SnapshotMode
+{
+	SnapshotString  name;
+	uint32_t        value;
+	uint32_t        flags;
+	uint32_t        speed_min;
+	uint32_t        speed_max;
+	uint32_t        brightness_min;
+	uint32_t        brightness_max;
+	uint32_t        colors_min;
+	uint32_t        colors_max;
+	uint32_t        speed;
+	uint32_t        brightness;
+	Direction       direction;
+	ColorMode       color_mode;
+	SnapshotArray< Color >  colors;
+
+	StringView getName() const noexcept  { return name.view(); }
+	Span< const Color > getColors() const noexcept  { return colors.view(); }
+};
+
+/// Snapshot of a device, see Device.
+struct SnapshotDevice
+{
+	uint32_t        idx;
+	DeviceType      type;
+	SnapshotString  name;
+	SnapshotString  vendor;
+	SnapshotString  description;
+	SnapshotString  version;
+	SnapshotString  serial;
+	SnapshotString  location;
+	uint32_t        active_mode;
+	SnapshotArray< SnapshotMode >  modes;
+	SnapshotArray< SnapshotZone >  zones;
+	SnapshotArray< SnapshotLED >   leds;
+	SnapshotArray< Color >         colors;
+
+	StringView getName() const noexcept         { return name.view(); }
+	StringView getVendor() const noexcept       { return vendor.view(); }
+	StringView getDescription() const noexcept  { return description.view(); }
+	StringView getVersion() const noexcept      { return version.view(); }
+	StringView getSerial() const noexcept       { return serial.view(); }
+	StringView getLocation() const noexcept     { return location.view(); }
+
+	Span< const SnapshotMode > getModes() const noexcept  { return modes.view(); }
+	Span< const SnapshotZone > getZones() const noexcept  { return zones.view(); }
+	Span< const SnapshotLED >  getLEDs() const noexcept   { return leds.view(); }
+	Span< const Color >        getColors() const noexcept { return colors.view(); }
+};
+
+/// Beginning of every snapshot.
+struct SnapshotHeader
+{
+	char      magic [8];       ///< must always be "ORGBSNAP"
+	uint32_t  format_version;  ///< see snapshotFormatVersion
+	uint32_t  byte_order;      ///< 0x01020304 written in the native byte order of the writer
+	uint64_t  total_size;      ///< size of the whole snapshot including this header
+	uint64_t  sequence;        ///< arbitrary number the writer can use to tell readers the snapshot has been replaced
+	SnapshotArray< SnapshotDevice >  devices;
+};
+
+
+//======================================================================================================================
+
+/// All the possible ways how an operation with a snapshot can end up
+enum class SnapshotStatus
+{
+	Success,             ///< The operation was successful.
+	CannotOpenFile,      ///< The file could not be opened, created or mapped into memory. Call getLastSystemError() for more info.
+	CannotWriteFile,     ///< The file could not be written or replaced, check errno (GetLastError() on Windows) for more info.
+	InvalidFormat,       ///< The data are not a snapshot or they are damaged.
+	VersionNotSupported, ///< The snapshot was written by an incompatible version of this library or on a different architecture.
+	UnexpectedError,     ///< Internal error of this library. This should not happen unless there is a mistake in the code, please create a github issue.
+};
+const char * enumString( SnapshotStatus status ) noexcept;
+
+
+//======================================================================================================================
+//  Write the snapshot once after Client::requestDeviceList() and let other processes open it via DeviceListSnapshot
+//  instead of downloading the device list from the server again.
+
+/// Serializes the device list into a snapshot stored in a memory buffer.
+std::vector< uint8_t > makeSnapshot( const DeviceList & devices, uint64_t sequence = 0 );
+
+/// Serializes the device list into a snapshot file.
+/** The file is first written under a temporary name and then renamed, so that processes that are just opening
+  * the snapshot always see either the old or the new complete version. */
+SnapshotStatus saveSnapshot( const DeviceList & devices, const std::string & filePath, uint64_t sequence = 0 ) noexcept;
+
+
+//======================================================================================================================
+/// Read-only view of a device list snapshot that is mapped directly into memory.
+/** Opening validates all the references once, afterwards all the accessors are only pointer arithmetic,
+  * there is no parsing and no allocation. */
+
+class DeviceListSnapshot
+{
+
+ public:
+
+	DeviceListSnapshot() noexcept;
+	~DeviceListSnapshot() noexcept;
+
+	// The mapping cannot be shared.
+	DeviceListSnapshot( const DeviceListSnapshot & other ) = delete;
+
+	DeviceListSnapshot( DeviceListSnapshot && other ) noexcept;
+	DeviceListSnapshot & operator=( DeviceListSnapshot && other ) noexcept;
+
+	/// Maps the snapshot file into memory and validates it.
+	SnapshotStatus open( const std::string & filePath ) noexcept;
+
+	/// Validates and uses a snapshot that is already in memory, for example in a shared memory segment.
+	/** The memory must stay valid and unchanged until close() is called or this object is destroyed. */
+	SnapshotStatus attach( const void * data, size_t size ) noexcept;
+
+	/// Releases the mapping, all the views obtained from this snapshot become invalid.
+	void close() noexcept;
+
+	bool isOpen() const noexcept  { return _header != nullptr; }
+
+	/// Sequence number assigned by the writer.
+	uint64_t sequence() const noexcept  { return _header ? _header->sequence : 0; }
+
+	size_t size() const noexcept  { return _devices.size(); }
+
+	const SnapshotDevice * begin() const noexcept  { return _devices.begin(); }
+	const SnapshotDevice * end() const noexcept    { return _devices.end(); }
+
+	const SnapshotDevice & operator[]( uint32_t deviceIdx ) const noexcept  { return _devices[ deviceIdx ]; }
+
+	/// Finds the first device of specific type.
+	/** \returns nullptr when device of this type is not found */
+	const SnapshotDevice * find( DeviceType deviceType ) const noexcept;
+
+	/// Finds the first device with a specific name.
+	/** \returns nullptr when device with this name is not found */
+	const SnapshotDevice * find( StringView deviceName ) const noexcept;
+
+	/// Returns the system error code that caused the last failure.
+	system_error_t getLastSystemError() const noexcept  { return _lastSystemError; }
+
+ private:
+
+	// a pointer so that we don't have to include the OS dependant mapping here
+	std::unique_ptr< MappedFile > _file;
+
+	const SnapshotHeader * _header;
+	Span< const SnapshotDevice > _devices;
+
+	system_error_t _lastSystemError;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_SNAPSHOT_INCLUDED
@@ -0,0 +1,126 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: non-owning views of arrays and strings
+//======================================================================================================================
+
+#ifndef OPENRGB_SPAN_INCLUDED
+#define OPENRGB_SPAN_INCLUDED
+
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <type_traits>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Non-owning view of a contiguous array of objects, poor man's replacement of C++20 std::span.
+
+template< typename Type >
+class Span
+{
+	Type * _data;
+	size_t _size;
+
+	using MutableType = typename std::remove_const< Type >::type;
+
+ public:
+
+	using value_type = MutableType;
+	using iterator = Type *;
+
+	constexpr Span() noexcept : _data( nullptr ), _size( 0 ) {}
+	constexpr Span( Type * data, size_t size ) noexcept : _data( data ), _size( size ) {}
+	Span( Type * begin, Type * end ) noexcept : _data( begin ), _size( size_t( end - begin ) ) {}
+
+	template< size_t Size >
+	constexpr Span( Type (& array) [Size] ) noexcept : _data( array ), _size( Size ) {}
+
+	template< size_t Size >
+	Span( std::array< MutableType, Size > & array ) noexcept : _data( array.data() ), _size( Size ) {}
+
+	Span( std::vector< MutableType > & vec ) noexcept : _data( vec.data() ), _size( vec.size() ) {}
+
+	/// Read-only span can also be made from a const vector.
+	template< typename Dummy = Type, typename std::enable_if< std::is_const< Dummy >::value, int >::type = 0 >
+	Span( const std::vector< MutableType > & vec ) noexcept : _data( vec.data() ), _size( vec.size() ) {}
+
+	/// Mutable span can be implicitly converted to a read-only span.
+	template< typename OtherType, typename std::enable_if<
+		std::is_convertible< OtherType *, Type * >::value && sizeof(OtherType) == sizeof(Type)
+	, int >::type = 0 >
+	constexpr Span( const Span< OtherType > & other ) noexcept : _data( other.data() ), _size( other.size() ) {}
+
+	constexpr Type * data() const noexcept  { return _data; }
+	constexpr size_t size() const noexcept  { return _size; }
+	constexpr bool empty() const noexcept   { return _size == 0; }
+
+	constexpr Type * begin() const noexcept  { return _data; }
+	constexpr Type * end() const noexcept    { return _data + _size; }
+
+	Type & operator[]( size_t idx ) const noexcept  { return _data[ idx ]; }
+
+	/// Returns a view of count elements starting at offset, the range must lie inside this span.
+	constexpr Span subspan( size_t offset, size_t count ) const noexcept  { return Span( _data + offset, count ); }
+	constexpr Span first( size_t count ) const noexcept  { return Span( _data, count ); }
+};
+
+template< typename Type >
+Span< Type > makeSpan( std::vector< Type > & vec ) noexcept  { return Span< Type >( vec ); }
+template< typename Type >
+Span< const Type > makeSpan( const std::vector< Type > & vec ) noexcept  { return Span< const Type >( vec ); }
+
+
+//======================================================================================================================
+/// Non-owning view of a string that may not be null-terminated, poor man's replacement of C++17 std::string_view.
+
+class StringView
+{
+	const char * _data;
+	size_t _size;
+
+ public:
+
+	constexpr StringView() noexcept : _data( "" ), _size( 0 ) {}
+	constexpr StringView( const char * data, size_t size ) noexcept : _data( data ), _size( size ) {}
+	StringView( const char * str ) noexcept : _data( str ), _size( strlen( str ) ) {}
+	StringView( const std::string & str ) noexcept : _data( str.data() ), _size( str.size() ) {}
+
+	constexpr const char * data() const noexcept  { return _data; }
+	constexpr size_t size() const noexcept        { return _size; }
+	constexpr bool empty() const noexcept         { return _size == 0; }
+
+	constexpr const char * begin() const noexcept  { return _data; }
+	constexpr const char * end() const noexcept    { return _data + _size; }
+
+	constexpr char operator[]( size_t idx ) const noexcept  { return _data[ idx ]; }
+
+	constexpr StringView substr( size_t offset, size_t count ) const noexcept  { return StringView( _data + offset, count ); }
+
+	std::string toString() const  { return std::string( _data, _size ); }
+
+	friend bool operator==( StringView a, StringView b ) noexcept
+	{
+		return a._size == b._size && memcmp( a._data, b._data, a._size ) == 0;
+	}
+	friend bool operator!=( StringView a, StringView b ) noexcept
+	{
+		return !(a == b);
+	}
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_SPAN_INCLUDED
@@ -0,0 +1,76 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: small work-stealing thread pool for splitting the rendering of frames
+//======================================================================================================================
+
+#ifndef OPENRGB_THREAD_POOL_INCLUDED
+#define OPENRGB_THREAD_POOL_INCLUDED
+
+
+#include <cstddef>
+#include <memory>  // unique_ptr<Impl>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Pool of worker threads executing the tasks of one parallelFor(...) at a time.
+/** The library itself never starts any threads, this pool exists only when you create it and pass it
+  * for example to EffectEngine::render().
+  *
+  * The tasks are initially split evenly between the threads. A thread that finishes its share steals half of
+  * the remaining tasks of another thread, so a few expensive tasks (a big matrix zone) don't leave the other threads
+  * idle. Every thread's range of tasks is guarded by its own mutex, which the owner locks for each task it takes,
+  * so the lock is mostly uncontended and only a steal makes two threads touch the same one. */
+
+class ThreadPool
+{
+
+ public:
+
+	/// Starts the worker threads.
+	/** \param threadCount number of threads working on the tasks including the one calling parallelFor(...),
+	  *                    0 means the number of hardware threads */
+	explicit ThreadPool( unsigned threadCount = 0 );
+
+	/// Stops and joins the worker threads.
+	~ThreadPool() noexcept;
+
+	ThreadPool( const ThreadPool & other ) = delete;
+	ThreadPool & operator=( const ThreadPool & other ) = delete;
+
+	/// Number of threads working on the tasks including the calling one.
+	unsigned threadCount() const noexcept;
+
+	/// Calls task( idx ) for every idx in [0, taskCount) and returns after all the calls finish.
+	/** The calling thread works on the tasks too. The task must not throw and must not call parallelFor(...)
+	  * of the same pool. Only one thread may call parallelFor(...) at a time. */
+	template< typename Task >
+	void parallelFor( size_t taskCount, Task task )
+	{
+		run( taskCount, []( void * context, size_t idx ) { (*static_cast< Task * >( context ))( idx ); }, &task );
+	}
+
+ private:
+
+	using TaskFunc = void (*)( void * context, size_t idx );
+
+	void run( size_t taskCount, TaskFunc func, void * context );
+
+	struct Impl;
+	// a pointer so that we don't have to include the threading headers here
+	std::unique_ptr< Impl > _impl;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_THREAD_POOL_INCLUDED
@@ -0,0 +1,165 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: recording of the raw protocol traffic of a Client into a log file and reading it back
+//======================================================================================================================
+
+#ifndef OPENRGB_TRAFFIC_LOG_INCLUDED
+#define OPENRGB_TRAFFIC_LOG_INCLUDED
+
+
+#include "Span.hpp"
+#include "SystemErrorType.hpp"  // HACK: read the comment at the top of that header file
+
+#include <cstdint>
+#include <cstdio>  // FILE
+#include <string>
+#include <memory>  // unique_ptr<MappedFile>
+#include <chrono>
+
+
+namespace orgb {
+
+
+class MappedFile;
+
+
+//======================================================================================================================
+//  traffic log format
+//
+//  Numbers are stored in the native byte order of the writer.
+//
+//  TrafficLogHeader
+//  records, each consisting of TrafficRecordHeader and the bytes of one whole protocol message
+//  (header and body exactly as they went through the socket), padded to a multiple of 8 bytes
+
+/// current version of the traffic log format, logs of other versions are refused
+constexpr uint32_t trafficLogFormatVersion = 1;
+
+/// Beginning of every traffic log.
+struct TrafficLogHeader
+{
+	char      magic [8];       ///< must always be "ORGBTRAF"
+	uint32_t  format_version;  ///< see trafficLogFormatVersion
+	uint32_t  byte_order;      ///< 0x01020304 written in the native byte order of the writer
+};
+
+/// Which way a message went.
+enum class TrafficDirection : uint8_t
+{
+	Sent,      ///< from the client to the server
+	Received,  ///< from the server to the client
+};
+
+/// Beginning of every record in a traffic log.
+struct TrafficRecordHeader
+{
+	uint64_t          timestamp_us;  ///< microseconds since the start of the recording
+	uint32_t          size;          ///< size of the message without the padding
+	TrafficDirection  direction;
+	uint8_t           reserved [3];
+};
+
+
+//======================================================================================================================
+/// Writes the messages passing through a Client into a traffic log, see Client::setTrafficRecorder().
+/** The records are buffered by the C library, so recording adds only a memcpy per message. */
+
+class TrafficRecorder
+{
+
+ public:
+
+	TrafficRecorder() noexcept;
+	~TrafficRecorder() noexcept;
+
+	TrafficRecorder( const TrafficRecorder & other ) = delete;
+	TrafficRecorder & operator=( const TrafficRecorder & other ) = delete;
+
+	/// Creates the log file and starts the clock of the recording.
+	/** Returns false and remembers the system error code on failure. */
+	bool open( const std::string & filePath ) noexcept;
+
+	/// Flushes and closes the log file.
+	void close() noexcept;
+
+	bool isOpen() const noexcept  { return _file != nullptr; }
+
+	/// Appends a message, the message can be given in two parts that are concatenated.
+	/** When writing fails, the log is closed and the rest of the traffic is not recorded. */
+	void record( TrafficDirection direction, Span< const uint8_t > part1, Span< const uint8_t > part2 = {} ) noexcept;
+
+	/// Number of messages recorded so far.
+	uint64_t recordCount() const noexcept  { return _recordCount; }
+
+	/// Returns the system error code that caused the last failure.
+	system_error_t getLastSystemError() const noexcept  { return _lastSystemError; }
+
+ private:
+
+	FILE * _file;
+	std::chrono::steady_clock::time_point _start;
+	uint64_t _recordCount;
+	system_error_t _lastSystemError;
+
+};
+
+
+//======================================================================================================================
+/// Reads a traffic log mapped directly into memory.
+
+class TrafficLogReader
+{
+
+ public:
+
+	/// One message of the log.
+	struct Record
+	{
+		std::chrono::microseconds time;  ///< since the start of the recording
+		TrafficDirection direction;
+		Span< const uint8_t > data;      ///< the whole message, points into the mapped file
+	};
+
+	TrafficLogReader() noexcept;
+	~TrafficLogReader() noexcept;
+
+	TrafficLogReader( const TrafficLogReader & other ) = delete;
+	TrafficLogReader & operator=( const TrafficLogReader & other ) = delete;
+
+	/// Maps the log into memory and checks its header.
+	/** Returns false when the file cannot be mapped or is not a traffic log of this version. */
+	bool open( const std::string & filePath ) noexcept;
+
+	void close() noexcept;
+
+	bool isOpen() const noexcept  { return _file != nullptr; }
+
+	/// Reads the next record, returns false at the end of the log.
+	/** A truncated last record, for example from a recording interrupted by a crash, is treated as the end. */
+	bool next( Record & record ) noexcept;
+
+	/// Starts reading from the first record again.
+	void rewind() noexcept;
+
+	/// Returns the system error code that caused the last failure.
+	system_error_t getLastSystemError() const noexcept  { return _lastSystemError; }
+
+ private:
+
+	// a pointer so that we don't have to include the OS dependant mapping here
+	std::unique_ptr< MappedFile > _file;
+	size_t _position;
+	system_error_t _lastSystemError;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_TRAFFIC_LOG_INCLUDED
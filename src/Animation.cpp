@@ -0,0 +1,585 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: pre-rendered animations stored in files that are played directly from memory mapping
+//======================================================================================================================
+
+#include <OpenRGB/Animation.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <OpenRGB/Client.hpp>
+#include <OpenRGB/ColorKernels.hpp>
+#include "MappedFile.hpp"
+
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>  // uintptr_t
+#include <cmath>    // lround
+#include <algorithm>  // min
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+using std::move;
+
+
+namespace orgb {
+
+
+static const char animationMagic [8] = { 'O','R','G','B','A','N','I','M' };
+static const uint32_t byteOrderMark = 0x01020304;
+
+static_assert( sizeof(Color) == 4, "the frames expect Color to be 4 bytes without any gaps" );
+
+
+//======================================================================================================================
+//  enum to string conversion
+
+const char * enumString( AnimationStatus status ) noexcept
+{
+	static const char * const AnimationStatusStr [] =
+	{
+		"The operation was successful.",
+		"The file could not be opened, created or mapped into memory.",
+		"The file could not be written or replaced.",
+		"The data are not an animation or they are damaged.",
+		"The animation was written by an incompatible version of this library or on a different architecture.",
+		"The number of colors in the frame doesn't match the number of LEDs of the animation.",
+		"The writer has not been opened or it has already been finished.",
+		"Internal error of this library. Please create a github issue.",
+	};
+	static_assert( size_t(AnimationStatus::UnexpectedError) + 1 == fut::size(AnimationStatusStr), "update the AnimationStatusStr" );
+
+	if (size_t(status) < fut::size(AnimationStatusStr))
+	{
+		return AnimationStatusStr[ size_t(status) ];
+	}
+	else
+	{
+		return "<invalid status>";
+	}
+}
+
+
+//======================================================================================================================
+//  layout fingerprint
+
+// FNV-1a, the fingerprint only needs to catch a different set of devices, not an intentional collision
+static void hashBytes( uint64_t & hash, const void * data, size_t size ) noexcept
+{
+	const uint8_t * bytes = static_cast< const uint8_t * >( data );
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+}
+
+static void hashUInt( uint64_t & hash, uint32_t value ) noexcept
+{
+	hashBytes( hash, &value, sizeof(value) );
+}
+
+uint64_t layoutFingerprint( const DeviceList & devices ) noexcept
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	hashUInt( hash, uint32_t( devices.size() ) );
+	for (const Device & device : devices)
+	{
+		hashBytes( hash, device.name.c_str(), device.name.size() + 1 );
+		hashUInt( hash, uint32_t( device.leds.size() ) );
+		hashUInt( hash, uint32_t( device.zones.size() ) );
+		for (const Zone & zone : device.zones)
+		{
+			hashUInt( hash, zone.leds_count );
+		}
+	}
+	return hash;
+}
+
+
+//======================================================================================================================
+//  AnimationWriter
+
+static inline bool isSame( Color a, Color b ) noexcept
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.padding == b.padding;
+}
+
+AnimationWriter::AnimationWriter() noexcept
+:
+	_file( nullptr ),
+	_header(),
+	_keyframeInterval( 1 ),
+	_position( 0 )
+{}
+
+AnimationWriter::~AnimationWriter() noexcept
+{
+	cancel();
+}
+
+AnimationStatus AnimationWriter::writeBytes( const void * data, size_t size ) noexcept
+{
+	if (size > 0 && fwrite( data, 1, size, _file ) != size)
+	{
+		cancel();
+		return AnimationStatus::CannotWriteFile;
+	}
+	_position += size;
+	return AnimationStatus::Success;
+}
+
+AnimationStatus AnimationWriter::open( const std::string & filePath, const DeviceList & devices, double framesPerSecond,
+                                       uint32_t keyframeInterval ) noexcept
+{
+	try
+	{
+		cancel();
+
+		_filePath = filePath;
+		_tempPath = uniqueTempPath( filePath );
+		_file = fopen( _tempPath.c_str(), "wb" );
+		if (!_file)
+		{
+			return AnimationStatus::CannotOpenFile;
+		}
+
+		vector< uint32_t > deviceLedCounts;
+		uint32_t ledCount = 0;
+		for (const Device & device : devices)
+		{
+			deviceLedCounts.push_back( uint32_t( device.leds.size() ) );
+			ledCount += uint32_t( device.leds.size() );
+		}
+
+		memset( &_header, 0, sizeof(_header) );
+		memcpy( _header.magic, animationMagic, sizeof(_header.magic) );
+		_header.format_version = animationFormatVersion;
+		_header.byte_order = byteOrderMark;
+		_header.layout_fingerprint = layoutFingerprint( devices );
+		_header.device_count = uint32_t( devices.size() );
+		_header.led_count = ledCount;
+		_header.frame_period_us = framesPerSecond > 0.0 ? uint32_t( std::lround( 1000000.0 / framesPerSecond ) ) : 0;
+
+		_keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+		_position = 0;
+		_previous.clear();
+		_frames.clear();
+
+		// the header is written again with the final numbers in finish()
+		AnimationStatus status = writeBytes( &_header, sizeof(_header) );
+		if (status != AnimationStatus::Success)
+			return status;
+		return writeBytes( deviceLedCounts.data(), deviceLedCounts.size() * sizeof(uint32_t) );
+	}
+	catch (...)
+	{
+		cancel();
+		return AnimationStatus::UnexpectedError;
+	}
+}
+
+AnimationStatus AnimationWriter::addFrame( Span< const Color > colors ) noexcept
+{
+	if (!_file)
+	{
+		return AnimationStatus::NotOpen;
+	}
+	if (colors.size() != _header.led_count)
+	{
+		return AnimationStatus::WrongFrameSize;
+	}
+
+	try
+	{
+		uint32_t frameIdx = uint32_t( _frames.size() );
+		size_t rawSize = colors.size() * sizeof(Color);
+
+		bool isKeyframe = frameIdx % _keyframeInterval == 0 || _previous.size() != colors.size();
+		if (!isKeyframe)
+		{
+			// Find the runs of changed colors. A gap of up to 2 unchanged colors is cheaper to include in the run
+			// than to start a new run with its 8 bytes of header.
+			_deltaBuffer.clear();
+			size_t i = 0;
+			while (i < colors.size() && _deltaBuffer.size() < rawSize)
+			{
+				if (isSame( colors[i], _previous[i] ))
+				{
+					i++;
+					continue;
+				}
+				size_t runEnd = i + 1;
+				size_t lastChanged = i;
+				while (runEnd < colors.size() && runEnd - lastChanged <= 2)
+				{
+					if (!isSame( colors[ runEnd ], _previous[ runEnd ] ))
+						lastChanged = runEnd;
+					runEnd++;
+				}
+				uint32_t run [2] = { uint32_t( i ), uint32_t( lastChanged + 1 - i ) };
+				size_t pos = _deltaBuffer.size();
+				_deltaBuffer.resize( pos + sizeof(run) + run[1] * sizeof(Color) );
+				memcpy( _deltaBuffer.data() + pos, run, sizeof(run) );
+				memcpy( _deltaBuffer.data() + pos + sizeof(run), colors.data() + i, run[1] * sizeof(Color) );
+				i = lastChanged + 1;
+			}
+			// when most of the frame changed, the raw frame is smaller and faster to play
+			isKeyframe = _deltaBuffer.size() >= rawSize;
+		}
+
+		AnimationFrameEntry entry;
+		entry.offset = _position;
+		AnimationStatus status;
+		if (isKeyframe)
+		{
+			entry.type = AnimationFrameType::Raw;
+			entry.size = uint32_t( rawSize );
+			status = writeBytes( colors.data(), rawSize );
+		}
+		else
+		{
+			entry.type = AnimationFrameType::Delta;
+			entry.size = uint32_t( _deltaBuffer.size() );
+			status = writeBytes( _deltaBuffer.data(), _deltaBuffer.size() );
+		}
+		if (status != AnimationStatus::Success)
+		{
+			return status;
+		}
+
+		_frames.push_back( entry );
+		_previous.assign( colors.begin(), colors.end() );
+		return AnimationStatus::Success;
+	}
+	catch (...)
+	{
+		return AnimationStatus::UnexpectedError;
+	}
+}
+
+AnimationStatus AnimationWriter::finish() noexcept
+{
+	if (!_file)
+	{
+		return AnimationStatus::NotOpen;
+	}
+
+	// the frame table contains 64-bit numbers
+	static const uint8_t padding [8] = {};
+	AnimationStatus status = writeBytes( padding, size_t( (8 - _position % 8) % 8 ) );
+	if (status != AnimationStatus::Success)
+		return status;
+
+	_header.frame_count = uint32_t( _frames.size() );
+	_header.frame_table_offset = _position;
+	status = writeBytes( _frames.data(), _frames.size() * sizeof(AnimationFrameEntry) );
+	if (status != AnimationStatus::Success)
+		return status;
+	_header.total_size = _position;
+
+	bool written = fseek( _file, 0, SEEK_SET ) == 0 && fwrite( &_header, 1, sizeof(_header), _file ) == sizeof(_header);
+	written &= fclose( _file ) == 0;
+	_file = nullptr;
+	if (!written)
+	{
+		remove( _tempPath.c_str() );
+		return AnimationStatus::CannotWriteFile;
+	}
+
+	if (!replaceFile( _tempPath, _filePath ))
+	{
+		return AnimationStatus::CannotWriteFile;
+	}
+
+	return AnimationStatus::Success;
+}
+
+void AnimationWriter::cancel() noexcept
+{
+	if (_file)
+	{
+		fclose( _file );
+		_file = nullptr;
+		remove( _tempPath.c_str() );
+	}
+}
+
+
+//======================================================================================================================
+//  AnimationPlayer
+
+static const uint32_t noFrame = UINT32_MAX;
+
+AnimationPlayer::AnimationPlayer() noexcept
+:
+	_file(),
+	_header( nullptr ),
+	_deviceLedCounts(),
+	_frames(),
+	_decoded(),
+	_decodedIdx( noFrame ),
+	_lastSystemError( 0 )
+{}
+
+AnimationPlayer::~AnimationPlayer() noexcept {}
+
+AnimationPlayer::AnimationPlayer( AnimationPlayer && other ) noexcept
+:
+	_file( move( other._file ) ),
+	_header( other._header ),
+	_deviceLedCounts( other._deviceLedCounts ),
+	_frames( other._frames ),
+	_decoded( move( other._decoded ) ),
+	_decodedIdx( other._decodedIdx ),
+	_lastSystemError( other._lastSystemError )
+{
+	other._header = nullptr;
+	other._deviceLedCounts = {};
+	other._frames = {};
+	other._decodedIdx = noFrame;
+}
+
+AnimationPlayer & AnimationPlayer::operator=( AnimationPlayer && other ) noexcept
+{
+	_file = move( other._file );
+	_header = other._header;
+	_deviceLedCounts = other._deviceLedCounts;
+	_frames = other._frames;
+	_decoded = move( other._decoded );
+	_decodedIdx = other._decodedIdx;
+	_lastSystemError = other._lastSystemError;
+	other._header = nullptr;
+	other._deviceLedCounts = {};
+	other._frames = {};
+	other._decodedIdx = noFrame;
+	return *this;
+}
+
+static AnimationStatus validateAnimation( const uint8_t * data, size_t size )
+{
+	if (size < sizeof(AnimationHeader) || (reinterpret_cast< uintptr_t >( data ) & (alignof(AnimationHeader) - 1)) != 0)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+
+	const AnimationHeader & header = *reinterpret_cast< const AnimationHeader * >( data );
+	if (memcmp( header.magic, animationMagic, sizeof(header.magic) ) != 0)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+	if (header.format_version != animationFormatVersion || header.byte_order != byteOrderMark)
+	{
+		return AnimationStatus::VersionNotSupported;
+	}
+	if (header.total_size < sizeof(AnimationHeader) || header.total_size > size)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+	uint64_t totalSize = header.total_size;
+
+	// the device table follows the header
+	uint64_t deviceTableEnd = sizeof(AnimationHeader) + uint64_t( header.device_count ) * sizeof(uint32_t);
+	if (deviceTableEnd > totalSize)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+	const uint32_t * deviceLedCounts = reinterpret_cast< const uint32_t * >( data + sizeof(AnimationHeader) );
+	uint64_t ledCount = 0;
+	for (uint32_t i = 0; i < header.device_count; ++i)
+		ledCount += deviceLedCounts[i];
+	if (ledCount != header.led_count)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+
+	if (header.frame_table_offset % alignof(AnimationFrameEntry) != 0
+	 || header.frame_table_offset > totalSize
+	 || uint64_t( header.frame_count ) * sizeof(AnimationFrameEntry) > totalSize - header.frame_table_offset)
+	{
+		return AnimationStatus::InvalidFormat;
+	}
+
+	// The content of delta frames is checked while they are applied, so that opening doesn't have to read
+	// the whole file. Here only the frames themselves must be in bounds.
+	const AnimationFrameEntry * frames = reinterpret_cast< const AnimationFrameEntry * >( data + header.frame_table_offset );
+	for (uint32_t i = 0; i < header.frame_count; ++i)
+	{
+		const AnimationFrameEntry & frame = frames[i];
+		if (frame.offset % alignof(Color) != 0 || frame.offset > totalSize || frame.size > totalSize - frame.offset)
+		{
+			return AnimationStatus::InvalidFormat;
+		}
+		if (frame.type == AnimationFrameType::Raw && frame.size != uint64_t( header.led_count ) * sizeof(Color))
+		{
+			return AnimationStatus::InvalidFormat;
+		}
+		if (frame.type != AnimationFrameType::Raw && frame.type != AnimationFrameType::Delta)
+		{
+			return AnimationStatus::InvalidFormat;
+		}
+	}
+
+	return AnimationStatus::Success;
+}
+
+AnimationStatus AnimationPlayer::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	std::unique_ptr< MappedFile > file( new (std::nothrow) MappedFile );
+	if (!file)
+	{
+		return AnimationStatus::UnexpectedError;
+	}
+
+	if (!file->open( filePath ))
+	{
+		_lastSystemError = file->getLastSystemError();
+		return AnimationStatus::CannotOpenFile;
+	}
+
+	AnimationStatus status = validateAnimation( file->data(), file->size() );
+	if (status != AnimationStatus::Success)
+	{
+		return status;
+	}
+
+	try
+	{
+		const uint8_t * data = file->data();
+		const AnimationHeader * header = reinterpret_cast< const AnimationHeader * >( data );
+		_decoded.assign( header->led_count, Color::Black );
+		_decodedIdx = noFrame;
+
+		_header = header;
+		_deviceLedCounts = Span< const uint32_t >(
+			reinterpret_cast< const uint32_t * >( data + sizeof(AnimationHeader) ), header->device_count
+		);
+		_frames = Span< const AnimationFrameEntry >(
+			reinterpret_cast< const AnimationFrameEntry * >( data + header->frame_table_offset ), header->frame_count
+		);
+		_file = move( file );
+		return AnimationStatus::Success;
+	}
+	catch (...)
+	{
+		close();
+		return AnimationStatus::UnexpectedError;
+	}
+}
+
+void AnimationPlayer::close() noexcept
+{
+	_header = nullptr;
+	_deviceLedCounts = {};
+	_frames = {};
+	_decodedIdx = noFrame;
+	_file.reset();
+}
+
+bool AnimationPlayer::matches( const DeviceList & devices ) const noexcept
+{
+	return _header && _header->layout_fingerprint == layoutFingerprint( devices );
+}
+
+void AnimationPlayer::applyDelta( const AnimationFrameEntry & entry ) noexcept
+{
+	const uint8_t * pos = _file->data() + entry.offset;
+	const uint8_t * end = pos + entry.size;
+	size_t ledCount = _decoded.size();
+
+	uint32_t run [2];
+	while (size_t( end - pos ) >= sizeof(run))
+	{
+		memcpy( run, pos, sizeof(run) );
+		pos += sizeof(run);
+
+		// a damaged run is ignored rather than reading or writing out of bounds
+		size_t runBytes = size_t( run[1] ) * sizeof(Color);
+		if (run[0] > ledCount || run[1] > ledCount - run[0] || runBytes > size_t( end - pos ))
+			return;
+
+		memcpy( _decoded.data() + run[0], pos, runBytes );
+		pos += runBytes;
+	}
+}
+
+Span< const Color > AnimationPlayer::frame( uint32_t frameIdx ) noexcept
+{
+	if (!_header || frameIdx >= _frames.size())
+	{
+		return {};
+	}
+
+	auto rawFrame = [ this ]( const AnimationFrameEntry & entry )
+	{
+		return Span< const Color >( reinterpret_cast< const Color * >( _file->data() + entry.offset ), _header->led_count );
+	};
+
+	// raw frames are sent straight from the mapping
+	if (_frames[ frameIdx ].type == AnimationFrameType::Raw)
+	{
+		return rawFrame( _frames[ frameIdx ] );
+	}
+
+	// continue from the already decoded frame if possible, otherwise from the nearest raw frame before
+	auto followsDecoded = [ this ]( uint32_t idx ) { return _decodedIdx != noFrame && idx == _decodedIdx + 1; };
+	uint32_t start = frameIdx;
+	while (start > 0 && _frames[ start ].type != AnimationFrameType::Raw && !followsDecoded( start ))
+	{
+		start--;
+	}
+	if (_frames[ start ].type != AnimationFrameType::Raw && !followsDecoded( start ))
+	{
+		// the first frame is always raw, so this only happens with a damaged file
+		fillColors( _decoded, Color::Black );
+	}
+
+	for (uint32_t i = start; i <= frameIdx; ++i)
+	{
+		const AnimationFrameEntry & entry = _frames[i];
+		if (entry.type == AnimationFrameType::Raw)
+			memcpy( _decoded.data(), _file->data() + entry.offset, entry.size );
+		else
+			applyDelta( entry );
+	}
+	_decodedIdx = frameIdx;
+
+	return _decoded;
+}
+
+RequestStatus AnimationPlayer::push( Client & client, const DeviceList & devices, uint32_t frameIdx ) noexcept
+{
+	Span< const Color > colors = frame( frameIdx );
+	if (colors.empty())
+	{
+		return RequestStatus::Success;
+	}
+
+	RequestStatus firstFailure = RequestStatus::Success;
+	size_t first = 0;
+	uint32_t deviceCount = uint32_t( std::min( devices.size(), _deviceLedCounts.size() ) );
+	for (uint32_t i = 0; i < deviceCount; ++i)
+	{
+		uint32_t count = _deviceLedCounts[i];
+		if (count > 0)
+		{
+			RequestStatus status = client.setDeviceColors( devices[i], colors.subspan( first, count ) );
+			if (status != RequestStatus::Success && firstFailure == RequestStatus::Success)
+				firstFailure = status;
+		}
+		first += count;
+	}
+	return firstFailure;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,120 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: 2D pixel grid mapped to the LEDs of a matrix zone
+//======================================================================================================================
+
+#include <OpenRGB/Canvas.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <OpenRGB/ColorKernels.hpp>
+
+#include <algorithm>  // min
+
+
+namespace orgb {
+
+
+constexpr uint32_t Canvas::NoLed;
+
+
+//======================================================================================================================
+
+void Canvas::reset( const Zone & zone )
+{
+	_ledCount = zone.leds_count;
+
+	bool isMatrix = zone.type == ZoneType::Matrix && zone.matrix_width > 0 && zone.matrix_height > 0;
+	if (isMatrix)
+	{
+		_width = zone.matrix_width;
+		_height = zone.matrix_height;
+	}
+	else
+	{
+		_width = zone.leds_count;
+		_height = _width > 0 ? 1 : 0;
+	}
+
+	size_t pixelCount = size_t( _width ) * _height;
+	uint32_t blackPixel = uint32_t( pixelCount );
+
+	_pixels.assign( pixelCount + 1, Color::Black );
+	_ledOfPixel.assign( pixelCount, NoLed );
+	_pixelOfLed.assign( _ledCount, blackPixel );
+	_ledColors.assign( _ledCount, Color::Black );
+
+	if (isMatrix)
+	{
+		// the server may send a map shorter than the matrix or with indexes outside of the zone, ignore those
+		size_t mapSize = std::min( pixelCount, zone.matrix_values.size() );
+		for (size_t pixelIdx = 0; pixelIdx < mapSize; ++pixelIdx)
+		{
+			uint32_t ledIdx = zone.matrix_values[ pixelIdx ];
+			if (ledIdx >= _ledCount)
+				continue;
+
+			_ledOfPixel[ pixelIdx ] = ledIdx;
+			// when more pixels cover the same LED (wide keys), the first one defines its color
+			if (_pixelOfLed[ ledIdx ] == blackPixel)
+				_pixelOfLed[ ledIdx ] = uint32_t( pixelIdx );
+		}
+	}
+	else
+	{
+		for (uint32_t ledIdx = 0; ledIdx < _ledCount; ++ledIdx)
+		{
+			_ledOfPixel[ ledIdx ] = ledIdx;
+			_pixelOfLed[ ledIdx ] = ledIdx;
+		}
+	}
+}
+
+void Canvas::clear( Color color ) noexcept
+{
+	fillColors( pixels(), color );
+}
+
+uint32_t Canvas::ledIndex( uint32_t x, uint32_t y ) const noexcept
+{
+	if (x >= _width || y >= _height)
+		return NoLed;
+	return _ledOfPixel[ size_t( y ) * _width + x ];
+}
+
+void Canvas::scatter( Span< Color > ledColors ) const noexcept
+{
+	// Iterating over the LEDs rather than the pixels makes the writes sequential and every LED written exactly once.
+	// The reads are random, but the whole canvas of a keyboard has only a few hundred bytes.
+	const Color * src = _pixels.data();
+	const uint32_t * pixelOfLed = _pixelOfLed.data();
+	Color * dst = ledColors.data();
+	size_t count = std::min( ledColors.size(), _pixelOfLed.size() );
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i] = src[ pixelOfLed[i] ];
+	}
+}
+
+void Canvas::gather( Span< const Color > ledColors ) noexcept
+{
+	size_t pixelCount = _ledOfPixel.size();
+	for (size_t i = 0; i < pixelCount; ++i)
+	{
+		uint32_t ledIdx = _ledOfPixel[i];
+		_pixels[i] = ledIdx < ledColors.size() ? ledColors[ ledIdx ] : Color::Black;
+	}
+}
+
+Span< const Color > Canvas::ledColors() noexcept
+{
+	scatter( _ledColors );
+	return _ledColors;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -10,6 +10,10 @@
 
 #include <OpenRGB/Exceptions.hpp>
 #include "ProtocolMessages.hpp"
+#include "CorrectionRegistry.hpp"
+#include "StateMirror.hpp"
+#include "MiscUtils.hpp"
+#include <OpenRGB/TrafficLog.hpp>
 
 #include <CppUtils-Network/Socket.hpp>
 using own::TcpSocket;
@@ -36,6 +40,8 @@ using std::vector;
 using std::array;
 #include <chrono>
 using std::chrono::milliseconds;
+#include <algorithm>  // min, max, find
+#include <cstring>    // memcmp
 
 
 namespace orgb {
@@ -82,6 +88,7 @@ const char * enumString( RequestStatus status ) noexcept
 		"No reply has arrived from the server in given timeout.",
 		"There has been some other error while trying to receive a reply.",
 		"The reply from the server is invalid.",
+		"The request was cancelled.",
 		"Internal error of this library. Please create a github issue.",
 	};
 	static_assert( size_t(RequestStatus::UnexpectedError) + 1 == fut::size(RequestStatusStr), "update the RequestStatusStr" );
@@ -102,6 +109,7 @@ const char * enumString( UpdateStatus status ) noexcept
 	{
 		"The current device list seems up to date.",
 		"Server has sent a notification message indicating that the device list has changed.",
+		"The client is not connected.",
 		"Server has closed the connection.",
 		"Server has sent some other kind of message that we didn't expect.",
 		"Error has occured while trying to restore socket to its original state and the socket has been closed.",
@@ -129,11 +137,21 @@ Client::Client( const std::string & clientName ) noexcept
 	_clientName( clientName ),
 	_socket( new TcpSocket ),
 	_negotiatedProtocolVersion( 0 ),
-	_isDeviceListOutOfDate( true )
+	_isDeviceListOutOfDate( true ),
+	_timeout( 500 ),  // rather set some default timeout for recv operations, user can always override this
+	_socketTimeout( 0 ),
+	_colorCorrections( new CorrectionRegistry ),
+	_headerReceived( 0 ),
+	_bodyToSkip( 0 ),
+	_trafficRecorder( nullptr ),
+	_batching( false )
 {}
 
 Client::~Client() noexcept {}
 
+Client::Client( Client && other ) noexcept = default;
+Client & Client::operator=( Client && other ) noexcept = default;
+
 bool Client::isConnected() const noexcept
 {
 	return _socket->isConnected();
@@ -154,8 +172,13 @@ ConnectStatus Client::_connect( const std::string & host, uint16_t port )
 		}
 	}
 
-	// rather set some default timeout for recv operations, user can always override this
-	_socket->setTimeout( milliseconds( 500 ) );
+	_socket->setTimeout( _timeout );
+	_socketTimeout = _timeout;
+
+	// whatever was abandoned on the previous connection is gone
+	_headerReceived = 0;
+	_bodyToSkip = 0;
+	_abandonedReplies.clear();
 
 	bool sendVersionRes = sendMessage< RequestProtocolVersion >( implementedProtocolVersion );
 	if (!sendVersionRes)
@@ -164,7 +187,7 @@ ConnectStatus Client::_connect( const std::string & host, uint16_t port )
 		return ConnectStatus::RequestVersionFailed;
 	}
 
-	auto requestVersionRes = awaitMessage< ReplyProtocolVersion >();
+	auto requestVersionRes = awaitMessage< ReplyProtocolVersion >( RequestLimits() );
 	if (requestVersionRes.status != RequestStatus::Success)
 	{
 		_socket->disconnect();  // revert to the state before this function was called
@@ -221,17 +244,23 @@ bool Client::_disconnect() noexcept
 
 bool Client::_setTimeout( std::chrono::milliseconds timeout ) noexcept
 {
-	// Currently we cannot set timeout on a socket that is not connected, because the actual system socket is created
-	// during connect operation, so the preceeding setTimeout calls would go to nowhere.
+	_timeout = timeout;
+
+	// The actual system socket is created during connect operation, which applies the stored timeout.
 	if (!_socket->isConnected())
 	{
-		return false;
+		return true;
 	}
 
-	return _socket->setTimeout( timeout );
+	if (!_socket->setTimeout( timeout ))
+	{
+		return false;
+	}
+	_socketTimeout = timeout;
+	return true;
 }
 
-DeviceListResult Client::_requestDeviceList()
+DeviceListResult Client::_requestDeviceList( const RequestLimits & limits )
 {
 	if (!_socket->isConnected())
 	{
@@ -252,7 +281,7 @@ DeviceListResult Client::_requestDeviceList()
 			return result;
 		}
 
-		auto deviceCountResult = awaitMessage< ReplyControllerCount >();
+		auto deviceCountResult = awaitMessage< ReplyControllerCount >( limits );
 		if (deviceCountResult.status != RequestStatus::Success)
 		{
 			result.status = deviceCountResult.status;
@@ -268,7 +297,7 @@ DeviceListResult Client::_requestDeviceList()
 				return result;
 			}
 
-			auto deviceDataResult = awaitMessage< ReplyControllerData >();
+			auto deviceDataResult = awaitMessage< ReplyControllerData >( limits );
 			if (deviceDataResult.status != RequestStatus::Success)
 			{
 				result.status = deviceDataResult.status;
@@ -281,11 +310,16 @@ DeviceListResult Client::_requestDeviceList()
 	// In the middle of the update we might receive DeviceListUpdated message. In that case we need to start again.
 	while (_isDeviceListOutOfDate);
 
+	if (_stateMirror)
+	{
+		_stateMirror->seed( result.devices );
+	}
+
 	result.status = RequestStatus::Success;
 	return result;
 }
 
-DeviceCountResult Client::_requestDeviceCount()
+DeviceCountResult Client::_requestDeviceCount( const RequestLimits & limits )
 {
 	if (!_socket->isConnected())
 	{
@@ -301,7 +335,7 @@ DeviceCountResult Client::_requestDeviceCount()
 		return result;
 	}
 
-	auto deviceCountResult = awaitMessage< ReplyControllerCount >();
+	auto deviceCountResult = awaitMessage< ReplyControllerCount >( limits );
 	if (deviceCountResult.status != RequestStatus::Success)
 	{
 		result.status = deviceCountResult.status;
@@ -313,7 +347,7 @@ DeviceCountResult Client::_requestDeviceCount()
 	return result;
 }
 
-DeviceInfoResult Client::_requestDeviceInfo( uint32_t deviceIdx )
+DeviceInfoResult Client::_requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits )
 {
 	if (!_socket->isConnected())
 	{
@@ -329,7 +363,7 @@ DeviceInfoResult Client::_requestDeviceInfo( uint32_t deviceIdx )
 		return result;
 	}
 
-	auto deviceDataResult = awaitMessage< ReplyControllerData >();
+	auto deviceDataResult = awaitMessage< ReplyControllerData >( limits );
 	if (deviceDataResult.status != RequestStatus::Success)
 	{
 		result.status = deviceDataResult.status;
@@ -337,10 +371,67 @@ DeviceInfoResult Client::_requestDeviceInfo( uint32_t deviceIdx )
 	}
 
 	result.device.reset( new Device( move( deviceDataResult.message.device_desc ) ) );
+	if (_stateMirror)
+	{
+		_stateMirror->seed( *result.device );
+	}
 	result.status = RequestStatus::Success;
 	return result;
 }
 
+DeviceChangeResult Client::_requestDeviceInfoIfChanged( uint32_t deviceIdx, const RequestLimits & limits )
+{
+	if (!_socket->isConnected())
+	{
+		return { RequestStatus::NotConnected, false, nullptr };
+	}
+
+	DeviceChangeResult result;
+	result.changed = false;
+
+	bool sent = sendMessage< RequestControllerData >( deviceIdx, _negotiatedProtocolVersion );
+	if (!sent)
+	{
+		result.status = RequestStatus::SendRequestFailed;
+		return result;
+	}
+
+	ReplyControllerData reply;
+	result.status = awaitMessageBody( ReplyControllerData::thisType, reply.header, limits );
+	if (result.status != RequestStatus::Success)
+	{
+		return result;
+	}
+
+	if (deviceIdx >= _deviceInfoHashes.size())
+	{
+		_deviceInfoHashes.resize( size_t( deviceIdx ) + 1, { false, 0 } );
+	}
+	PayloadHash & lastHash = _deviceInfoHashes[ deviceIdx ];
+	uint64_t hash = hashBytes( _recvBuffer.data(), _recvBuffer.size() );
+	if (lastHash.valid && lastHash.value == hash)
+	{
+		return result;
+	}
+
+	BinaryInputStream stream( _recvBuffer );
+	if (!reply.deserializeBody( stream, _negotiatedProtocolVersion ))
+	{
+		result.status = RequestStatus::InvalidReply;
+		return result;
+	}
+	// only a successfully parsed reply can be used to skip the next ones
+	lastHash = { true, hash };
+
+	result.device.reset( new Device( move( reply.device_desc ) ) );
+	if (_stateMirror)
+	{
+		_stateMirror->seed( *result.device );
+	}
+	result.changed = true;
+	return result;
+}
+
 UpdateStatus Client::_checkForDeviceUpdates() noexcept
 {
 	if (_isDeviceListOutOfDate)
@@ -351,14 +442,18 @@ UpdateStatus Client::_checkForDeviceUpdates() noexcept
 	}
 
 	// Last time we checked there wasn't any DeviceListUpdated message, but it already might be now, so let's check.
-	UpdateStatus status = checkForUpdateMessageArrival();
-	if (status == UpdateStatus::OutOfDate)
+	// When it's found, the discovery is cached in _isDeviceListOutOfDate until user calls requestDeviceList().
+	return checkForUpdateMessageArrival();
+}
+
+UpdateStatus Client::processNotifications() noexcept
+{
+	if (!_socket->isConnected())
 	{
-		// DeviceListUpdated message found, cache this discovery until user calls requestDeviceList().
-		_isDeviceListOutOfDate = true;
+		return UpdateStatus::NotConnected;
 	}
 
-	return status;
+	return checkForUpdateMessageArrival();
 }
 
 RequestStatus Client::_switchToCustomMode( const Device & device )
@@ -376,29 +471,34 @@ RequestStatus Client::_switchToCustomMode( const Device & device )
 	return RequestStatus::Success;
 }
 
-RequestStatus Client::_changeMode( const Device & device, const Mode & mode )
+RequestStatus Client::_changeMode( const Device & device, const Mode & mode, const ModeParams & params )
 {
 	if (!_socket->isConnected())
 	{
 		return RequestStatus::NotConnected;
 	}
 
-	if (!sendMessage< UpdateMode >( device.idx, mode.idx, mode, _negotiatedProtocolVersion ))
+	if (!sendMessage< UpdateMode >( device.idx, mode.idx, mode, params, _negotiatedProtocolVersion ))
 	{
 		return RequestStatus::SendRequestFailed;
 	}
 
+	if (_stateMirror)
+	{
+		_stateMirror->setActiveMode( device.idx, mode.idx );
+	}
+
 	return RequestStatus::Success;
 }
 
-RequestStatus Client::_saveMode( const Device & device, const Mode & mode )
+RequestStatus Client::_saveMode( const Device & device, const Mode & mode, const ModeParams & params )
 {
 	if (!_socket->isConnected())
 	{
 		return RequestStatus::NotConnected;
 	}
 
-	if (!sendMessage< SaveMode >( device.idx, mode.idx, mode, _negotiatedProtocolVersion ))
+	if (!sendMessage< SaveMode >( device.idx, mode.idx, mode, params, _negotiatedProtocolVersion ))
 	{
 		return RequestStatus::SendRequestFailed;
 	}
@@ -413,12 +513,17 @@ RequestStatus Client::_setDeviceColor( const Device & device, Color color )
 		return RequestStatus::NotConnected;
 	}
 
-	std::vector< Color > allColorsInDevice( device.leds.size(), color );
-	if (!sendMessage< UpdateLEDs >( device.idx, allColorsInDevice ))
+	auto corrections = _colorCorrections->makeSegments( device );
+	if (!sendMessage< UpdateLEDs >( device.idx, color, uint32_t( device.leds.size() ), corrections ))
 	{
 		return RequestStatus::SendRequestFailed;
 	}
 
+	if (_stateMirror)
+	{
+		_stateMirror->setDeviceColor( device.idx, color );
+	}
+
 	return RequestStatus::Success;
 }
 
@@ -429,12 +534,66 @@ RequestStatus Client::_setZoneColor( const Zone & zone, Color color )
 		return RequestStatus::NotConnected;
 	}
 
-	std::vector< Color > allColorsInZone( zone.leds_count, color );
-	if (!sendMessage< UpdateZoneLEDs >( zone.parentIdx, zone.idx, allColorsInZone ))
+	// the whole zone has the same color, so it can be corrected right away
+	Color sentColor = color;
+	const ColorCorrection * correction = _colorCorrections->find( zone.parentIdx, zone.idx );
+	if (correction)
+	{
+		sentColor = correction->apply( color );
+	}
+
+	if (!sendMessage< UpdateZoneLEDs >( zone.parentIdx, zone.idx, sentColor, zone.leds_count ))
 	{
 		return RequestStatus::SendRequestFailed;
 	}
 
+	if (_stateMirror)
+	{
+		_stateMirror->setZoneColor( zone.parentIdx, zone.idx, color );
+	}
+
+	return RequestStatus::Success;
+}
+
+RequestStatus Client::_setDeviceColors( const Device & device, Span< const Color > colors )
+{
+	if (!_socket->isConnected())
+	{
+		return RequestStatus::NotConnected;
+	}
+
+	auto corrections = _colorCorrections->makeSegments( device );
+	if (!sendMessage< UpdateLEDs >( device.idx, colors, corrections ))
+	{
+		return RequestStatus::SendRequestFailed;
+	}
+
+	if (_stateMirror)
+	{
+		_stateMirror->setDeviceColors( device.idx, colors );
+	}
+
+	return RequestStatus::Success;
+}
+
+RequestStatus Client::_setZoneColors( const Zone & zone, Span< const Color > colors )
+{
+	if (!_socket->isConnected())
+	{
+		return RequestStatus::NotConnected;
+	}
+
+	auto corrections = _colorCorrections->makeSegments( zone, colors.size() );
+	if (!sendMessage< UpdateZoneLEDs >( zone.parentIdx, zone.idx, colors, corrections ))
+	{
+		return RequestStatus::SendRequestFailed;
+	}
+
+	if (_stateMirror)
+	{
+		_stateMirror->setZoneColors( zone.parentIdx, zone.idx, colors );
+	}
+
 	return RequestStatus::Success;
 }
 
@@ -460,15 +619,27 @@ RequestStatus Client::_setLEDColor( const LED & led, Color color )
 		return RequestStatus::NotConnected;
 	}
 
-	if (!sendMessage< UpdateSingleLED >( led.parentIdx, led.idx, color ))
+	Color sentColor = color;
+	const ColorCorrection * correction = _colorCorrections->find( led.parentIdx );
+	if (correction)
+	{
+		sentColor = correction->apply( color );
+	}
+
+	if (!sendMessage< UpdateSingleLED >( led.parentIdx, led.idx, sentColor ))
 	{
 		return RequestStatus::SendRequestFailed;
 	}
 
+	if (_stateMirror)
+	{
+		_stateMirror->setLEDColor( led.parentIdx, led.idx, color );
+	}
+
 	return RequestStatus::Success;
 }
 
-ProfileListResult Client::_requestProfileList()
+ProfileListResult Client::_requestProfileList( const RequestLimits & limits )
 {
 	if (!_socket->isConnected())
 	{
@@ -484,7 +655,7 @@ ProfileListResult Client::_requestProfileList()
 		return result;
 	}
 
-	auto deviceDataResult = awaitMessage< ReplyProfileList >();
+	auto deviceDataResult = awaitMessage< ReplyProfileList >( limits );
 	if (deviceDataResult.status != RequestStatus::Success)
 	{
 		result.status = deviceDataResult.status;
@@ -541,6 +712,72 @@ RequestStatus Client::_deleteProfile( const std::string & profileName )
 	return RequestStatus::Success;
 }
 
+void Client::setColorCorrection( const Device & device, const ColorCorrection & correction )
+{
+	_colorCorrections->set( device.idx, correction );
+}
+
+void Client::setColorCorrection( const Zone & zone, const ColorCorrection & correction )
+{
+	_colorCorrections->set( zone.parentIdx, zone.idx, correction );
+}
+
+void Client::removeColorCorrection( const Device & device ) noexcept
+{
+	_colorCorrections->remove( device.idx );
+}
+
+void Client::removeColorCorrection( const Zone & zone ) noexcept
+{
+	_colorCorrections->remove( zone.parentIdx, zone.idx );
+}
+
+void Client::clearColorCorrections() noexcept
+{
+	_colorCorrections->clear();
+}
+
+void Client::setTrafficRecorder( TrafficRecorder * recorder ) noexcept
+{
+	_trafficRecorder = recorder;
+}
+
+void Client::addNotificationListener( NotificationListener * listener )
+{
+	_listeners.push_back( listener );
+}
+
+void Client::removeNotificationListener( NotificationListener * listener ) noexcept
+{
+	_listeners.erase( std::remove( _listeners.begin(), _listeners.end(), listener ), _listeners.end() );
+}
+
+void Client::enableStateMirror( bool enable )
+{
+	if (!enable)
+		_stateMirror.reset();
+	else if (!_stateMirror)
+		_stateMirror = make_unique< StateMirror >();
+}
+
+void Client::seedStateMirror( const DeviceList & devices )
+{
+	if (_stateMirror)
+	{
+		_stateMirror->seed( devices );
+	}
+}
+
+DeviceState Client::mirroredState( const Device & device ) const noexcept
+{
+	const StateMirror::DeviceEntry * entry = _stateMirror ? _stateMirror->find( device.idx ) : nullptr;
+	if (!entry)
+	{
+		return { device.active_mode, makeSpan( device.colors ) };
+	}
+	return { entry->activeMode, makeSpan( entry->colors ) };
+}
+
 system_error_t Client::getLastSystemError() const noexcept
 {
 	return _socket->getLastSystemError();
@@ -560,15 +797,6 @@ string Client::getSystemErrorStr( system_error_t errorCode ) const noexcept
 //======================================================================================================================
 //  Client: exception-less wrappers of the API
 
-#define CATCH_ALL( ... ) \
-	catch (const std::exception & ex) { \
-		fprintf( stderr, "Unexpected std::exception was thrown: %s\n", ex.what() ); \
-		__VA_ARGS__ \
-	} catch (...) { \
-		fprintf( stderr, "Unexpected unknown exception was thrown\n" ); \
-		__VA_ARGS__ \
-	}
-
 ConnectStatus Client::connect( const std::string & host, uint16_t port ) noexcept
 {
 	try {
@@ -593,32 +821,61 @@ bool Client::setTimeout( std::chrono::milliseconds timeout ) noexcept
 }
 
 DeviceListResult Client::requestDeviceList() noexcept
+{
+	return requestDeviceList( RequestLimits() );
+}
+
+DeviceListResult Client::requestDeviceList( const RequestLimits & limits ) noexcept
 {
 	try {
-		return _requestDeviceList();
+		return _requestDeviceList( limits );
 	} CATCH_ALL (
 		return { RequestStatus::UnexpectedError, {} };
 	)
 }
 
 DeviceCountResult Client::requestDeviceCount() noexcept
+{
+	return requestDeviceCount( RequestLimits() );
+}
+
+DeviceCountResult Client::requestDeviceCount( const RequestLimits & limits ) noexcept
 {
 	try {
-		return _requestDeviceCount();
+		return _requestDeviceCount( limits );
 	} CATCH_ALL (
 		return { RequestStatus::UnexpectedError, 0 };
 	)
 }
 
 DeviceInfoResult Client::requestDeviceInfo( uint32_t deviceIdx ) noexcept
+{
+	return requestDeviceInfo( deviceIdx, RequestLimits() );
+}
+
+DeviceInfoResult Client::requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits ) noexcept
 {
 	try {
-		return _requestDeviceInfo( deviceIdx );
+		return _requestDeviceInfo( deviceIdx, limits );
 	} CATCH_ALL (
 		return { RequestStatus::UnexpectedError, {} };
 	)
 }
 
+DeviceChangeResult Client::requestDeviceInfoIfChanged( uint32_t deviceIdx ) noexcept
+{
+	return requestDeviceInfoIfChanged( deviceIdx, RequestLimits() );
+}
+
+DeviceChangeResult Client::requestDeviceInfoIfChanged( uint32_t deviceIdx, const RequestLimits & limits ) noexcept
+{
+	try {
+		return _requestDeviceInfoIfChanged( deviceIdx, limits );
+	} CATCH_ALL (
+		return { RequestStatus::UnexpectedError, false, nullptr };
+	)
+}
+
 UpdateStatus Client::checkForDeviceUpdates() noexcept
 {
 	return _checkForDeviceUpdates();
@@ -636,7 +893,16 @@ RequestStatus Client::switchToCustomMode( const Device & device ) noexcept
 RequestStatus Client::changeMode( const Device & device, const Mode & mode ) noexcept
 {
 	try {
-		return _changeMode( device, mode );
+		return _changeMode( device, mode, ModeParams( mode ) );
+	} CATCH_ALL (
+		return RequestStatus::UnexpectedError;
+	)
+}
+
+RequestStatus Client::changeMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept
+{
+	try {
+		return _changeMode( device, mode, params );
 	} CATCH_ALL (
 		return RequestStatus::UnexpectedError;
 	)
@@ -645,7 +911,16 @@ RequestStatus Client::changeMode( const Device & device, const Mode & mode ) noe
 RequestStatus Client::saveMode( const Device & device, const Mode & mode ) noexcept
 {
 	try {
-		return _saveMode( device, mode );
+		return _saveMode( device, mode, ModeParams( mode ) );
+	} CATCH_ALL (
+		return RequestStatus::UnexpectedError;
+	)
+}
+
+RequestStatus Client::saveMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept
+{
+	try {
+		return _saveMode( device, mode, params );
 	} CATCH_ALL (
 		return RequestStatus::UnexpectedError;
 	)
@@ -669,6 +944,24 @@ RequestStatus Client::setZoneColor( const Zone & zone, Color color ) noexcept
 	)
 }
 
+RequestStatus Client::setDeviceColors( const Device & device, Span< const Color > colors ) noexcept
+{
+	try {
+		return _setDeviceColors( device, colors );
+	} CATCH_ALL (
+		return RequestStatus::UnexpectedError;
+	)
+}
+
+RequestStatus Client::setZoneColors( const Zone & zone, Span< const Color > colors ) noexcept
+{
+	try {
+		return _setZoneColors( zone, colors );
+	} CATCH_ALL (
+		return RequestStatus::UnexpectedError;
+	)
+}
+
 RequestStatus Client::setZoneSize( const Zone & zone, uint32_t newSize ) noexcept
 {
 	try {
@@ -688,9 +981,14 @@ RequestStatus Client::setLEDColor( const LED & led, Color color ) noexcept
 }
 
 ProfileListResult Client::requestProfileList()
+{
+	return requestProfileList( RequestLimits() );
+}
+
+ProfileListResult Client::requestProfileList( const RequestLimits & limits )
 {
 	try {
-		return _requestProfileList();
+		return _requestProfileList( limits );
 	} CATCH_ALL (
 		return { RequestStatus::UnexpectedError, {} };
 	)
@@ -755,6 +1053,7 @@ void Client::requestStatusToException( RequestStatus status )
 		case RequestStatus::Success:
 			return;
 		case RequestStatus::NotConnected:
+		case RequestStatus::Cancelled:
 			throw UserError( enumString( status ) );
 		case RequestStatus::SendRequestFailed:
 		case RequestStatus::ConnectionClosed:
@@ -766,6 +1065,24 @@ void Client::requestStatusToException( RequestStatus status )
 	}
 }
 
+bool Client::updateStatusToException( UpdateStatus status )
+{
+	switch (status)
+	{
+		case UpdateStatus::UpToDate:
+			return false;
+		case UpdateStatus::OutOfDate:
+			return true;
+		case UpdateStatus::NotConnected:
+			throw UserError( enumString( status ) );
+		case UpdateStatus::ConnectionClosed:
+		case UpdateStatus::UnexpectedMessage:
+			throw ConnectionError( enumString( status ), getLastSystemError() );
+		default:
+			throw SystemError( enumString( status ), getLastSystemError() );
+	}
+}
+
 void Client::connectX( const std::string & host, uint16_t port )
 {
 	ConnectStatus status = _connect( host, port );
@@ -790,21 +1107,48 @@ void Client::setTimeoutX( std::chrono::milliseconds timeout )
 
 DeviceList Client::requestDeviceListX()
 {
-	DeviceListResult result = _requestDeviceList();
+	return requestDeviceListX( RequestLimits() );
+}
+
+DeviceList Client::requestDeviceListX( const RequestLimits & limits )
+{
+	DeviceListResult result = _requestDeviceList( limits );
 	requestStatusToException( result.status );
 	return move( result.devices );
 }
 
 uint32_t Client::requestDeviceCountX()
 {
-	DeviceCountResult result = _requestDeviceCount();
+	return requestDeviceCountX( RequestLimits() );
+}
+
+uint32_t Client::requestDeviceCountX( const RequestLimits & limits )
+{
+	DeviceCountResult result = _requestDeviceCount( limits );
 	requestStatusToException( result.status );
 	return result.count;
 }
 
 std::unique_ptr< Device > Client::requestDeviceInfoX( uint32_t deviceIdx )
 {
-	DeviceInfoResult result = _requestDeviceInfo( deviceIdx );
+	return requestDeviceInfoX( deviceIdx, RequestLimits() );
+}
+
+std::unique_ptr< Device > Client::requestDeviceInfoX( uint32_t deviceIdx, const RequestLimits & limits )
+{
+	DeviceInfoResult result = _requestDeviceInfo( deviceIdx, limits );
+	requestStatusToException( result.status );
+	return move( result.device );
+}
+
+std::unique_ptr< Device > Client::requestDeviceInfoIfChangedX( uint32_t deviceIdx )
+{
+	return requestDeviceInfoIfChangedX( deviceIdx, RequestLimits() );
+}
+
+std::unique_ptr< Device > Client::requestDeviceInfoIfChangedX( uint32_t deviceIdx, const RequestLimits & limits )
+{
+	DeviceChangeResult result = _requestDeviceInfoIfChanged( deviceIdx, limits );
 	requestStatusToException( result.status );
 	return move( result.device );
 }
@@ -812,18 +1156,13 @@ std::unique_ptr< Device > Client::requestDeviceInfoX( uint32_t deviceIdx )
 bool Client::isDeviceListOutdatedX()
 {
 	UpdateStatus status = _checkForDeviceUpdates();
-	switch (status)
-	{
-		case UpdateStatus::UpToDate:
-			return false;
-		case UpdateStatus::OutOfDate:
-			return true;
-		case UpdateStatus::ConnectionClosed:
-		case UpdateStatus::UnexpectedMessage:
-			throw ConnectionError( enumString( status ), getLastSystemError() );
-		default:
-			throw SystemError( enumString( status ), getLastSystemError() );
-	}
+	return updateStatusToException( status );
+}
+
+bool Client::processNotificationsX()
+{
+	UpdateStatus status = processNotifications();
+	return updateStatusToException( status );
 }
 
 void Client::switchToCustomModeX( const Device & device )
@@ -834,13 +1173,25 @@ void Client::switchToCustomModeX( const Device & device )
 
 void Client::changeModeX( const Device & device, const Mode & mode )
 {
-	RequestStatus status = _changeMode( device, mode );
+	RequestStatus status = _changeMode( device, mode, ModeParams( mode ) );
+	requestStatusToException( status );
+}
+
+void Client::changeModeX( const Device & device, const Mode & mode, const ModeParams & params )
+{
+	RequestStatus status = _changeMode( device, mode, params );
 	requestStatusToException( status );
 }
 
 void Client::saveModeX( const Device & device, const Mode & mode )
 {
-	RequestStatus status = _saveMode( device, mode );
+	RequestStatus status = _saveMode( device, mode, ModeParams( mode ) );
+	requestStatusToException( status );
+}
+
+void Client::saveModeX( const Device & device, const Mode & mode, const ModeParams & params )
+{
+	RequestStatus status = _saveMode( device, mode, params );
 	requestStatusToException( status );
 }
 
@@ -856,6 +1207,18 @@ void Client::setZoneColorX( const Zone & zone, Color color )
 	requestStatusToException( status );
 }
 
+void Client::setDeviceColorsX( const Device & device, Span< const Color > colors )
+{
+	RequestStatus status = _setDeviceColors( device, colors );
+	requestStatusToException( status );
+}
+
+void Client::setZoneColorsX( const Zone & zone, Span< const Color > colors )
+{
+	RequestStatus status = _setZoneColors( zone, colors );
+	requestStatusToException( status );
+}
+
 void Client::setZoneSizeX( const Zone & zone, uint32_t newSize )
 {
 	RequestStatus status = _setZoneSize( zone, newSize );
@@ -870,7 +1233,12 @@ void Client::setLEDColorX( const LED & led, Color color )
 
 std::vector< std::string > Client::requestProfileListX()
 {
-	ProfileListResult result = _requestProfileList();
+	return requestProfileListX( RequestLimits() );
+}
+
+std::vector< std::string > Client::requestProfileListX( const RequestLimits & limits )
+{
+	ProfileListResult result = _requestProfileList( limits );
 	requestStatusToException( result.status );
 	return move( result.profiles );
 }
@@ -904,87 +1272,263 @@ bool Client::sendMessage( ConstructorArgs ... args )
 {
 	Message message( args ... );
 
-	// allocate buffer and serialize (header.message_size is calculated in constructor)
-	std::vector< uint8_t > buffer( message.header.size() + message.header.message_size );
-	BinaryOutputStream stream( buffer );
-	message.serialize( stream, _negotiatedProtocolVersion );
+	// prepare buffer and serialize (header.message_size is calculated in constructor)
+	// The buffer is reused, so after the first few messages it has enough capacity and no more allocations are needed.
+	_sendBuffer.resize( message.header.size() + message.header.message_size );
+	protocol::serializeMessage( message, _sendBuffer.data(), _sendBuffer.size(), _negotiatedProtocolVersion );
+
+	if (_trafficRecorder)
+		_trafficRecorder->record( TrafficDirection::Sent, _sendBuffer );
+
+	if (_batching)
+	{
+		_batchBuffer.insert( _batchBuffer.end(), _sendBuffer.begin(), _sendBuffer.end() );
+		return true;
+	}
 
-	return _socket->send( buffer ) == SocketError::Success;
+	return _socket->send( _sendBuffer ) == SocketError::Success;
+}
+
+void Client::beginBatch() noexcept
+{
+	_batching = true;
+	_batchBuffer.clear();
+}
+
+RequestStatus Client::endBatch() noexcept
+{
+	_batching = false;
+	if (_batchBuffer.empty())
+	{
+		return RequestStatus::Success;
+	}
+
+	SocketError status = _socket->send( _batchBuffer );
+	_batchBuffer.clear();  // keeps the capacity for the next batch
+	return status == SocketError::Success ? RequestStatus::Success : RequestStatus::SendRequestFailed;
 }
 
 template< typename Message >
-Client::RecvResult< Message > Client::awaitMessage() noexcept
+Client::RecvResult< Message > Client::awaitMessage( const RequestLimits & limits ) noexcept
 {
 	RecvResult< Message > result;
 
-	do
+	result.status = awaitMessageBody( Message::thisType, result.message.header, limits );
+	if (result.status != RequestStatus::Success)
+	{
+		return result;
+	}
+
+	// parse and validate the body
+	BinaryInputStream stream( _recvBuffer );
+	if (!result.message.deserializeBody( stream, _negotiatedProtocolVersion ))
+	{
+		result.status = RequestStatus::InvalidReply;
+	}
+
+	return result;
+}
+
+RequestStatus Client::awaitMessageBody( MessageType expectedType, Header & header, const RequestLimits & limits ) noexcept
+{
+	RequestStatus status;
+	while (true)
 	{
-		// receive header into buffer
-		array< uint8_t, Header::size() > headerBuffer; size_t received;
-		SocketError headerStatus = _socket->receive( headerBuffer, received );
-		if (headerStatus != SocketError::Success)
+		// the rest of a message thrown away by a previous request comes first
+		status = skipUnwantedBody( limits );
+		if (status != RequestStatus::Success)
+			break;
+
+		status = receiveHeader( header, limits );
+		if (status != RequestStatus::Success)
+			break;
+
+		// the server may have sent DeviceListUpdated messsage before it received our request
+		if (header.message_type == MessageType::DEVICE_LIST_UPDATED)
 		{
-			if (headerStatus == SocketError::ConnectionClosed)
-				result.status = RequestStatus::ConnectionClosed;
-			else if (headerStatus == SocketError::Timeout)
-				result.status = RequestStatus::NoReply;
-			else
-				result.status = RequestStatus::ReceiveError;
-			return result;
+			// in that case just set our "out of date" flag and skip it for now
+			_isDeviceListOutOfDate = true;
+			if (_trafficRecorder)
+				_trafficRecorder->record( TrafficDirection::Received, _headerBuffer );
+			notifyListeners( header );
+			continue;
 		}
 
-		// parse and validate the header
-		BinaryInputStream stream( headerBuffer );
-		if (!result.message.header.deserialize( stream ))
+		// a notification added in a newer protocol version
+		if (!isValidMessageType( header.message_type ))
 		{
-			result.status = RequestStatus::InvalidReply;
-			return result;
+			notifyListeners( header );
+			_bodyToSkip = header.message_size;
+			continue;
 		}
 
-		// the server may have sent DeviceListUpdated messsage before it received our request
-		if (result.message.header.message_type == MessageType::DEVICE_LIST_UPDATED)
+		// The replies to the requests that gave up waiting come before ours. Anything else we haven't asked for
+		// is thrown away too, its size tells us where the next message begins.
+		if (takeAbandonedReply( header.message_type ) || header.message_type != expectedType)
 		{
-			// in that case just set our "out of date" flag and skip it for now
-			_isDeviceListOutOfDate = true;
+			_bodyToSkip = header.message_size;
+			continue;
 		}
-	}
-	while (result.message.header.message_type == MessageType::DEVICE_LIST_UPDATED);
 
-	if (result.message.header.message_type != Message::thisType)
+		break;
+	}
+	if (status != RequestStatus::Success)
 	{
-		// the message is neither DeviceListUpdated, nor the type we expected
-		result.status = RequestStatus::InvalidReply;
-		return result;
+		if (status == RequestStatus::NoReply || status == RequestStatus::Cancelled)
+			_abandonedReplies.push_back( expectedType );  // our reply is still on the way, the next request will skip it
+		return status;
 	}
 
 	// receive the message body
-	vector< uint8_t > bodyBuffer;
-	SocketError bodyStatus = _socket->receive( bodyBuffer, result.message.header.message_size );
-	if (bodyStatus != SocketError::Success)
-	{
-		if (bodyStatus == SocketError::ConnectionClosed)
-			result.status = RequestStatus::ConnectionClosed;
-		else if (bodyStatus == SocketError::Timeout)
-			result.status = RequestStatus::NoReply;
-		else
-			result.status = RequestStatus::ReceiveError;
-		return result;
+	_recvBuffer.resize( header.message_size );
+	size_t received = 0;
+	status = receiveBytes( _recvBuffer.data(), _recvBuffer.size(), received, limits );
+	if (status != RequestStatus::Success)
+	{
+		_bodyToSkip = header.message_size - received;  // the next request will skip the rest
+		return status;
 	}
 
-	// parse and validate the body
-	BinaryInputStream stream( bodyBuffer );
-	if (!result.message.deserializeBody( stream, _negotiatedProtocolVersion ))
+	if (_trafficRecorder)
+		_trafficRecorder->record( TrafficDirection::Received, _headerBuffer, _recvBuffer );
+
+	return RequestStatus::Success;
+}
+
+/// How often a request waiting for a reply looks at its cancellation token.
+static const milliseconds cancelCheckPeriod( 10 );
+
+RequestStatus Client::receiveBytes( uint8_t * data, size_t size, size_t & received, const RequestLimits & limits ) noexcept
+{
+	using Clock = RequestLimits::Clock;
+
+	auto toRequestStatus = []( SocketError status )
 	{
-		result.status = RequestStatus::InvalidReply;
+		if (status == SocketError::Success)
+			return RequestStatus::Success;
+		else if (status == SocketError::ConnectionClosed)
+			return RequestStatus::ConnectionClosed;
+		else if (status == SocketError::Timeout || status == SocketError::WouldBlock)
+			return RequestStatus::NoReply;
+		else
+			return RequestStatus::ReceiveError;
+	};
+
+	// Without limits the timeout of the client set on the socket applies as it is, and in the non-blocking mode
+	// the socket doesn't wait at all, so the timeout doesn't need to be touched.
+	if (!limits.hasDeadline() && !limits.token)
+	{
+		size_t chunk = 0;
+		SocketError status = _socket->receive( span< uint8_t >( data + received, size - received ), chunk );
+		received += chunk;  // the socket may have timed out in the middle
+		return toRequestStatus( status );
 	}
-	else
+
+	// without its own deadline the request waits as long as the timeout of the client allows
+	Clock::time_point deadline = limits.hasDeadline() ? limits.deadline : Clock::now() + _timeout;
+
+	RequestStatus result = RequestStatus::Success;
+	while (received < size)
 	{
-		result.status = RequestStatus::Success;
+		if (limits.token && limits.token->isCancelled())
+		{
+			result = RequestStatus::Cancelled;
+			break;
+		}
+
+		// wait in slices short enough to notice the cancellation in time
+		auto remaining = std::chrono::duration_cast< milliseconds >( deadline - Clock::now() );
+		milliseconds slice = std::max( remaining, milliseconds( 1 ) );  // 0 would mean waiting forever
+		if (limits.token)
+			slice = std::min( slice, cancelCheckPeriod );
+		if (slice != _socketTimeout && _socket->setTimeout( slice ))
+			_socketTimeout = slice;
+
+		size_t chunk = 0;
+		SocketError status = _socket->receive( span< uint8_t >( data + received, size - received ), chunk );
+		received += chunk;  // the socket may have timed out in the middle
+		result = toRequestStatus( status );
+		if (result != RequestStatus::NoReply || Clock::now() >= deadline)
+			break;
+		result = RequestStatus::Success;
 	}
 
+	// put back the timeout of the client, so that the requests without limits can rely on it
+	if (_socketTimeout != _timeout && _socket->setTimeout( _timeout ))
+		_socketTimeout = _timeout;
+
 	return result;
 }
 
+RequestStatus Client::receiveHeader( Header & header, const RequestLimits & limits ) noexcept
+{
+	static_assert( Header::size() == std::tuple_size< decltype( _headerBuffer ) >::value, "update the _headerBuffer" );
+	static const char magic [4] = { 'O', 'R', 'G', 'B' };
+
+	while (true)
+	{
+		RequestStatus status = receiveBytes( _headerBuffer.data(), _headerBuffer.size(), _headerReceived, limits );
+		if (status != RequestStatus::Success)
+		{
+			return status;
+		}
+		_headerReceived = 0;
+
+		if (memcmp( _headerBuffer.data(), magic, sizeof(magic) ) == 0)
+		{
+			break;
+		}
+
+		// We have lost track of where the messages begin, for example because a message was shorter than its header
+		// said. Find the first place where the magic could start and continue receiving the header from there.
+		size_t offset = 1;
+		for (; offset < _headerBuffer.size(); ++offset)
+		{
+			size_t length = std::min( sizeof(magic), _headerBuffer.size() - offset );
+			if (memcmp( _headerBuffer.data() + offset, magic, length ) == 0)
+				break;
+		}
+		std::copy( _headerBuffer.begin() + offset, _headerBuffer.end(), _headerBuffer.begin() );
+		_headerReceived = _headerBuffer.size() - offset;
+	}
+
+	// Parse the header. An unknown message type makes it fail, but the size is still valid
+	// and the callers throw away whatever they don't expect.
+	BinaryInputStream stream( _headerBuffer );
+	header.deserialize( stream );
+
+	return RequestStatus::Success;
+}
+
+RequestStatus Client::skipUnwantedBody( const RequestLimits & limits ) noexcept
+{
+	while (_bodyToSkip > 0)
+	{
+		// _recvBuffer is only a scratch space here, its content will be overwritten by the next reply anyway
+		_recvBuffer.resize( std::min( _bodyToSkip, size_t( 64 * 1024 ) ) );
+		size_t received = 0;
+		RequestStatus status = receiveBytes( _recvBuffer.data(), _recvBuffer.size(), received, limits );
+		_bodyToSkip -= received;
+		if (status != RequestStatus::Success)
+			return status;
+	}
+
+	return RequestStatus::Success;
+}
+
+bool Client::takeAbandonedReply( MessageType type ) noexcept
+{
+	auto reply = std::find( _abandonedReplies.begin(), _abandonedReplies.end(), type );
+	if (reply == _abandonedReplies.end())
+	{
+		return false;
+	}
+
+	// the server replies in the order of the requests, so the older ones are never going to come
+	_abandonedReplies.erase( _abandonedReplies.begin(), reply + 1 );
+	return true;
+}
+
 UpdateStatus Client::checkForUpdateMessageArrival() noexcept
 {
 	// We only need to check if there is any TCP message in the system input buffer, but don't wait for it.
@@ -1010,36 +1554,80 @@ UpdateStatus Client::checkForUpdateMessageArrival() noexcept
 		}
 	};
 
-	vector< uint8_t > buffer;
-	SocketError status = _socket->receive( buffer, Header::size() );
-	if (status == SocketError::WouldBlock)
+	RequestLimits noWait;  // the socket is non-blocking, a request without limits returns NoReply instead of waiting
+
+	// Read everything that has arrived. The replies to the requests that gave up waiting may be arriving now,
+	// they must not be mistaken for an unexpected message. A message that has arrived only partially is kept
+	// for the next call.
+	bool unexpectedMessage = false;
+	Header header;
+	RequestStatus status;
+	while (true)
 	{
-		// No message is currently in the socket, no indication that the device list is out of date.
-		return enableBlockingAndReturn( UpdateStatus::UpToDate );
+		status = skipUnwantedBody( noWait );
+		if (status == RequestStatus::Success)
+			status = receiveHeader( header, noWait );
+		if (status != RequestStatus::Success)
+			break;
+
+		if (header.message_type == MessageType::DEVICE_LIST_UPDATED)
+		{
+			// We have received a DeviceListUpdated message from the server,
+			// signal to the user that he needs to request the list again.
+			_isDeviceListOutOfDate = true;
+			if (_trafficRecorder)
+				_trafficRecorder->record( TrafficDirection::Received, _headerBuffer );
+			notifyListeners( header );
+		}
+		else if (!isValidMessageType( header.message_type ))
+		{
+			// a notification added in a newer protocol version
+			notifyListeners( header );
+			_bodyToSkip = header.message_size;
+		}
+		else if (takeAbandonedReply( header.message_type ))
+		{
+			_bodyToSkip = header.message_size;
+		}
+		else
+		{
+			// We received something, but something totally different than what we expected.
+			// Throw it away, so that the next request finds its reply.
+			unexpectedMessage = true;
+			_bodyToSkip = header.message_size;
+		}
 	}
-	else if (status == SocketError::ConnectionClosed)
+
+	if (status == RequestStatus::ConnectionClosed)
 	{
 		return enableBlockingAndReturn( UpdateStatus::ConnectionClosed );
 	}
-	else if (status != SocketError::Success)
+	else if (status != RequestStatus::NoReply)
 	{
 		return enableBlockingAndReturn( UpdateStatus::OtherSystemError );
 	}
 
-	// We have some message, so let's check what it is.
-
-	Header header;
-	BinaryInputStream stream( buffer );
-	if (!header.deserialize( stream ) || header.message_type != MessageType::DEVICE_LIST_UPDATED)
+	// No complete message is currently in the socket.
+	if (unexpectedMessage)
 	{
-		// We received something, but something totally different than what we expected.
 		return enableBlockingAndReturn( UpdateStatus::UnexpectedMessage );
 	}
-	else
+	return enableBlockingAndReturn( _isDeviceListOutOfDate ? UpdateStatus::OutOfDate : UpdateStatus::UpToDate );
+}
+
+void Client::notifyListeners( const Header & header ) noexcept
+{
+	// an exception from one listener must not leave the others uninformed nor escape from a noexcept function
+	for (NotificationListener * listener : _listeners)
 	{
-		// We have received a DeviceListUpdated message from the server,
-		// signal to the user that he needs to request the list again.
-		return enableBlockingAndReturn( UpdateStatus::OutOfDate );
+		try
+		{
+			if (header.message_type == MessageType::DEVICE_LIST_UPDATED)
+				listener->deviceListUpdated( *this );
+			else
+				listener->unknownNotification( *this, uint32_t( header.message_type ), header.device_idx );
+		}
+		CATCH_ALL()
 	}
 }
 
@@ -9,18 +9,17 @@
 #include <CppUtils-Essential/Essential.hpp>
 
 #include "MiscUtils.hpp"
+#include "ColorNames.hpp"
 
 #include <CppUtils-Essential/BinaryStream.hpp>
 using own::BinaryOutputStream;
 using own::BinaryInputStream;
-#include <CppUtils-Essential/StringUtils.hpp>
 
 #include <cstdio>
 #include <iostream>
 #include <ios>
 #include <iomanip>
 #include <string>
-#include <unordered_map>
 
 
 namespace orgb {
@@ -38,47 +37,86 @@ const Color Color::Yellow  (0xFF, 0xFF, 0x00);
 const Color Color::Magenta (0xFF, 0x00, 0xFF);
 const Color Color::Cyan    (0x00, 0xFF, 0xFF);
 
-static const std::unordered_map< std::string, Color > colorNames =
+// 0 - 15 for a hex digit, anything above 15 for any other character
+static inline uint32_t hexDigitValue( char c ) noexcept
 {
-	{ "black", Color::Black },
-	{ "white", Color::White },
-	{ "red", Color::Red },
-	{ "green", Color::Green },
-	{ "blue", Color::Blue },
-	{ "yellow", Color::Yellow },
-	{ "magenta", Color::Magenta },
-	{ "cyan", Color::Cyan },
-};
-
-bool Color::fromString( const std::string & str ) noexcept
+	uint32_t digit = uint32_t( uint8_t( c ) ) - '0';
+	uint32_t letter = (uint32_t( uint8_t( c ) ) | 0x20) - 'a';  // | 0x20 makes upper case letters lower case
+	return digit < 10 ? digit : (letter < 6 ? letter + 10 : 0xFF);
+}
+
+static bool parseHexColor( StringView str, Color & color ) noexcept
+{
+	if (str.size() != 6)
+		return false;
+
+	uint32_t value = 0;
+	uint32_t invalid = 0;
+	for (size_t i = 0; i < 6; ++i)
+	{
+		uint32_t digit = hexDigitValue( str[i] );
+		invalid |= digit;
+		value = (value << 4) | (digit & 0xF);
+	}
+	if (invalid > 0xF)
+		return false;
+
+	color.r = uint8_t( value >> 16 );
+	color.g = uint8_t( value >> 8 );
+	color.b = uint8_t( value );
+	return true;
+}
+
+static bool equalsIgnoreCase( StringView str, const char * lowerCaseName ) noexcept
+{
+	size_t i = 0;
+	for (; i < str.size(); ++i)
+	{
+		if (lowerCaseName[i] == '\0' || toLowerAscii( str[i] ) != lowerCaseName[i])
+			return false;
+	}
+	return lowerCaseName[i] == '\0';
+}
+
+static const NamedColor * findNamedColor( StringView name ) noexcept
+{
+	if (name.size() < minColorNameLength || name.size() > maxColorNameLength)
+		return nullptr;
+
+	// the same hash as hashColorName(), but bounded by the size instead of the null terminator
+	uint32_t hash = colorNameHashSeed;
+	for (char c : name)
+	{
+		hash = (hash ^ uint8_t( toLowerAscii( c ) )) * 16777619u;
+	}
+
+	uint8_t slot = colorNameSlots[ colorNameSlot( hash ) ];
+	if (slot == 0)
+		return nullptr;
+
+	const NamedColor & candidate = namedColors[ slot - 1 ];
+	return equalsIgnoreCase( name, candidate.name ) ? &candidate : nullptr;
+}
+
+bool Color::fromString( StringView str ) noexcept
 {
 	if (str.empty())
 		return false;
 
-	uint red, green, blue;
-	if (str[0] == '#' && sscanf( str.c_str() + 1, "%02x%02x%02x", &red, &green, &blue ) == 3)
+	if (str[0] == '#')
 	{
-		r = uint8_t( red );
-		g = uint8_t( green );
-		b = uint8_t( blue );
-		return true;
+		return parseHexColor( str.substr( 1, str.size() - 1 ), *this );
 	}
-	else if (sscanf( str.c_str(), "%02x%02x%02x", &red, &green, &blue ) == 3)
+	else if (parseHexColor( str, *this ))
 	{
-		r = uint8_t( red );
-		g = uint8_t( green );
-		b = uint8_t( blue );
 		return true;
 	}
-	else
+	else if (const NamedColor * namedColor = findNamedColor( str ))
 	{
-		std::string strLower = own::to_lower( str );
-		auto colorIter = colorNames.find( strLower );
-		if (colorIter != colorNames.end())
-		{
-			*this = colorIter->second;
-			return true;
-		}
+		r = namedColor->r;
+		g = namedColor->g;
+		b = namedColor->b;
+		return true;
 	}
 	return false;
 }
@@ -0,0 +1,530 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: conversions between RGB and HSV/HSL color spaces
+//======================================================================================================================
+
+#include <OpenRGB/ColorConversion.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+#include <CppUtils-Essential/LangUtils.hpp>  // size
+
+#include "CpuFeatures.hpp"
+
+#include <algorithm>  // min, max
+#include <cstdlib>    // abs
+
+#if defined(ORGB_SIMD_X86)
+	#include <emmintrin.h>
+	#include <immintrin.h>
+#elif defined(ORGB_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+
+namespace orgb {
+
+
+static_assert( sizeof(HSV) == 4 && sizeof(HSL) == 4, "the vectorized conversions expect HSV and HSL to be 4 bytes" );
+
+
+//======================================================================================================================
+//  portable implementation
+//
+//  HSV and HSL differ only in how they define the brightest and the darkest channel of the color. Once these two are
+//  known, the hue says which channel is the brightest, which is the darkest and where between them is the third one.
+//  The SIMD implementations must exactly follow these calculations.
+
+// round( x / 255 ) for x in [0, 255*255]
+static inline uint32_t div255( uint32_t x )
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+static inline Color expandHue( uint32_t hue, uint32_t maxC, uint32_t minC )
+{
+	uint32_t sector = (hue * 6) >> 16;           // 0 - 5
+	uint32_t fraction = (hue * 6) & 0xFFFF;      // position within the sector
+	uint32_t delta = ((((maxC - minC) << 8) * fraction >> 16) + 128) >> 8;
+	uint8_t hi = uint8_t( maxC );
+	uint8_t lo = uint8_t( minC );
+	uint8_t rising = uint8_t( minC + delta );
+	uint8_t falling = uint8_t( maxC - delta );
+
+	Color color;
+	switch (sector)
+	{
+		case 0:  color = Color( hi, rising, lo );  break;
+		case 1:  color = Color( falling, hi, lo ); break;
+		case 2:  color = Color( lo, hi, rising );  break;
+		case 3:  color = Color( lo, falling, hi ); break;
+		case 4:  color = Color( rising, lo, hi );  break;
+		default: color = Color( hi, lo, falling ); break;
+	}
+	color.padding = 0;
+	return color;
+}
+
+Color hsvToRgb( HSV hsv ) noexcept
+{
+	uint32_t maxC = hsv.v;
+	uint32_t minC = maxC - div255( maxC * hsv.s );
+	return expandHue( hsv.h, maxC, minC );
+}
+
+Color hslToRgb( HSL hsl ) noexcept
+{
+	uint32_t l = hsl.l;
+	uint32_t maxC = l + div255( hsl.s * std::min( l, 255 - l ) );
+	uint32_t minC = 2 * l - maxC;
+	return expandHue( hsl.h, maxC, minC );
+}
+
+/// Reciprocals replacing the divisions in the conversions from RGB.
+struct ReciprocalTables
+{
+	uint32_t saturation [256];  ///< round( 255 * 2^16 / x )
+	int32_t  hue [256];         ///< round( 2^24 / (6 * x) )
+
+	ReciprocalTables() noexcept
+	{
+		saturation[0] = 0;
+		hue[0] = 0;
+		for (uint32_t x = 1; x < 256; ++x)
+		{
+			saturation[x] = (255u * 65536u + x / 2) / x;
+			hue[x] = int32_t( ((1u << 24) + 3 * x) / (6 * x) );
+		}
+	}
+};
+
+static const ReciprocalTables & reciprocals() noexcept
+{
+	static const ReciprocalTables tables;
+	return tables;
+}
+
+// hue as a 24-bit fraction of the circle, to keep the precision until the final rounding
+static inline uint16_t calcHue( const ReciprocalTables & recip, int32_t r, int32_t g, int32_t b, int32_t maxC, int32_t delta )
+{
+	if (delta == 0)
+		return 0;
+
+	int32_t hue24;
+	if (maxC == r)
+		hue24 = (1 << 24) + (g - b) * recip.hue[ delta ];  // full circle added to keep it positive
+	else if (maxC == g)
+		hue24 = 5592405 + (b - r) * recip.hue[ delta ];    // 1/3 of the circle
+	else
+		hue24 = 11184811 + (r - g) * recip.hue[ delta ];   // 2/3 of the circle
+
+	return uint16_t( (hue24 + 128) >> 8 );
+}
+
+static inline uint8_t calcSaturation( const ReciprocalTables & recip, uint32_t delta, uint32_t divisor )
+{
+	uint32_t s = (delta * recip.saturation[ divisor ] + 0x8000) >> 16;
+	return uint8_t( std::min( s, 255u ) );
+}
+
+static inline HSV rgbToHsv( const ReciprocalTables & recip, Color color )
+{
+	int32_t maxC = std::max( color.r, std::max( color.g, color.b ) );
+	int32_t minC = std::min( color.r, std::min( color.g, color.b ) );
+	int32_t delta = maxC - minC;
+
+	HSV hsv;
+	hsv.h = calcHue( recip, color.r, color.g, color.b, maxC, delta );
+	hsv.s = calcSaturation( recip, uint32_t( delta ), uint32_t( maxC ) );
+	hsv.v = uint8_t( maxC );
+	return hsv;
+}
+
+static inline HSL rgbToHsl( const ReciprocalTables & recip, Color color )
+{
+	int32_t maxC = std::max( color.r, std::max( color.g, color.b ) );
+	int32_t minC = std::min( color.r, std::min( color.g, color.b ) );
+	int32_t delta = maxC - minC;
+	int32_t sum = maxC + minC;
+
+	HSL hsl;
+	hsl.h = calcHue( recip, color.r, color.g, color.b, maxC, delta );
+	// the divisor is at least delta, so it can only be 0 when delta is 0 as well
+	hsl.s = calcSaturation( recip, uint32_t( delta ), uint32_t( 255 - std::abs( sum - 255 ) ) );
+	hsl.l = uint8_t( (sum + 1) >> 1 );
+	return hsl;
+}
+
+HSV rgbToHsv( Color color ) noexcept
+{
+	return rgbToHsv( reciprocals(), color );
+}
+
+HSL rgbToHsl( Color color ) noexcept
+{
+	return rgbToHsl( reciprocals(), color );
+}
+
+static void hsvToRgbScalar( const HSV * src, Color * dst, size_t count )
+{
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = hsvToRgb( src[i] );
+}
+
+static void hslToRgbScalar( const HSL * src, Color * dst, size_t count )
+{
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = hslToRgb( src[i] );
+}
+
+
+//======================================================================================================================
+//  SSE2 and AVX2 implementations
+//
+//  8 or 16 colors are processed at once, each channel in its own register with 16-bit lanes.
+
+#if defined(ORGB_SIMD_X86)
+
+ORGB_TARGET_SSE2 static inline __m128i div255SSE2( __m128i x )
+{
+	x = _mm_add_epi16( x, _mm_set1_epi16( 128 ) );
+	return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+// Splits 8 HSV or HSL structs into the 16-bit hue and the two 8-bit channels.
+ORGB_TARGET_SSE2 static inline void loadHueColors( const void * src, __m128i & hue, __m128i & chan1, __m128i & chan2 )
+{
+	__m128i x0 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( src ) );
+	__m128i x1 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( src ) + 1 );
+	// the hue must be sign-extended first, otherwise the signed saturation of the pack would damage it
+	hue = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( x0, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( x1, 16 ), 16 ) );
+	chan1 = _mm_packs_epi32( _mm_srli_epi32( _mm_slli_epi32( x0, 8 ), 24 ), _mm_srli_epi32( _mm_slli_epi32( x1, 8 ), 24 ) );
+	chan2 = _mm_packs_epi32( _mm_srli_epi32( x0, 24 ), _mm_srli_epi32( x1, 24 ) );
+}
+
+ORGB_TARGET_SSE2 static inline void expandHueSSE2( __m128i hue, __m128i maxC, __m128i minC, Color * dst )
+{
+	const __m128i six = _mm_set1_epi16( 6 );
+	__m128i sector = _mm_mulhi_epu16( hue, six );
+	__m128i fraction = _mm_mullo_epi16( hue, six );
+	__m128i delta = _mm_mulhi_epu16( _mm_slli_epi16( _mm_sub_epi16( maxC, minC ), 8 ), fraction );
+	delta = _mm_srli_epi16( _mm_add_epi16( delta, _mm_set1_epi16( 128 ) ), 8 );
+	__m128i rising = _mm_add_epi16( minC, delta );
+	__m128i falling = _mm_sub_epi16( maxC, delta );
+
+	__m128i s0 = _mm_cmpeq_epi16( sector, _mm_setzero_si128() );
+	__m128i s1 = _mm_cmpeq_epi16( sector, _mm_set1_epi16( 1 ) );
+	__m128i s2 = _mm_cmpeq_epi16( sector, _mm_set1_epi16( 2 ) );
+	__m128i s3 = _mm_cmpeq_epi16( sector, _mm_set1_epi16( 3 ) );
+	__m128i s4 = _mm_cmpeq_epi16( sector, _mm_set1_epi16( 4 ) );
+	__m128i s5 = _mm_cmpeq_epi16( sector, _mm_set1_epi16( 5 ) );
+
+	__m128i r = _mm_or_si128(
+		_mm_or_si128( _mm_and_si128( _mm_or_si128( s0, s5 ), maxC ), _mm_and_si128( s1, falling ) ),
+		_mm_or_si128( _mm_and_si128( _mm_or_si128( s2, s3 ), minC ), _mm_and_si128( s4, rising ) )
+	);
+	__m128i g = _mm_or_si128(
+		_mm_or_si128( _mm_and_si128( s0, rising ), _mm_and_si128( _mm_or_si128( s1, s2 ), maxC ) ),
+		_mm_or_si128( _mm_and_si128( s3, falling ), _mm_and_si128( _mm_or_si128( s4, s5 ), minC ) )
+	);
+	__m128i b = _mm_or_si128(
+		_mm_or_si128( _mm_and_si128( _mm_or_si128( s0, s1 ), minC ), _mm_and_si128( s2, rising ) ),
+		_mm_or_si128( _mm_and_si128( _mm_or_si128( s3, s4 ), maxC ), _mm_and_si128( s5, falling ) )
+	);
+
+	// interleave back into r,g,b,padding
+	__m128i rg = _mm_or_si128( r, _mm_slli_epi16( g, 8 ) );
+	_mm_storeu_si128( reinterpret_cast< __m128i * >( dst ), _mm_unpacklo_epi16( rg, b ) );
+	_mm_storeu_si128( reinterpret_cast< __m128i * >( dst ) + 1, _mm_unpackhi_epi16( rg, b ) );
+}
+
+ORGB_TARGET_SSE2 static void hsvToRgbSSE2( const HSV * src, Color * dst, size_t count )
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i hue, s, v;
+		loadHueColors( src + i, hue, s, v );
+		__m128i minC = _mm_sub_epi16( v, div255SSE2( _mm_mullo_epi16( v, s ) ) );
+		expandHueSSE2( hue, v, minC, dst + i );
+	}
+	hsvToRgbScalar( src + i, dst + i, count - i );
+}
+
+ORGB_TARGET_SSE2 static void hslToRgbSSE2( const HSL * src, Color * dst, size_t count )
+{
+	const __m128i c255 = _mm_set1_epi16( 255 );
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i hue, s, l;
+		loadHueColors( src + i, hue, s, l );
+		__m128i chroma = div255SSE2( _mm_mullo_epi16( s, _mm_min_epi16( l, _mm_sub_epi16( c255, l ) ) ) );
+		__m128i maxC = _mm_add_epi16( l, chroma );
+		__m128i minC = _mm_sub_epi16( l, chroma );
+		expandHueSSE2( hue, maxC, minC, dst + i );
+	}
+	hslToRgbScalar( src + i, dst + i, count - i );
+}
+
+ORGB_TARGET_AVX2 static inline __m256i div255AVX2( __m256i x )
+{
+	x = _mm256_add_epi16( x, _mm256_set1_epi16( 128 ) );
+	return _mm256_srli_epi16( _mm256_add_epi16( x, _mm256_srli_epi16( x, 8 ) ), 8 );
+}
+
+// The packs shuffle the colors between the 128-bit lanes and the final unpacks shuffle them back.
+
+ORGB_TARGET_AVX2 static inline void loadHueColors8( const void * src, __m256i & hue, __m256i & chan1, __m256i & chan2 )
+{
+	__m256i x0 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( src ) );
+	__m256i x1 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( src ) + 1 );
+	hue = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_slli_epi32( x0, 16 ), 16 ), _mm256_srai_epi32( _mm256_slli_epi32( x1, 16 ), 16 ) );
+	chan1 = _mm256_packs_epi32( _mm256_srli_epi32( _mm256_slli_epi32( x0, 8 ), 24 ), _mm256_srli_epi32( _mm256_slli_epi32( x1, 8 ), 24 ) );
+	chan2 = _mm256_packs_epi32( _mm256_srli_epi32( x0, 24 ), _mm256_srli_epi32( x1, 24 ) );
+}
+
+ORGB_TARGET_AVX2 static inline void expandHueAVX2( __m256i hue, __m256i maxC, __m256i minC, Color * dst )
+{
+	const __m256i six = _mm256_set1_epi16( 6 );
+	__m256i sector = _mm256_mulhi_epu16( hue, six );
+	__m256i fraction = _mm256_mullo_epi16( hue, six );
+	__m256i delta = _mm256_mulhi_epu16( _mm256_slli_epi16( _mm256_sub_epi16( maxC, minC ), 8 ), fraction );
+	delta = _mm256_srli_epi16( _mm256_add_epi16( delta, _mm256_set1_epi16( 128 ) ), 8 );
+	__m256i rising = _mm256_add_epi16( minC, delta );
+	__m256i falling = _mm256_sub_epi16( maxC, delta );
+
+	__m256i s0 = _mm256_cmpeq_epi16( sector, _mm256_setzero_si256() );
+	__m256i s1 = _mm256_cmpeq_epi16( sector, _mm256_set1_epi16( 1 ) );
+	__m256i s2 = _mm256_cmpeq_epi16( sector, _mm256_set1_epi16( 2 ) );
+	__m256i s3 = _mm256_cmpeq_epi16( sector, _mm256_set1_epi16( 3 ) );
+	__m256i s4 = _mm256_cmpeq_epi16( sector, _mm256_set1_epi16( 4 ) );
+	__m256i s5 = _mm256_cmpeq_epi16( sector, _mm256_set1_epi16( 5 ) );
+
+	__m256i r = _mm256_or_si256(
+		_mm256_or_si256( _mm256_and_si256( _mm256_or_si256( s0, s5 ), maxC ), _mm256_and_si256( s1, falling ) ),
+		_mm256_or_si256( _mm256_and_si256( _mm256_or_si256( s2, s3 ), minC ), _mm256_and_si256( s4, rising ) )
+	);
+	__m256i g = _mm256_or_si256(
+		_mm256_or_si256( _mm256_and_si256( s0, rising ), _mm256_and_si256( _mm256_or_si256( s1, s2 ), maxC ) ),
+		_mm256_or_si256( _mm256_and_si256( s3, falling ), _mm256_and_si256( _mm256_or_si256( s4, s5 ), minC ) )
+	);
+	__m256i b = _mm256_or_si256(
+		_mm256_or_si256( _mm256_and_si256( _mm256_or_si256( s0, s1 ), minC ), _mm256_and_si256( s2, rising ) ),
+		_mm256_or_si256( _mm256_and_si256( _mm256_or_si256( s3, s4 ), maxC ), _mm256_and_si256( s5, falling ) )
+	);
+
+	__m256i rg = _mm256_or_si256( r, _mm256_slli_epi16( g, 8 ) );
+	_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst ), _mm256_unpacklo_epi16( rg, b ) );
+	_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst ) + 1, _mm256_unpackhi_epi16( rg, b ) );
+}
+
+ORGB_TARGET_AVX2 static void hsvToRgbAVX2( const HSV * src, Color * dst, size_t count )
+{
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i hue, s, v;
+		loadHueColors8( src + i, hue, s, v );
+		__m256i minC = _mm256_sub_epi16( v, div255AVX2( _mm256_mullo_epi16( v, s ) ) );
+		expandHueAVX2( hue, v, minC, dst + i );
+	}
+	hsvToRgbSSE2( src + i, dst + i, count - i );
+}
+
+ORGB_TARGET_AVX2 static void hslToRgbAVX2( const HSL * src, Color * dst, size_t count )
+{
+	const __m256i c255 = _mm256_set1_epi16( 255 );
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i hue, s, l;
+		loadHueColors8( src + i, hue, s, l );
+		__m256i chroma = div255AVX2( _mm256_mullo_epi16( s, _mm256_min_epi16( l, _mm256_sub_epi16( c255, l ) ) ) );
+		__m256i maxC = _mm256_add_epi16( l, chroma );
+		__m256i minC = _mm256_sub_epi16( l, chroma );
+		expandHueAVX2( hue, maxC, minC, dst + i );
+	}
+	hslToRgbSSE2( src + i, dst + i, count - i );
+}
+
+#endif // ORGB_SIMD_X86
+
+
+//======================================================================================================================
+//  NEON implementation
+//
+//  Splitting the 8-bit channels out of the 16-bit loads relies on little endian byte order.
+
+#if defined(ORGB_SIMD_NEON) && (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	#define ORGB_CONVERSION_NEON
+#endif
+
+#if defined(ORGB_CONVERSION_NEON)
+
+static inline uint16x8_t div255NEON( uint16x8_t x )
+{
+	x = vaddq_u16( x, vdupq_n_u16( 128 ) );
+	return vshrq_n_u16( vsraq_n_u16( x, x, 8 ), 8 );
+}
+
+static inline void expandHueNEON( uint16x8_t hue, uint16x8_t maxC, uint16x8_t minC, Color * dst )
+{
+	const uint16x4_t six = vdup_n_u16( 6 );
+	uint16x8_t sector = vcombine_u16(
+		vshrn_n_u32( vmull_u16( vget_low_u16( hue ), six ), 16 ),
+		vshrn_n_u32( vmull_u16( vget_high_u16( hue ), six ), 16 )
+	);
+	uint16x8_t fraction = vmulq_n_u16( hue, 6 );
+	uint16x8_t range = vshlq_n_u16( vsubq_u16( maxC, minC ), 8 );
+	uint16x8_t delta = vcombine_u16(
+		vshrn_n_u32( vmull_u16( vget_low_u16( range ), vget_low_u16( fraction ) ), 16 ),
+		vshrn_n_u32( vmull_u16( vget_high_u16( range ), vget_high_u16( fraction ) ), 16 )
+	);
+	delta = vshrq_n_u16( vaddq_u16( delta, vdupq_n_u16( 128 ) ), 8 );
+	uint16x8_t rising = vaddq_u16( minC, delta );
+	uint16x8_t falling = vsubq_u16( maxC, delta );
+
+	uint16x8_t s0 = vceqq_u16( sector, vdupq_n_u16( 0 ) );
+	uint16x8_t s1 = vceqq_u16( sector, vdupq_n_u16( 1 ) );
+	uint16x8_t s2 = vceqq_u16( sector, vdupq_n_u16( 2 ) );
+	uint16x8_t s3 = vceqq_u16( sector, vdupq_n_u16( 3 ) );
+	uint16x8_t s4 = vceqq_u16( sector, vdupq_n_u16( 4 ) );
+
+	// sector 5 is whatever remains after all the other sectors are checked
+	uint16x8_t r = vbslq_u16( s0, maxC, vbslq_u16( s1, falling, vbslq_u16( vorrq_u16( s2, s3 ), minC, vbslq_u16( s4, rising, maxC ) ) ) );
+	uint16x8_t g = vbslq_u16( s0, rising, vbslq_u16( vorrq_u16( s1, s2 ), maxC, vbslq_u16( s3, falling, minC ) ) );
+	uint16x8_t b = vbslq_u16( vorrq_u16( s0, s1 ), minC, vbslq_u16( s2, rising, vbslq_u16( vorrq_u16( s3, s4 ), maxC, falling ) ) );
+
+	uint8x8x4_t colors;
+	colors.val[0] = vmovn_u16( r );
+	colors.val[1] = vmovn_u16( g );
+	colors.val[2] = vmovn_u16( b );
+	colors.val[3] = vdup_n_u8( 0 );
+	vst4_u8( reinterpret_cast< uint8_t * >( dst ), colors );
+}
+
+static void hsvToRgbNEON( const HSV * src, Color * dst, size_t count )
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		uint16x8x2_t x = vld2q_u16( reinterpret_cast< const uint16_t * >( src + i ) );
+		uint16x8_t s = vandq_u16( x.val[1], vdupq_n_u16( 0xFF ) );
+		uint16x8_t v = vshrq_n_u16( x.val[1], 8 );
+		uint16x8_t minC = vsubq_u16( v, div255NEON( vmulq_u16( v, s ) ) );
+		expandHueNEON( x.val[0], v, minC, dst + i );
+	}
+	hsvToRgbScalar( src + i, dst + i, count - i );
+}
+
+static void hslToRgbNEON( const HSL * src, Color * dst, size_t count )
+{
+	const uint16x8_t c255 = vdupq_n_u16( 255 );
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		uint16x8x2_t x = vld2q_u16( reinterpret_cast< const uint16_t * >( src + i ) );
+		uint16x8_t s = vandq_u16( x.val[1], vdupq_n_u16( 0xFF ) );
+		uint16x8_t l = vshrq_n_u16( x.val[1], 8 );
+		uint16x8_t chroma = div255NEON( vmulq_u16( s, vminq_u16( l, vsubq_u16( c255, l ) ) ) );
+		expandHueNEON( x.val[0], vaddq_u16( l, chroma ), vsubq_u16( l, chroma ), dst + i );
+	}
+	hslToRgbScalar( src + i, dst + i, count - i );
+}
+
+#endif // ORGB_CONVERSION_NEON
+
+
+//======================================================================================================================
+//  runtime dispatch
+
+struct ConversionTable
+{
+	const char * name;
+	void (* hsvToRgb)( const HSV * src, Color * dst, size_t count );
+	void (* hslToRgb)( const HSL * src, Color * dst, size_t count );
+};
+
+static ConversionTable selectConversions() noexcept
+{
+	const CpuFeatures & cpu = cpuFeatures();
+	(void)cpu;
+
+ #if defined(ORGB_SIMD_X86)
+	if (cpu.avx2)
+		return { "AVX2", hsvToRgbAVX2, hslToRgbAVX2 };
+	if (cpu.sse2)
+		return { "SSE2", hsvToRgbSSE2, hslToRgbSSE2 };
+ #elif defined(ORGB_CONVERSION_NEON)
+	if (cpu.neon)
+		return { "NEON", hsvToRgbNEON, hslToRgbNEON };
+ #endif
+
+	return { "portable", hsvToRgbScalar, hslToRgbScalar };
+}
+
+static const ConversionTable & conversions() noexcept
+{
+	static const ConversionTable table = selectConversions();
+	return table;
+}
+
+
+//======================================================================================================================
+//  public API
+
+void hsvToRgb( Span< const HSV > src, Span< Color > dst ) noexcept
+{
+	conversions().hsvToRgb( src.data(), dst.data(), std::min( src.size(), dst.size() ) );
+}
+
+void hslToRgb( Span< const HSL > src, Span< Color > dst ) noexcept
+{
+	conversions().hslToRgb( src.data(), dst.data(), std::min( src.size(), dst.size() ) );
+}
+
+void rgbToHsv( Span< const Color > src, Span< HSV > dst ) noexcept
+{
+	const ReciprocalTables & recip = reciprocals();
+	size_t count = std::min( src.size(), dst.size() );
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = rgbToHsv( recip, src[i] );
+}
+
+void rgbToHsl( Span< const Color > src, Span< HSL > dst ) noexcept
+{
+	const ReciprocalTables & recip = reciprocals();
+	size_t count = std::min( src.size(), dst.size() );
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = rgbToHsl( recip, src[i] );
+}
+
+void fillRainbow( Span< Color > dst, uint16_t startHue, uint16_t hueStep, uint8_t saturation, uint8_t value ) noexcept
+{
+	// generate the hues in small batches, so that the vectorized conversion can be used without allocating
+	HSV batch [64];
+	uint16_t hue = startHue;
+	for (size_t pos = 0; pos < dst.size(); pos += fut::size( batch ))
+	{
+		size_t batchSize = std::min( dst.size() - pos, size_t( fut::size( batch ) ) );
+		for (size_t i = 0; i < batchSize; ++i)
+		{
+			batch[i] = HSV( hue, saturation, value );
+			hue = uint16_t( hue + hueStep );
+		}
+		conversions().hsvToRgb( batch, dst.data() + pos, batchSize );
+	}
+}
+
+const char * colorConversionsImplementation() noexcept
+{
+	return conversions().name;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
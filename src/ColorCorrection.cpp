@@ -0,0 +1,73 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: per-device correction of colors via lookup tables
+//======================================================================================================================
+
+#include <OpenRGB/ColorCorrection.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <cmath>      // pow
+#include <algorithm>  // min
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+ColorCorrection::ColorCorrection() noexcept
+{
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		_red[i] = _green[i] = _blue[i] = uint8_t( i );
+	}
+}
+
+static void fillTable( uint8_t * table, float gamma, uint8_t gain, uint8_t brightnessCap )
+{
+	float scale = (float( gain ) / 255.0f) * (float( brightnessCap ) / 255.0f) * 255.0f;
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		float value = std::pow( float( i ) / 255.0f, gamma ) * scale + 0.5f;
+		table[i] = uint8_t( std::min( value, 255.0f ) );
+	}
+}
+
+ColorCorrection::ColorCorrection( float gamma, Color gains, uint8_t brightnessCap ) noexcept
+{
+	if (!(gamma > 0.0f))  // also catches NaN
+		gamma = 1.0f;
+
+	fillTable( _red, gamma, gains.r, brightnessCap );
+	fillTable( _green, gamma, gains.g, brightnessCap );
+	fillTable( _blue, gamma, gains.b, brightnessCap );
+}
+
+void ColorCorrection::apply( Span< const Color > src, Span< Color > dst ) const noexcept
+{
+	// There is no byte gather instruction in SSE2 or NEON, but the tables have only 768 bytes and stay in L1 cache,
+	// so this is mostly limited by the memory bandwidth anyway.
+	size_t count = std::min( src.size(), dst.size() );
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i] = apply( src[i] );
+	}
+}
+
+bool ColorCorrection::isIdentity() const noexcept
+{
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		if (_red[i] != i || _green[i] != i || _blue[i] != i)
+			return false;
+	}
+	return true;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
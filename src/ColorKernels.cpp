@@ -0,0 +1,597 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: bulk operations over arrays of colors
+//======================================================================================================================
+
+#include <OpenRGB/ColorKernels.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include "CpuFeatures.hpp"
+
+#include <cstring>    // memcpy
+#include <algorithm>  // min
+
+#if defined(ORGB_SIMD_X86)
+	#include <emmintrin.h>
+	#include <immintrin.h>
+#elif defined(ORGB_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+
+namespace orgb {
+
+
+static_assert( sizeof(Color) == 4, "the kernels expect Color to be 4 bytes without any gaps" );
+
+
+//======================================================================================================================
+//  portable implementation
+//
+//  This is also the reference the SIMD implementations must exactly match, and it processes the remainders of arrays
+//  that don't fill a whole vector register.
+
+// round( x / 255 ) for x in [0, 255*255]
+static inline uint32_t div255( uint32_t x )
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+static void fillScalar( Color * dst, size_t count, Color color )
+{
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = color;
+}
+
+static void scaleScalar( Color * dst, size_t count, Color factors )
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i].r = uint8_t( div255( dst[i].r * factors.r ) );
+		dst[i].g = uint8_t( div255( dst[i].g * factors.g ) );
+		dst[i].b = uint8_t( div255( dst[i].b * factors.b ) );
+		dst[i].padding = uint8_t( div255( dst[i].padding * factors.padding ) );
+	}
+}
+
+static void blendScalar( Color * dst, const Color * from, const Color * to, size_t count, uint8_t weight )
+{
+	uint32_t w1 = weight, w0 = 255u - weight;
+	for (size_t i = 0; i < count; ++i)
+	{
+		Color a = from[i], b = to[i];
+		dst[i].r = uint8_t( div255( a.r * w0 + b.r * w1 ) );
+		dst[i].g = uint8_t( div255( a.g * w0 + b.g * w1 ) );
+		dst[i].b = uint8_t( div255( a.b * w0 + b.b * w1 ) );
+		dst[i].padding = uint8_t( div255( a.padding * w0 + b.padding * w1 ) );
+	}
+}
+
+static inline uint8_t addSaturated( uint8_t a, uint8_t b )
+{
+	uint32_t sum = uint32_t( a ) + b;
+	return uint8_t( sum > 255 ? 255 : sum );
+}
+
+static void addScalar( Color * dst, const Color * src, size_t count )
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i].r = addSaturated( dst[i].r, src[i].r );
+		dst[i].g = addSaturated( dst[i].g, src[i].g );
+		dst[i].b = addSaturated( dst[i].b, src[i].b );
+		dst[i].padding = addSaturated( dst[i].padding, src[i].padding );
+	}
+}
+
+static void maxScalar( Color * dst, const Color * src, size_t count )
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i].r = std::max( dst[i].r, src[i].r );
+		dst[i].g = std::max( dst[i].g, src[i].g );
+		dst[i].b = std::max( dst[i].b, src[i].b );
+		dst[i].padding = std::max( dst[i].padding, src[i].padding );
+	}
+}
+
+static void multiplyScalar( Color * dst, const Color * src, size_t count )
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		dst[i].r = uint8_t( div255( dst[i].r * src[i].r ) );
+		dst[i].g = uint8_t( div255( dst[i].g * src[i].g ) );
+		dst[i].b = uint8_t( div255( dst[i].b * src[i].b ) );
+		dst[i].padding = uint8_t( div255( dst[i].padding * src[i].padding ) );
+	}
+}
+
+// The gradient is calculated in 16.16 fixed point. All the implementations must use the same steps,
+// so that the results are identical.
+struct GradientSteps
+{
+	int32_t start [4];  ///< value of the first color for each channel
+	int32_t step [4];   ///< increment per color for each channel
+};
+
+static GradientSteps calcGradientSteps( size_t count, Color from, Color to )
+{
+	GradientSteps gs;
+	const uint8_t fromChannels [4] = { from.r, from.g, from.b, 0 };
+	const uint8_t toChannels [4] = { to.r, to.g, to.b, 0 };
+	int32_t divisor = int32_t( count > 1 ? count - 1 : 1 );
+	for (int c = 0; c < 4; ++c)
+	{
+		gs.start[c] = (int32_t( fromChannels[c] ) << 16) + 0x8000;  // + 0.5 to round instead of truncate
+		gs.step[c] = ((int32_t( toChannels[c] ) - int32_t( fromChannels[c] )) * 65536) / divisor;
+	}
+	return gs;
+}
+
+static void gradientScalar( Color * dst, size_t begin, size_t end, const GradientSteps & gs )
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		int32_t idx = int32_t( i );
+		dst[i].r = uint8_t( (gs.start[0] + idx * gs.step[0]) >> 16 );
+		dst[i].g = uint8_t( (gs.start[1] + idx * gs.step[1]) >> 16 );
+		dst[i].b = uint8_t( (gs.start[2] + idx * gs.step[2]) >> 16 );
+		dst[i].padding = 0;
+	}
+}
+
+static void gradientPortable( Color * dst, size_t count, Color from, Color to )
+{
+	GradientSteps gs = calcGradientSteps( count, from, to );
+	gradientScalar( dst, 0, count, gs );
+}
+
+
+//======================================================================================================================
+//  SSE2 implementation
+
+#if defined(ORGB_SIMD_X86)
+
+ORGB_TARGET_SSE2 static inline __m128i loadColors( const Color * src )
+{
+	return _mm_loadu_si128( reinterpret_cast< const __m128i * >( src ) );
+}
+
+ORGB_TARGET_SSE2 static inline void storeColors( Color * dst, __m128i colors )
+{
+	_mm_storeu_si128( reinterpret_cast< __m128i * >( dst ), colors );
+}
+
+ORGB_TARGET_SSE2 static inline __m128i colorToVector( Color color )
+{
+	int32_t bits;
+	memcpy( &bits, &color, sizeof(bits) );
+	return _mm_set1_epi32( bits );
+}
+
+// round( x / 255 ) for each 16-bit lane
+ORGB_TARGET_SSE2 static inline __m128i div255SSE2( __m128i x )
+{
+	x = _mm_add_epi16( x, _mm_set1_epi16( 128 ) );
+	return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+ORGB_TARGET_SSE2 static void fillSSE2( Color * dst, size_t count, Color color )
+{
+	__m128i vec = colorToVector( color );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, vec );
+	fillScalar( dst + i, count - i, color );
+}
+
+ORGB_TARGET_SSE2 static void scaleSSE2( Color * dst, size_t count, Color factors )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i factors16 = _mm_unpacklo_epi8( colorToVector( factors ), zero );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i colors = loadColors( dst + i );
+		__m128i lo = div255SSE2( _mm_mullo_epi16( _mm_unpacklo_epi8( colors, zero ), factors16 ) );
+		__m128i hi = div255SSE2( _mm_mullo_epi16( _mm_unpackhi_epi8( colors, zero ), factors16 ) );
+		storeColors( dst + i, _mm_packus_epi16( lo, hi ) );
+	}
+	scaleScalar( dst + i, count - i, factors );
+}
+
+ORGB_TARGET_SSE2 static void blendSSE2( Color * dst, const Color * from, const Color * to, size_t count, uint8_t weight )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i w1 = _mm_set1_epi16( short( weight ) );
+	const __m128i w0 = _mm_set1_epi16( short( 255 - weight ) );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i a = loadColors( from + i );
+		__m128i b = loadColors( to + i );
+		__m128i lo = _mm_add_epi16(
+			_mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ), w0 ),
+			_mm_mullo_epi16( _mm_unpacklo_epi8( b, zero ), w1 )
+		);
+		__m128i hi = _mm_add_epi16(
+			_mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ), w0 ),
+			_mm_mullo_epi16( _mm_unpackhi_epi8( b, zero ), w1 )
+		);
+		storeColors( dst + i, _mm_packus_epi16( div255SSE2( lo ), div255SSE2( hi ) ) );
+	}
+	blendScalar( dst + i, from + i, to + i, count - i, weight );
+}
+
+ORGB_TARGET_SSE2 static void addSSE2( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, _mm_adds_epu8( loadColors( dst + i ), loadColors( src + i ) ) );
+	addScalar( dst + i, src + i, count - i );
+}
+
+ORGB_TARGET_SSE2 static void maxSSE2( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, _mm_max_epu8( loadColors( dst + i ), loadColors( src + i ) ) );
+	maxScalar( dst + i, src + i, count - i );
+}
+
+ORGB_TARGET_SSE2 static void multiplySSE2( Color * dst, const Color * src, size_t count )
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i a = loadColors( dst + i );
+		__m128i b = loadColors( src + i );
+		__m128i lo = div255SSE2( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) ) );
+		__m128i hi = div255SSE2( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) ) );
+		storeColors( dst + i, _mm_packus_epi16( lo, hi ) );
+	}
+	multiplyScalar( dst + i, src + i, count - i );
+}
+
+ORGB_TARGET_SSE2 static void gradientSSE2( Color * dst, size_t count, Color from, Color to )
+{
+	GradientSteps gs = calcGradientSteps( count, from, to );
+
+	// one register per color, each holding the 4 channels as 32-bit fixed point numbers
+	const __m128i step = _mm_setr_epi32( gs.step[0], gs.step[1], gs.step[2], gs.step[3] );
+	const __m128i step4 = _mm_slli_epi32( step, 2 );
+	__m128i acc0 = _mm_setr_epi32( gs.start[0], gs.start[1], gs.start[2], gs.start[3] );
+	__m128i acc1 = _mm_add_epi32( acc0, step );
+	__m128i acc2 = _mm_add_epi32( acc1, step );
+	__m128i acc3 = _mm_add_epi32( acc2, step );
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i c01 = _mm_packs_epi32( _mm_srai_epi32( acc0, 16 ), _mm_srai_epi32( acc1, 16 ) );
+		__m128i c23 = _mm_packs_epi32( _mm_srai_epi32( acc2, 16 ), _mm_srai_epi32( acc3, 16 ) );
+		storeColors( dst + i, _mm_packus_epi16( c01, c23 ) );
+		acc0 = _mm_add_epi32( acc0, step4 );
+		acc1 = _mm_add_epi32( acc1, step4 );
+		acc2 = _mm_add_epi32( acc2, step4 );
+		acc3 = _mm_add_epi32( acc3, step4 );
+	}
+	gradientScalar( dst, i, count, gs );
+}
+
+
+//======================================================================================================================
+//  AVX2 implementation
+
+ORGB_TARGET_AVX2 static inline __m256i loadColors8( const Color * src )
+{
+	return _mm256_loadu_si256( reinterpret_cast< const __m256i * >( src ) );
+}
+
+ORGB_TARGET_AVX2 static inline void storeColors8( Color * dst, __m256i colors )
+{
+	_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst ), colors );
+}
+
+ORGB_TARGET_AVX2 static inline __m256i div255AVX2( __m256i x )
+{
+	x = _mm256_add_epi16( x, _mm256_set1_epi16( 128 ) );
+	return _mm256_srli_epi16( _mm256_add_epi16( x, _mm256_srli_epi16( x, 8 ) ), 8 );
+}
+
+ORGB_TARGET_AVX2 static void fillAVX2( Color * dst, size_t count, Color color )
+{
+	int32_t bits;
+	memcpy( &bits, &color, sizeof(bits) );
+	const __m256i vec = _mm256_set1_epi32( bits );
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		storeColors8( dst + i, vec );
+	fillSSE2( dst + i, count - i, color );
+}
+
+// The unpack and pack instructions work within 128-bit lanes, so unpacking and packing back restores the order.
+
+ORGB_TARGET_AVX2 static void scaleAVX2( Color * dst, size_t count, Color factors )
+{
+	int32_t bits;
+	memcpy( &bits, &factors, sizeof(bits) );
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i factors16 = _mm256_unpacklo_epi8( _mm256_set1_epi32( bits ), zero );
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i colors = loadColors8( dst + i );
+		__m256i lo = div255AVX2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( colors, zero ), factors16 ) );
+		__m256i hi = div255AVX2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( colors, zero ), factors16 ) );
+		storeColors8( dst + i, _mm256_packus_epi16( lo, hi ) );
+	}
+	scaleSSE2( dst + i, count - i, factors );
+}
+
+ORGB_TARGET_AVX2 static void blendAVX2( Color * dst, const Color * from, const Color * to, size_t count, uint8_t weight )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i w1 = _mm256_set1_epi16( short( weight ) );
+	const __m256i w0 = _mm256_set1_epi16( short( 255 - weight ) );
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i a = loadColors8( from + i );
+		__m256i b = loadColors8( to + i );
+		__m256i lo = _mm256_add_epi16(
+			_mm256_mullo_epi16( _mm256_unpacklo_epi8( a, zero ), w0 ),
+			_mm256_mullo_epi16( _mm256_unpacklo_epi8( b, zero ), w1 )
+		);
+		__m256i hi = _mm256_add_epi16(
+			_mm256_mullo_epi16( _mm256_unpackhi_epi8( a, zero ), w0 ),
+			_mm256_mullo_epi16( _mm256_unpackhi_epi8( b, zero ), w1 )
+		);
+		storeColors8( dst + i, _mm256_packus_epi16( div255AVX2( lo ), div255AVX2( hi ) ) );
+	}
+	blendSSE2( dst + i, from + i, to + i, count - i, weight );
+}
+
+ORGB_TARGET_AVX2 static void addAVX2( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		storeColors8( dst + i, _mm256_adds_epu8( loadColors8( dst + i ), loadColors8( src + i ) ) );
+	addSSE2( dst + i, src + i, count - i );
+}
+
+ORGB_TARGET_AVX2 static void maxAVX2( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		storeColors8( dst + i, _mm256_max_epu8( loadColors8( dst + i ), loadColors8( src + i ) ) );
+	maxSSE2( dst + i, src + i, count - i );
+}
+
+ORGB_TARGET_AVX2 static void multiplyAVX2( Color * dst, const Color * src, size_t count )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i a = loadColors8( dst + i );
+		__m256i b = loadColors8( src + i );
+		__m256i lo = div255AVX2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( a, zero ), _mm256_unpacklo_epi8( b, zero ) ) );
+		__m256i hi = div255AVX2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( a, zero ), _mm256_unpackhi_epi8( b, zero ) ) );
+		storeColors8( dst + i, _mm256_packus_epi16( lo, hi ) );
+	}
+	multiplySSE2( dst + i, src + i, count - i );
+}
+
+#endif // ORGB_SIMD_X86
+
+
+//======================================================================================================================
+//  NEON implementation
+
+#if defined(ORGB_SIMD_NEON)
+
+static inline uint8x16_t loadColors( const Color * src )
+{
+	return vld1q_u8( reinterpret_cast< const uint8_t * >( src ) );
+}
+
+static inline void storeColors( Color * dst, uint8x16_t colors )
+{
+	vst1q_u8( reinterpret_cast< uint8_t * >( dst ), colors );
+}
+
+static inline uint8x16_t colorToVector( Color color )
+{
+	uint32_t bits;
+	memcpy( &bits, &color, sizeof(bits) );
+	return vreinterpretq_u8_u32( vdupq_n_u32( bits ) );
+}
+
+// round( x / 255 ) for each 16-bit lane, narrowed to 8 bits
+static inline uint8x8_t div255NEON( uint16x8_t x )
+{
+	x = vaddq_u16( x, vdupq_n_u16( 128 ) );
+	return vshrn_n_u16( vsraq_n_u16( x, x, 8 ), 8 );
+}
+
+static void fillNEON( Color * dst, size_t count, Color color )
+{
+	const uint8x16_t vec = colorToVector( color );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, vec );
+	fillScalar( dst + i, count - i, color );
+}
+
+static void scaleNEON( Color * dst, size_t count, Color factors )
+{
+	const uint8x8_t factors8 = vget_low_u8( colorToVector( factors ) );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		uint8x16_t colors = loadColors( dst + i );
+		uint8x8_t lo = div255NEON( vmull_u8( vget_low_u8( colors ), factors8 ) );
+		uint8x8_t hi = div255NEON( vmull_u8( vget_high_u8( colors ), factors8 ) );
+		storeColors( dst + i, vcombine_u8( lo, hi ) );
+	}
+	scaleScalar( dst + i, count - i, factors );
+}
+
+static void blendNEON( Color * dst, const Color * from, const Color * to, size_t count, uint8_t weight )
+{
+	const uint8x8_t w1 = vdup_n_u8( weight );
+	const uint8x8_t w0 = vdup_n_u8( uint8_t( 255 - weight ) );
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		uint8x16_t a = loadColors( from + i );
+		uint8x16_t b = loadColors( to + i );
+		uint8x8_t lo = div255NEON( vmlal_u8( vmull_u8( vget_low_u8( a ), w0 ), vget_low_u8( b ), w1 ) );
+		uint8x8_t hi = div255NEON( vmlal_u8( vmull_u8( vget_high_u8( a ), w0 ), vget_high_u8( b ), w1 ) );
+		storeColors( dst + i, vcombine_u8( lo, hi ) );
+	}
+	blendScalar( dst + i, from + i, to + i, count - i, weight );
+}
+
+static void addNEON( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, vqaddq_u8( loadColors( dst + i ), loadColors( src + i ) ) );
+	addScalar( dst + i, src + i, count - i );
+}
+
+static void maxNEON( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		storeColors( dst + i, vmaxq_u8( loadColors( dst + i ), loadColors( src + i ) ) );
+	maxScalar( dst + i, src + i, count - i );
+}
+
+static void multiplyNEON( Color * dst, const Color * src, size_t count )
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		uint8x16_t a = loadColors( dst + i );
+		uint8x16_t b = loadColors( src + i );
+		uint8x8_t lo = div255NEON( vmull_u8( vget_low_u8( a ), vget_low_u8( b ) ) );
+		uint8x8_t hi = div255NEON( vmull_u8( vget_high_u8( a ), vget_high_u8( b ) ) );
+		storeColors( dst + i, vcombine_u8( lo, hi ) );
+	}
+	multiplyScalar( dst + i, src + i, count - i );
+}
+
+#endif // ORGB_SIMD_NEON
+
+
+//======================================================================================================================
+//  runtime dispatch
+
+struct ColorKernelTable
+{
+	const char * name;
+	void (* fill)( Color * dst, size_t count, Color color );
+	void (* scale)( Color * dst, size_t count, Color factors );
+	void (* blend)( Color * dst, const Color * from, const Color * to, size_t count, uint8_t weight );
+	void (* add)( Color * dst, const Color * src, size_t count );
+	void (* max)( Color * dst, const Color * src, size_t count );
+	void (* multiply)( Color * dst, const Color * src, size_t count );
+	void (* gradient)( Color * dst, size_t count, Color from, Color to );
+};
+
+static ColorKernelTable selectColorKernels() noexcept
+{
+	const CpuFeatures & cpu = cpuFeatures();
+	(void)cpu;
+
+ #if defined(ORGB_SIMD_X86)
+	if (cpu.avx2)
+		return { "AVX2", fillAVX2, scaleAVX2, blendAVX2, addAVX2, maxAVX2, multiplyAVX2, gradientSSE2 };
+	if (cpu.sse2)
+		return { "SSE2", fillSSE2, scaleSSE2, blendSSE2, addSSE2, maxSSE2, multiplySSE2, gradientSSE2 };
+ #elif defined(ORGB_SIMD_NEON)
+	if (cpu.neon)
+		return { "NEON", fillNEON, scaleNEON, blendNEON, addNEON, maxNEON, multiplyNEON, gradientPortable };
+ #endif
+
+	return { "portable", fillScalar, scaleScalar, blendScalar, addScalar, maxScalar, multiplyScalar, gradientPortable };
+}
+
+static const ColorKernelTable & colorKernels() noexcept
+{
+	static const ColorKernelTable table = selectColorKernels();
+	return table;
+}
+
+
+//======================================================================================================================
+//  public API
+
+void fillColors( Span< Color > dst, Color color ) noexcept
+{
+	colorKernels().fill( dst.data(), dst.size(), color );
+}
+
+void scaleColors( Span< Color > dst, uint8_t brightness ) noexcept
+{
+	Color factors( brightness, brightness, brightness );
+	factors.padding = 255;
+	colorKernels().scale( dst.data(), dst.size(), factors );
+}
+
+void scaleColors( Span< Color > dst, Color factors ) noexcept
+{
+	factors.padding = 255;
+	colorKernels().scale( dst.data(), dst.size(), factors );
+}
+
+void blendColors( Span< Color > dst, Span< const Color > from, Span< const Color > to, uint8_t weight ) noexcept
+{
+	size_t count = std::min( dst.size(), std::min( from.size(), to.size() ) );
+	colorKernels().blend( dst.data(), from.data(), to.data(), count, weight );
+}
+
+void addColors( Span< Color > dst, Span< const Color > src ) noexcept
+{
+	colorKernels().add( dst.data(), src.data(), std::min( dst.size(), src.size() ) );
+}
+
+void maxColors( Span< Color > dst, Span< const Color > src ) noexcept
+{
+	colorKernels().max( dst.data(), src.data(), std::min( dst.size(), src.size() ) );
+}
+
+void multiplyColors( Span< Color > dst, Span< const Color > src ) noexcept
+{
+	colorKernels().multiply( dst.data(), src.data(), std::min( dst.size(), src.size() ) );
+}
+
+void fillGradient( Span< Color > dst, Color from, Color to ) noexcept
+{
+	if (dst.empty())
+		return;
+
+	colorKernels().gradient( dst.data(), dst.size(), from, to );
+
+	// the fixed point steps are rounded, so make sure the gradient really ends where it should
+	dst[ dst.size() - 1 ] = Color( to.r, to.g, to.b );
+	dst[ dst.size() - 1 ].padding = 0;
+}
+
+const char * colorKernelsImplementation() noexcept
+{
+	return colorKernels().name;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
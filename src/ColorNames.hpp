@@ -0,0 +1,262 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: table of named colors with a perfect hash lookup
+//======================================================================================================================
+
+#ifndef OPENRGB_COLOR_NAMES_INCLUDED
+#define OPENRGB_COLOR_NAMES_INCLUDED
+
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  The names are the CSS named colors, with one exception: "green" stays 00FF00 as it always was in this library,
+//  the CSS green (008000) is not available by name.
+//
+//  The lookup hashes the lowercased name with FNV-1a starting from colorNameHashSeed and takes the top 10 bits as an
+//  index into colorNameSlots. The seed was searched for offline so that no two names land in the same slot, the
+//  static_assert below verifies it at compile time. When changing the names, find a new seed and regenerate the slots.
+
+struct NamedColor
+{
+	const char * name;
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+};
+
+static constexpr NamedColor namedColors [] =
+{
+	{ "aliceblue",             0xF0, 0xF8, 0xFF },
+	{ "antiquewhite",          0xFA, 0xEB, 0xD7 },
+	{ "aqua",                  0x00, 0xFF, 0xFF },
+	{ "aquamarine",            0x7F, 0xFF, 0xD4 },
+	{ "azure",                 0xF0, 0xFF, 0xFF },
+	{ "beige",                 0xF5, 0xF5, 0xDC },
+	{ "bisque",                0xFF, 0xE4, 0xC4 },
+	{ "black",                 0x00, 0x00, 0x00 },
+	{ "blanchedalmond",        0xFF, 0xEB, 0xCD },
+	{ "blue",                  0x00, 0x00, 0xFF },
+	{ "blueviolet",            0x8A, 0x2B, 0xE2 },
+	{ "brown",                 0xA5, 0x2A, 0x2A },
+	{ "burlywood",             0xDE, 0xB8, 0x87 },
+	{ "cadetblue",             0x5F, 0x9E, 0xA0 },
+	{ "chartreuse",            0x7F, 0xFF, 0x00 },
+	{ "chocolate",             0xD2, 0x69, 0x1E },
+	{ "coral",                 0xFF, 0x7F, 0x50 },
+	{ "cornflowerblue",        0x64, 0x95, 0xED },
+	{ "cornsilk",              0xFF, 0xF8, 0xDC },
+	{ "crimson",               0xDC, 0x14, 0x3C },
+	{ "cyan",                  0x00, 0xFF, 0xFF },
+	{ "darkblue",              0x00, 0x00, 0x8B },
+	{ "darkcyan",              0x00, 0x8B, 0x8B },
+	{ "darkgoldenrod",         0xB8, 0x86, 0x0B },
+	{ "darkgray",              0xA9, 0xA9, 0xA9 },
+	{ "darkgreen",             0x00, 0x64, 0x00 },
+	{ "darkgrey",              0xA9, 0xA9, 0xA9 },
+	{ "darkkhaki",             0xBD, 0xB7, 0x6B },
+	{ "darkmagenta",           0x8B, 0x00, 0x8B },
+	{ "darkolivegreen",        0x55, 0x6B, 0x2F },
+	{ "darkorange",            0xFF, 0x8C, 0x00 },
+	{ "darkorchid",            0x99, 0x32, 0xCC },
+	{ "darkred",               0x8B, 0x00, 0x00 },
+	{ "darksalmon",            0xE9, 0x96, 0x7A },
+	{ "darkseagreen",          0x8F, 0xBC, 0x8F },
+	{ "darkslateblue",         0x48, 0x3D, 0x8B },
+	{ "darkslategray",         0x2F, 0x4F, 0x4F },
+	{ "darkslategrey",         0x2F, 0x4F, 0x4F },
+	{ "darkturquoise",         0x00, 0xCE, 0xD1 },
+	{ "darkviolet",            0x94, 0x00, 0xD3 },
+	{ "deeppink",              0xFF, 0x14, 0x93 },
+	{ "deepskyblue",           0x00, 0xBF, 0xFF },
+	{ "dimgray",               0x69, 0x69, 0x69 },
+	{ "dimgrey",               0x69, 0x69, 0x69 },
+	{ "dodgerblue",            0x1E, 0x90, 0xFF },
+	{ "firebrick",             0xB2, 0x22, 0x22 },
+	{ "floralwhite",           0xFF, 0xFA, 0xF0 },
+	{ "forestgreen",           0x22, 0x8B, 0x22 },
+	{ "fuchsia",               0xFF, 0x00, 0xFF },
+	{ "gainsboro",             0xDC, 0xDC, 0xDC },
+	{ "ghostwhite",            0xF8, 0xF8, 0xFF },
+	{ "gold",                  0xFF, 0xD7, 0x00 },
+	{ "goldenrod",             0xDA, 0xA5, 0x20 },
+	{ "gray",                  0x80, 0x80, 0x80 },
+	{ "green",                 0x00, 0xFF, 0x00 },
+	{ "greenyellow",           0xAD, 0xFF, 0x2F },
+	{ "grey",                  0x80, 0x80, 0x80 },
+	{ "honeydew",              0xF0, 0xFF, 0xF0 },
+	{ "hotpink",               0xFF, 0x69, 0xB4 },
+	{ "indianred",             0xCD, 0x5C, 0x5C },
+	{ "indigo",                0x4B, 0x00, 0x82 },
+	{ "ivory",                 0xFF, 0xFF, 0xF0 },
+	{ "khaki",                 0xF0, 0xE6, 0x8C },
+	{ "lavender",              0xE6, 0xE6, 0xFA },
+	{ "lavenderblush",         0xFF, 0xF0, 0xF5 },
+	{ "lawngreen",             0x7C, 0xFC, 0x00 },
+	{ "lemonchiffon",          0xFF, 0xFA, 0xCD },
+	{ "lightblue",             0xAD, 0xD8, 0xE6 },
+	{ "lightcoral",            0xF0, 0x80, 0x80 },
+	{ "lightcyan",             0xE0, 0xFF, 0xFF },
+	{ "lightgoldenrodyellow",  0xFA, 0xFA, 0xD2 },
+	{ "lightgray",             0xD3, 0xD3, 0xD3 },
+	{ "lightgreen",            0x90, 0xEE, 0x90 },
+	{ "lightgrey",             0xD3, 0xD3, 0xD3 },
+	{ "lightpink",             0xFF, 0xB6, 0xC1 },
+	{ "lightsalmon",           0xFF, 0xA0, 0x7A },
+	{ "lightseagreen",         0x20, 0xB2, 0xAA },
+	{ "lightskyblue",          0x87, 0xCE, 0xFA },
+	{ "lightslategray",        0x77, 0x88, 0x99 },
+	{ "lightslategrey",        0x77, 0x88, 0x99 },
+	{ "lightsteelblue",        0xB0, 0xC4, 0xDE },
+	{ "lightyellow",           0xFF, 0xFF, 0xE0 },
+	{ "lime",                  0x00, 0xFF, 0x00 },
+	{ "limegreen",             0x32, 0xCD, 0x32 },
+	{ "linen",                 0xFA, 0xF0, 0xE6 },
+	{ "magenta",               0xFF, 0x00, 0xFF },
+	{ "maroon",                0x80, 0x00, 0x00 },
+	{ "mediumaquamarine",      0x66, 0xCD, 0xAA },
+	{ "mediumblue",            0x00, 0x00, 0xCD },
+	{ "mediumorchid",          0xBA, 0x55, 0xD3 },
+	{ "mediumpurple",          0x93, 0x70, 0xDB },
+	{ "mediumseagreen",        0x3C, 0xB3, 0x71 },
+	{ "mediumslateblue",       0x7B, 0x68, 0xEE },
+	{ "mediumspringgreen",     0x00, 0xFA, 0x9A },
+	{ "mediumturquoise",       0x48, 0xD1, 0xCC },
+	{ "mediumvioletred",       0xC7, 0x15, 0x85 },
+	{ "midnightblue",          0x19, 0x19, 0x70 },
+	{ "mintcream",             0xF5, 0xFF, 0xFA },
+	{ "mistyrose",             0xFF, 0xE4, 0xE1 },
+	{ "moccasin",              0xFF, 0xE4, 0xB5 },
+	{ "navajowhite",           0xFF, 0xDE, 0xAD },
+	{ "navy",                  0x00, 0x00, 0x80 },
+	{ "oldlace",               0xFD, 0xF5, 0xE6 },
+	{ "olive",                 0x80, 0x80, 0x00 },
+	{ "olivedrab",             0x6B, 0x8E, 0x23 },
+	{ "orange",                0xFF, 0xA5, 0x00 },
+	{ "orangered",             0xFF, 0x45, 0x00 },
+	{ "orchid",                0xDA, 0x70, 0xD6 },
+	{ "palegoldenrod",         0xEE, 0xE8, 0xAA },
+	{ "palegreen",             0x98, 0xFB, 0x98 },
+	{ "paleturquoise",         0xAF, 0xEE, 0xEE },
+	{ "palevioletred",         0xDB, 0x70, 0x93 },
+	{ "papayawhip",            0xFF, 0xEF, 0xD5 },
+	{ "peachpuff",             0xFF, 0xDA, 0xB9 },
+	{ "peru",                  0xCD, 0x85, 0x3F },
+	{ "pink",                  0xFF, 0xC0, 0xCB },
+	{ "plum",                  0xDD, 0xA0, 0xDD },
+	{ "powderblue",            0xB0, 0xE0, 0xE6 },
+	{ "purple",                0x80, 0x00, 0x80 },
+	{ "rebeccapurple",         0x66, 0x33, 0x99 },
+	{ "red",                   0xFF, 0x00, 0x00 },
+	{ "rosybrown",             0xBC, 0x8F, 0x8F },
+	{ "royalblue",             0x41, 0x69, 0xE1 },
+	{ "saddlebrown",           0x8B, 0x45, 0x13 },
+	{ "salmon",                0xFA, 0x80, 0x72 },
+	{ "sandybrown",            0xF4, 0xA4, 0x60 },
+	{ "seagreen",              0x2E, 0x8B, 0x57 },
+	{ "seashell",              0xFF, 0xF5, 0xEE },
+	{ "sienna",                0xA0, 0x52, 0x2D },
+	{ "silver",                0xC0, 0xC0, 0xC0 },
+	{ "skyblue",               0x87, 0xCE, 0xEB },
+	{ "slateblue",             0x6A, 0x5A, 0xCD },
+	{ "slategray",             0x70, 0x80, 0x90 },
+	{ "slategrey",             0x70, 0x80, 0x90 },
+	{ "snow",                  0xFF, 0xFA, 0xFA },
+	{ "springgreen",           0x00, 0xFF, 0x7F },
+	{ "steelblue",             0x46, 0x82, 0xB4 },
+	{ "tan",                   0xD2, 0xB4, 0x8C },
+	{ "teal",                  0x00, 0x80, 0x80 },
+	{ "thistle",               0xD8, 0xBF, 0xD8 },
+	{ "tomato",                0xFF, 0x63, 0x47 },
+	{ "turquoise",             0x40, 0xE0, 0xD0 },
+	{ "violet",                0xEE, 0x82, 0xEE },
+	{ "wheat",                 0xF5, 0xDE, 0xB3 },
+	{ "white",                 0xFF, 0xFF, 0xFF },
+	{ "whitesmoke",            0xF5, 0xF5, 0xF5 },
+	{ "yellow",                0xFF, 0xFF, 0x00 },
+	{ "yellowgreen",           0x9A, 0xCD, 0x32 },
+};
+
+constexpr size_t namedColorCount = sizeof( namedColors ) / sizeof( namedColors[0] );
+constexpr size_t minColorNameLength = 3;   // "red", "tan"
+constexpr size_t maxColorNameLength = 20;  // "lightgoldenrodyellow"
+
+constexpr uint32_t colorNameHashSeed = 27249;
+constexpr uint32_t colorNameHashBits = 10;
+
+/// index + 1 into namedColors for each possible hash, 0 for hashes that don't belong to any name
+static constexpr uint8_t colorNameSlots [ 1 << colorNameHashBits ] =
+{
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 134,   0,  52,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  31,   0,
+	  0,   0,  87,   0, 125,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  85,   0,   0,   0,   0,  44,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,  12,   0,   0, 114,   0,   0,   0,  68,   0,  50,   0,   0,   0,   0,   0,  41,   0,   0,   0,   0,   0,   0,  43,   0,   0,   0,   0,
+	  0,   0,  60,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 105,   0,   0,   0,   0,   0,   0,   0,   0,   5,   0,
+	 81,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  42,   0,  97,   0,   0,   0,   0,   0,   0,   0,   0,  18,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,  24,   0,  34,   0,   0,   4,  10,   0,  30,   0,   0, 130,   0,   0,   0, 122, 138,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0, 143,   0,   0,   0,   0,   0,   0,  37,   0,   0,   0,   0,  29,   0, 124,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 136, 103,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,  38,   0,   0, 118,   0,   0,   0,  17,   0,   0,   0,   0,   0, 112,   0,   0,   0,   0, 142,   0,   0,   0,   0,
+	  0,   0,   0, 116,   0,   0,   0,   0, 123,   0,   9,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 104,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0, 148, 121,   0,   0,  20,   0,   0,   0,   0,   0,   0,   0, 107,   0,   0,  59,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	 89,  95, 102,   0,   0,   0,   0, 108,   0,   0,   0,  71,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  21,  54,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 131,   0,   0,   0,  35,   0, 128,  83,  63,   0,   0,   0,   0,   0,   0,   0,   0,  57,   0,   0,
+	  0,   0,   0,  45,   0,   0,   0, 117,   0,   0,   0,   0,   0,   0,  69,   0,   0,   0, 113,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 144,   0,   0,  28,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,  33,   0,   0,   0,   0,   0,   0,  19,   0,   0,   0,   0,   0,   0,   0,   0,  11,   0,   0,   0, 127,  66,   0,   0,
+	  0,  91,   0, 137,   1,   0,   0,   0,  99,   0,  49,  64,   0,   0,   0,   0,   0, 126,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,  72,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  86,   0,   0,  32,   0,  76,   0,   0,   0,   0,   0,   0,  61,   0,   0,   0,   0,   0,  22,
+	  0,  74, 106,   0,   0,   0,   0,   0,   0,   0, 132,   0,   0,   0,  88,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  67,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0, 119,   0,   7,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  47,   0,   0, 115,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0, 147,   0,   0,   0,   0,   0,   0,   0,  56,   0,  15,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,  62,   0,   0,   0,  65,   0,  53,   0,   0,   0,   0,   0,   0,  14,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,  94,   0,   0,   0,   0,   0,  77,   0,  46,   0,   0,   0, 135,   0,   0,   0,   3,   0,   0,   0,   0,   0,   0,   0,  55, 100,  13,   0,   0,
+	  0,  75,   0,   0,   0,   0, 145,   0,   0,   0,   0,   0,   0,  36,   0,   0,   0,   0,   0,  16,   0,   0,   0,  25,   0,   0,   0,   0,   0,   0,  96,   0,
+	 92,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   8, 139,   0,  27,   0,  78,   0,   0,   0,   0,   0,   0,
+	129,   0,   0,   0,   0,   0,   0,   0,   0,   0, 140,   0,   0,   0,  58,  90,   0,   0,  40,   0,   0,   0,   0,   0,   0,   0,   0,  79,   0,   0,   0,   0,
+	 26,   0,   0,   0,   0,   0,  93,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  39,   0,   0, 120,   0,   0,   0,   0,   0,   0,  80,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   6,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  73,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 146,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  48,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	 82,   0,   0,   0,   0,  70,   0,   0,   0,   0,  98,   0,   0,   0,   0,   0, 111,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 101,   0,   0,   0,  23,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   0,   0,   0,   0,   0, 110,   0,   0,   0,  51,   0,   0,   0,   0,   0,   0,   0, 141,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 133,   0,   0, 109,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  84,   0,   0,   0,   0,   0,
+};
+
+constexpr char toLowerAscii( char c ) noexcept
+{
+	return (c >= 'A' && c <= 'Z') ? char( c - 'A' + 'a' ) : c;
+}
+
+constexpr uint32_t hashColorName( const char * name, uint32_t hash = colorNameHashSeed ) noexcept
+{
+	return *name ? hashColorName( name + 1, (hash ^ uint8_t( toLowerAscii( *name ) )) * 16777619u ) : hash;
+}
+
+constexpr uint32_t colorNameSlot( uint32_t hash ) noexcept
+{
+	return hash >> (32 - colorNameHashBits);
+}
+
+constexpr bool verifyColorNameSlots( size_t idx = 0 ) noexcept
+{
+	return idx == namedColorCount
+		|| (colorNameSlots[ colorNameSlot( hashColorName( namedColors[ idx ].name ) ) ] == idx + 1 && verifyColorNameSlots( idx + 1 ));
+}
+
+static_assert( namedColorCount < 256, "the slots can't index that many names" );
+static_assert( verifyColorNameSlots(), "the hash is no longer perfect, find a new seed and regenerate the slots" );
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_COLOR_NAMES_INCLUDED
@@ -0,0 +1,348 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: thread-safe client whose requests are executed by a dedicated I/O thread
+//======================================================================================================================
+
+#include <OpenRGB/ConcurrentClient.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <CppUtils-Essential/LangUtils.hpp>
+using fut::make_unique;
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+using std::vector;
+using std::unique_ptr;
+using std::future;
+using std::string;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  queue
+
+/// Job that only sends a message, its result is known only after the whole batch is written.
+struct ConcurrentClient::SendJob : public Job
+{
+	std::promise< RequestStatus > promise;
+	std::function< RequestStatus ( Client & ) > func;
+	vector< Color > colors;  ///< copy of the colors, so that the caller can reuse its buffer right away
+	RequestStatus status = RequestStatus::Success;
+
+	virtual bool isSendOnly() const noexcept override  { return true; }
+
+	virtual void run( Client & client ) noexcept override
+	{
+		status = func( client );  // the Client methods are noexcept
+	}
+
+	virtual void finish( RequestStatus batchStatus ) noexcept override
+	{
+		// a request that failed before reaching the batch keeps its own error
+		promise.set_value( status != RequestStatus::Success ? status : batchStatus );
+	}
+};
+
+struct ConcurrentClient::Impl
+{
+	Client client;
+
+	// Intrusive multi-producer single-consumer queue by Dmitry Vyukov. The producers only exchange the head,
+	// the consumer owns the tail, so there is no lock and no compare-and-swap loop that could starve a producer.
+	struct Stub : public Job
+	{
+		virtual void run( Client & ) noexcept override {}
+	};
+	std::atomic< Job * > head;
+	Job * tail;
+	Stub stub;
+
+	// The consumer sleeps on the condition variable only when the queue is empty, the producers touch the mutex
+	// only when they see the consumer is going to sleep.
+	std::atomic< bool > waiting { false };
+	std::atomic< bool > stop { false };
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+
+	std::thread ioThread;
+
+	Impl( Client && client ) : client( std::move( client ) ), head( &stub ), tail( &stub ) {}
+
+	void push( Job * job ) noexcept;
+	Job * pop() noexcept;
+	bool empty() const noexcept;
+	void wakeConsumer() noexcept;
+	void waitForJobs() noexcept;
+};
+
+void ConcurrentClient::Impl::push( Job * job ) noexcept
+{
+	job->next.store( nullptr, std::memory_order_relaxed );
+	// sequentially consistent, so that it can't be reordered with the following check of the waiting flag
+	Job * prev = head.exchange( job );
+	// between the exchange and this store the consumer sees the queue as empty, the wake-up after it fixes that
+	prev->next.store( job, std::memory_order_release );
+}
+
+ConcurrentClient::Job * ConcurrentClient::Impl::pop() noexcept
+{
+	Job * first = tail;
+	Job * next = first->next.load( std::memory_order_acquire );
+	if (first == &stub)
+	{
+		if (!next)
+			return nullptr;
+		tail = next;
+		first = next;
+		next = next->next.load( std::memory_order_acquire );
+	}
+	if (next)
+	{
+		tail = next;
+		return first;
+	}
+	if (first != head.load( std::memory_order_acquire ))
+	{
+		return nullptr;  // a producer is in the middle of push, its job will be visible in a moment
+	}
+	// the last job can be taken only when there is something behind it
+	push( &stub );
+	next = first->next.load( std::memory_order_acquire );
+	if (next)
+	{
+		tail = next;
+		return first;
+	}
+	return nullptr;
+}
+
+bool ConcurrentClient::Impl::empty() const noexcept
+{
+	// when the tail is a job, it has not been popped yet
+	return tail == &stub && head.load() == &stub;
+}
+
+void ConcurrentClient::Impl::wakeConsumer() noexcept
+{
+	if (waiting.load() && waiting.exchange( false ))
+	{
+		std::lock_guard< std::mutex > lock( mutex );
+		wakeUp.notify_one();
+	}
+}
+
+void ConcurrentClient::Impl::waitForJobs() noexcept
+{
+	waiting.store( true );
+	// a job pushed before the flag was set would not wake us up
+	if (!empty() || stop.load())
+	{
+		waiting.store( false );
+		return;
+	}
+	std::unique_lock< std::mutex > lock( mutex );
+	wakeUp.wait( lock, [this]() { return !waiting.load() || stop.load(); } );
+	waiting.store( false );
+}
+
+
+//======================================================================================================================
+//  ConcurrentClient
+
+ConcurrentClient::ConcurrentClient( const std::string & clientName )
+:
+	ConcurrentClient( Client( clientName ) )
+{}
+
+ConcurrentClient::ConcurrentClient( Client && client )
+:
+	_impl( make_unique< Impl >( std::move( client ) ) )
+{
+	_impl->ioThread = std::thread( &ConcurrentClient::ioLoop, this );
+}
+
+ConcurrentClient::~ConcurrentClient() noexcept
+{
+	_impl->stop.store( true );
+	{
+		// the consumer might be just checking the flags, the lock makes sure it either sees them or gets notified
+		std::lock_guard< std::mutex > lock( _impl->mutex );
+		_impl->waiting.store( false );
+		_impl->wakeUp.notify_one();
+	}
+	_impl->ioThread.join();
+}
+
+void ConcurrentClient::submit( std::unique_ptr< Job > job )
+{
+	_impl->push( job.release() );
+	_impl->wakeConsumer();
+}
+
+// A batch is written when it reaches any of these, so that a producer that never stops doesn't make the batch grow
+// without limit while its first requests keep waiting. Big enough to still send a whole frame of most setups at once.
+static const size_t maxBatchBytes = 256 * 1024;
+static const size_t maxBatchJobs = 1024;
+
+void ConcurrentClient::ioLoop() noexcept
+{
+	Impl & impl = *_impl;
+	vector< Job * > batch;  // send-only jobs waiting for the batch to be written
+
+	auto writeBatch = [&]()
+	{
+		RequestStatus status = impl.client.endBatch();
+		for (Job * job : batch)
+		{
+			job->finish( status );
+			delete job;
+		}
+		batch.clear();
+	};
+
+	while (true)
+	{
+		Job * job = impl.pop();
+		if (!job)
+		{
+			// nothing more to put into the current batch, send it before sleeping
+			if (!batch.empty())
+			{
+				writeBatch();
+				continue;
+			}
+			if (impl.stop.load() && impl.empty())
+			{
+				break;
+			}
+			impl.waitForJobs();
+			continue;
+		}
+
+		if (job->isSendOnly())
+		{
+			if (batch.empty())
+				impl.client.beginBatch();
+			job->run( impl.client );
+			batch.push_back( job );
+			if (impl.client.batchSize() >= maxBatchBytes || batch.size() >= maxBatchJobs)
+				writeBatch();
+		}
+		else
+		{
+			// the request waits for a reply, so everything before it must be sent first
+			if (!batch.empty())
+				writeBatch();
+			job->run( impl.client );
+			delete job;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  requests
+
+std::future< ConnectStatus > ConcurrentClient::connect( const std::string & host, uint16_t port )
+{
+	return execute( [host, port]( Client & client ) { return client.connect( host, port ); } );
+}
+
+std::future< bool > ConcurrentClient::disconnect()
+{
+	return execute( []( Client & client ) { return client.disconnect(); } );
+}
+
+std::future< DeviceListResult > ConcurrentClient::requestDeviceList()
+{
+	return execute( []( Client & client ) { return client.requestDeviceList(); } );
+}
+
+std::future< DeviceInfoResult > ConcurrentClient::requestDeviceInfo( uint32_t deviceIdx )
+{
+	return execute( [deviceIdx]( Client & client ) { return client.requestDeviceInfo( deviceIdx ); } );
+}
+
+std::future< UpdateStatus > ConcurrentClient::checkForDeviceUpdates()
+{
+	return execute( []( Client & client ) { return client.checkForDeviceUpdates(); } );
+}
+
+std::future< RequestStatus > ConcurrentClient::submitSend( std::unique_ptr< SendJob > job )
+{
+	auto future = job->promise.get_future();
+	submit( std::move( job ) );
+	return future;
+}
+
+std::future< RequestStatus > ConcurrentClient::switchToCustomMode( const Device & device )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&device]( Client & client ) { return client.switchToCustomMode( device ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::changeMode( const Device & device, const Mode & mode )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&device, &mode]( Client & client ) { return client.changeMode( device, mode ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setDeviceColor( const Device & device, Color color )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&device, color]( Client & client ) { return client.setDeviceColor( device, color ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setZoneColor( const Zone & zone, Color color )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&zone, color]( Client & client ) { return client.setZoneColor( zone, color ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setDeviceColors( const Device & device, Span< const Color > colors )
+{
+	auto job = make_unique< SendJob >();
+	job->colors.assign( colors.begin(), colors.end() );
+	const vector< Color > & copy = job->colors;
+	job->func = [&device, &copy]( Client & client ) { return client.setDeviceColors( device, copy ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setZoneColors( const Zone & zone, Span< const Color > colors )
+{
+	auto job = make_unique< SendJob >();
+	job->colors.assign( colors.begin(), colors.end() );
+	const vector< Color > & copy = job->colors;
+	job->func = [&zone, &copy]( Client & client ) { return client.setZoneColors( zone, copy ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setZoneSize( const Zone & zone, uint32_t newSize )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&zone, newSize]( Client & client ) { return client.setZoneSize( zone, newSize ); };
+	return submitSend( std::move( job ) );
+}
+
+std::future< RequestStatus > ConcurrentClient::setLEDColor( const LED & led, Color color )
+{
+	auto job = make_unique< SendJob >();
+	job->func = [&led, color]( Client & client ) { return client.setLEDColor( led, color ); };
+	return submitSend( std::move( job ) );
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
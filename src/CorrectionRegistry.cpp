@@ -0,0 +1,142 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: color corrections registered for devices and zones
+//======================================================================================================================
+
+#include "CorrectionRegistry.hpp"
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <CppUtils-Essential/LangUtils.hpp>
+using fut::make_unique;
+
+#include <algorithm>
+using std::vector;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+void CorrectionRegistry::set( uint32_t deviceIdx, const ColorCorrection & correction )
+{
+	DeviceEntry & entry = _devices[ deviceIdx ];
+	if (entry.correction)
+		*entry.correction = correction;
+	else
+		entry.correction = make_unique< ColorCorrection >( correction );
+}
+
+void CorrectionRegistry::set( uint32_t deviceIdx, uint32_t zoneIdx, const ColorCorrection & correction )
+{
+	DeviceEntry & entry = _devices[ deviceIdx ];
+	for (ZoneEntry & zone : entry.zones)
+	{
+		if (zone.zoneIdx == zoneIdx)
+		{
+			*zone.correction = correction;
+			return;
+		}
+	}
+	entry.zones.push_back({ zoneIdx, make_unique< ColorCorrection >( correction ) });
+}
+
+void CorrectionRegistry::remove( uint32_t deviceIdx ) noexcept
+{
+	auto iter = _devices.find( deviceIdx );
+	if (iter == _devices.end())
+		return;
+
+	iter->second.correction.reset();
+	if (iter->second.zones.empty())
+		_devices.erase( iter );
+}
+
+void CorrectionRegistry::remove( uint32_t deviceIdx, uint32_t zoneIdx ) noexcept
+{
+	auto iter = _devices.find( deviceIdx );
+	if (iter == _devices.end())
+		return;
+
+	vector< ZoneEntry > & zones = iter->second.zones;
+	zones.erase(
+		std::remove_if( zones.begin(), zones.end(), [ zoneIdx ]( const ZoneEntry & zone ) { return zone.zoneIdx == zoneIdx; } ),
+		zones.end()
+	);
+	if (zones.empty() && !iter->second.correction)
+		_devices.erase( iter );
+}
+
+const ColorCorrection * CorrectionRegistry::find( uint32_t deviceIdx ) const noexcept
+{
+	auto iter = _devices.find( deviceIdx );
+	return iter != _devices.end() ? iter->second.correction.get() : nullptr;
+}
+
+const ColorCorrection * CorrectionRegistry::find( uint32_t deviceIdx, uint32_t zoneIdx ) const noexcept
+{
+	auto iter = _devices.find( deviceIdx );
+	if (iter == _devices.end())
+		return nullptr;
+
+	for (const ZoneEntry & zone : iter->second.zones)
+	{
+		if (zone.zoneIdx == zoneIdx)
+			return zone.correction.get();
+	}
+	return iter->second.correction.get();
+}
+
+Span< const CorrectionSegment > CorrectionRegistry::makeSegments( const Device & device )
+{
+	vector< CorrectionSegment > & segments = _segments;
+	segments.clear();
+
+	auto iter = _devices.find( device.idx );
+	if (iter == _devices.end())
+		return segments;
+	const DeviceEntry & entry = iter->second;
+
+	if (entry.zones.empty())
+	{
+		if (entry.correction)
+			segments.push_back({ 0, uint32_t( device.leds.size() ), entry.correction.get() });
+		return segments;
+	}
+
+	for (const Zone & zone : device.zones)
+	{
+		const ColorCorrection * correction = find( device.idx, zone.idx );
+		if (correction)
+		{
+			// merge neighbouring zones with the same correction
+			if (!segments.empty() && segments.back().correction == correction && segments.back().first + segments.back().count == zone.start_idx)
+				segments.back().count += zone.leds_count;
+			else
+				segments.push_back({ zone.start_idx, zone.leds_count, correction });
+		}
+	}
+
+	return segments;
+}
+
+Span< const CorrectionSegment > CorrectionRegistry::makeSegments( const Zone & zone, size_t colorCount )
+{
+	_segments.clear();
+
+	const ColorCorrection * correction = find( zone.parentIdx, zone.idx );
+	if (correction)
+	{
+		_segments.push_back({ 0, uint32_t( colorCount ), correction });
+	}
+
+	return _segments;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,89 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: color corrections registered for devices and zones
+//======================================================================================================================
+
+#ifndef OPENRGB_CORRECTION_REGISTRY_INCLUDED
+#define OPENRGB_CORRECTION_REGISTRY_INCLUDED
+
+
+#include <OpenRGB/ColorCorrection.hpp>
+#include <OpenRGB/DeviceInfo.hpp>
+#include <OpenRGB/Span.hpp>
+#include "CorrectionSegment.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// Storage of the corrections registered in a Client.
+/** A zone correction has priority over the correction of its whole device. */
+class CorrectionRegistry
+{
+
+ public:
+
+	bool empty() const noexcept  { return _devices.empty(); }
+
+	void set( uint32_t deviceIdx, const ColorCorrection & correction );
+	void set( uint32_t deviceIdx, uint32_t zoneIdx, const ColorCorrection & correction );
+
+	void remove( uint32_t deviceIdx ) noexcept;
+	void remove( uint32_t deviceIdx, uint32_t zoneIdx ) noexcept;
+
+	void clear() noexcept  { _devices.clear(); }
+
+	/// Finds the correction of a whole device, returns nullptr when there is none.
+	const ColorCorrection * find( uint32_t deviceIdx ) const noexcept;
+
+	/// Finds the correction of a zone or its device, returns nullptr when there is none.
+	const ColorCorrection * find( uint32_t deviceIdx, uint32_t zoneIdx ) const noexcept;
+
+	/// Splits the LEDs of the device into segments with different corrections.
+	/** Segments of LEDs without any correction are left out.
+	  * The result is valid until the next call of makeSegments(...) or any modification of the registry. */
+	Span< const CorrectionSegment > makeSegments( const Device & device );
+
+	/// Makes a single segment for all colors of a zone.
+	/** The result is valid until the next call of makeSegments(...) or any modification of the registry. */
+	Span< const CorrectionSegment > makeSegments( const Zone & zone, size_t colorCount );
+
+ private:
+
+	struct ZoneEntry
+	{
+		uint32_t zoneIdx;
+		std::unique_ptr< ColorCorrection > correction;
+	};
+
+	struct DeviceEntry
+	{
+		std::unique_ptr< ColorCorrection > correction;  ///< for the whole device, may be null
+		std::vector< ZoneEntry > zones;
+	};
+
+	// the corrections are allocated separately, so that the pointers given to the messages don't move
+	std::unordered_map< uint32_t, DeviceEntry > _devices;
+
+	// kept between the calls, so that sending colors every frame doesn't allocate
+	std::vector< CorrectionSegment > _segments;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_CORRECTION_REGISTRY_INCLUDED
@@ -0,0 +1,37 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: range of LEDs sent with a color correction
+//======================================================================================================================
+
+#ifndef OPENRGB_CORRECTION_SEGMENT_INCLUDED
+#define OPENRGB_CORRECTION_SEGMENT_INCLUDED
+
+
+#include <OpenRGB/ColorCorrection.hpp>
+
+#include <cstdint>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// Range of LEDs within a device that should be sent with a specific correction.
+struct CorrectionSegment
+{
+	uint32_t first;  ///< index of the first color within the sent array
+	uint32_t count;  ///< number of colors
+	const ColorCorrection * correction;
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_CORRECTION_SEGMENT_INCLUDED
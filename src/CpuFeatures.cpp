@@ -0,0 +1,68 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: detection of SIMD instruction sets available at runtime
+//======================================================================================================================
+
+#include "CpuFeatures.hpp"
+
+#if defined(ORGB_SIMD_X86) && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+static CpuFeatures detectCpuFeatures() noexcept
+{
+	CpuFeatures features = { false, false, false };
+
+ #if defined(ORGB_SIMD_X86) && defined(_MSC_VER)
+
+	int info [4];
+	__cpuid( info, 0 );
+	int maxLeaf = info[0];
+
+	__cpuid( info, 1 );
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	bool osUsesXSave = (info[2] & (1 << 27)) != 0;
+	bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+	// AVX registers are usable only if the operating system saves them on context switch
+	if (maxLeaf >= 7 && osUsesXSave && hasAVX && (_xgetbv( 0 ) & 0x6) == 0x6)
+	{
+		__cpuidex( info, 7, 0 );
+		features.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+
+ #elif defined(ORGB_SIMD_X86)
+
+	__builtin_cpu_init();
+	features.sse2 = __builtin_cpu_supports( "sse2" );
+	features.avx2 = __builtin_cpu_supports( "avx2" );
+
+ #elif defined(ORGB_SIMD_NEON)
+
+	features.neon = true;
+
+ #endif
+
+	return features;
+}
+
+const CpuFeatures & cpuFeatures() noexcept
+{
+	static const CpuFeatures features = detectCpuFeatures();
+	return features;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,60 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: detection of SIMD instruction sets available at runtime
+//======================================================================================================================
+
+#ifndef OPENRGB_CPU_FEATURES_INCLUDED
+#define OPENRGB_CPU_FEATURES_INCLUDED
+
+
+#include <CppUtils-Essential/Essential.hpp>
+
+
+// Which SIMD code paths can be compiled in. Whether they can also be used is decided at runtime by cpuFeatures().
+// Define NO_SIMD to leave only the portable scalar code.
+#ifndef NO_SIMD
+	#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+		#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+			#define ORGB_SIMD_X86
+			// GCC and Clang need the functions using SSE2 and AVX2 to be marked, because 32-bit builds don't enable even SSE2
+			// by default, MSVC compiles the intrinsics without it
+			#if defined(__GNUC__) || defined(__clang__)
+				#define ORGB_TARGET_SSE2 __attribute__(( target("sse2") ))
+				#define ORGB_TARGET_AVX2 __attribute__(( target("avx2") ))
+			#else
+				#define ORGB_TARGET_SSE2
+				#define ORGB_TARGET_AVX2
+			#endif
+		#endif
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		// NEON cannot be detected in a portable way at runtime, so it is used only when the compiler is allowed to use it
+		#define ORGB_SIMD_NEON
+	#endif
+#endif
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+struct CpuFeatures
+{
+	bool sse2;
+	bool avx2;
+	bool neon;
+};
+
+/// Detects the instruction sets on the first call, then returns the cached result.
+const CpuFeatures & cpuFeatures() noexcept;
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_CPU_FEATURES_INCLUDED
@@ -264,6 +264,7 @@ Zone::Zone()
 	leds_min(),
 	leds_max(),
 	leds_count(),
+	start_idx(),
 	matrix_height(),
 	matrix_width(),
 	matrix_values()
@@ -401,6 +402,11 @@ Mode::Mode()
 {}
 
 size_t Mode::calcSize( uint32_t protocolVersion ) const noexcept
+{
+	return calcSize( protocolVersion, ModeParams( *this ) );
+}
+
+size_t Mode::calcSize( uint32_t protocolVersion, const ModeParams & params ) const noexcept
 {
 	size_t size = 0;
 
@@ -416,19 +422,24 @@ size_t Mode::calcSize( uint32_t protocolVersion ) const noexcept
 	}
 	size += sizeof( colors_min );
 	size += sizeof( colors_max );
-	size += sizeof( speed );
+	size += sizeof( params.speed );
 	if (protocolVersion >= 3)
 	{
-		size += sizeof( brightness );
+		size += sizeof( params.brightness );
 	}
-	size += sizeof( direction );
+	size += sizeof( params.direction );
 	size += sizeof( color_mode );
-	size += protocol::sizeofArray( colors );
+	size += protocol::sizeofColors( params.colors );
 
 	return size;
 }
 
 void Mode::serialize( BinaryOutputStream & stream, uint32_t protocolVersion ) const
+{
+	serialize( stream, protocolVersion, ModeParams( *this ) );
+}
+
+void Mode::serialize( BinaryOutputStream & stream, uint32_t protocolVersion, const ModeParams & params ) const
 {
 	protocol::writeString( stream, name );
 	stream << value;
@@ -442,14 +453,14 @@ void Mode::serialize( BinaryOutputStream & stream, uint32_t protocolVersion ) co
 	}
 	stream << colors_min;
 	stream << colors_max;
-	stream << speed;
+	stream << params.speed;
 	if (protocolVersion >= 3)
 	{
-		stream << brightness;
+		stream << params.brightness;
 	}
-	stream << direction;
+	stream << params.direction;
 	stream << color_mode;
-	protocol::writeArray( stream, colors );
+	protocol::writeColors( stream, params.colors );
 }
 
 bool Mode::deserialize( BinaryInputStream & stream, uint32_t protocolVersion, uint32_t idx, uint32_t parentIdx ) noexcept
@@ -634,6 +645,14 @@ bool Device::deserialize( BinaryInputStream & stream, uint32_t protocolVersion,
 	protocol::readArray( stream, unconst( leds ), protocolVersion, deviceIdx );
 	protocol::readArray( stream, unconst( colors ) );
 
+	// the LEDs of the device are ordered by zones, the ranges that don't fit the LEDs are clamped
+	uint32_t firstLed = 0;
+	for (const Zone & zone : zones)
+	{
+		unconst( zone.start_idx ) = std::min( firstLed, uint32_t( leds.size() ) );
+		firstLed += zone.leds_count;
+	}
+
 	// Let's tolerate invalid device classes in case the server adds some without increasing protocol version
 	//if (!isValidDeviceType( type ))
 	//	stream.setFailed();
@@ -0,0 +1,435 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: layered effects rendered into a frame buffer of all LEDs
+//======================================================================================================================
+
+#include <OpenRGB/Effects.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <OpenRGB/Client.hpp>
+#include <OpenRGB/ColorKernels.hpp>
+#include <OpenRGB/ThreadPool.hpp>
+
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cmath>      // cos, floor
+#include <cstring>    // memcpy
+#include <algorithm>  // min, copy_n, fill
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  helpers
+
+// round( x / 255 ) for x in [0, 255*255]
+static inline uint32_t div255( uint32_t x )
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+static inline Color scaled( Color color, uint32_t brightness )
+{
+	return Color(
+		uint8_t( div255( color.r * brightness ) ),
+		uint8_t( div255( color.g * brightness ) ),
+		uint8_t( div255( color.b * brightness ) )
+	);
+}
+
+/// One period of sine mapped to [0, 255], starting at the lowest point.
+/** Calculated once, so that the layers don't have to call sin() for every LED in every frame. */
+struct SineTable
+{
+	uint8_t values [256];
+
+	SineTable() noexcept
+	{
+		const double pi = 3.14159265358979323846;
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			values[i] = uint8_t( (1.0 - std::cos( 2.0 * pi * i / 256.0 )) * 127.5 + 0.5 );
+		}
+	}
+};
+
+static const uint8_t * sineTable() noexcept
+{
+	static const SineTable table;
+	return table.values;
+}
+
+/// Fraction of a cycle at the given time as 16-bit fixed point, 65536 being one whole cycle.
+static uint16_t cyclePhase( std::chrono::milliseconds time, double cyclesPerSecond ) noexcept
+{
+	double cycles = double( time.count() ) / 1000.0 * cyclesPerSecond;
+	cycles -= std::floor( cycles );  // keep only the fraction, the absolute value could lose precision
+	return uint16_t( uint32_t( cycles * 65536.0 ) );
+}
+
+
+//======================================================================================================================
+//  FrameBuffer
+
+void FrameBuffer::reset( const DeviceList & devices )
+{
+	buildTables( devices );
+	_colors.assign( _positions.size(), Color::Black );
+}
+
+void FrameBuffer::sync( const DeviceList & devices )
+{
+	std::vector< DeviceRange > oldRanges;
+	oldRanges.swap( _ranges );
+
+	buildTables( devices );
+
+	// move the still valid colors to their new places
+	std::vector< Color > oldColors;
+	oldColors.swap( _colors );
+	_colors.resize( _positions.size() );
+	for (const DeviceRange & range : _ranges)
+	{
+		Span< Color > dst( _colors.data() + range.first, range.count );
+		if (range.deviceIdx < oldRanges.size() && oldRanges[ range.deviceIdx ].count == range.count)
+		{
+			std::copy_n( oldColors.data() + oldRanges[ range.deviceIdx ].first, range.count, dst.begin() );
+		}
+		else
+		{
+			const std::vector< Color > & reported = devices[ range.deviceIdx ].colors;
+			size_t reportedCount = std::min( reported.size(), dst.size() );
+			std::copy_n( reported.data(), reportedCount, dst.begin() );
+			std::fill( dst.begin() + reportedCount, dst.end(), Color::Black );
+		}
+	}
+}
+
+void FrameBuffer::buildTables( const DeviceList & devices )
+{
+	size_t totalLeds = 0;
+	size_t totalZones = 0;
+	for (const Device & device : devices)
+	{
+		totalLeds += device.leds.size();
+		totalZones += device.zones.size();
+	}
+
+	_positions.resize( totalLeds );
+	_ranges.clear();
+	_ranges.reserve( devices.size() );
+	_zones.clear();
+	_zones.reserve( totalZones );
+
+	uint32_t first = 0;
+	for (const Device & device : devices)
+	{
+		uint32_t count = uint32_t( device.leds.size() );
+		_ranges.push_back({ device.idx, first, count, uint32_t( _zones.size() ), uint32_t( device.zones.size() ) });
+
+		for (const Zone & zone : device.zones)
+		{
+			_zones.push_back({ device.idx, zone.idx, first + zone.start_idx, uint32_t( device.zoneLEDs( zone ).size() ) });
+		}
+
+		// spread the LEDs evenly over the whole range, so that the first is at 0 and the last at 65535
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			_positions[ first + i ] = count > 1 ? uint16_t( uint64_t( i ) * 65535 / (count - 1) ) : 0;
+		}
+
+		first += count;
+	}
+}
+
+
+//======================================================================================================================
+//  layers
+
+const char * enumString( BlendMode mode ) noexcept
+{
+	static const char * const BlendModeStr [] =
+	{
+		"Normal",
+		"Add",
+		"Lighten",
+		"Multiply",
+	};
+	static_assert( size_t(BlendMode::Multiply) + 1 == fut::size(BlendModeStr), "update the BlendModeStr" );
+
+	if (size_t(mode) < fut::size(BlendModeStr))
+	{
+		return BlendModeStr[ size_t(mode) ];
+	}
+	else
+	{
+		return "<invalid>";
+	}
+}
+
+void SolidLayer::render( const FrameBuffer &, Span< Color > dst, std::chrono::milliseconds ) noexcept
+{
+	fillColors( dst, color );
+}
+
+void SolidLayer::renderRange( const FrameBuffer &, Span< Color > dst, size_t first, size_t count, std::chrono::milliseconds ) noexcept
+{
+	fillColors( dst.subspan( first, count ), color );
+}
+
+void GradientLayer::render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds ) noexcept
+{
+	for (const FrameBuffer::DeviceRange & range : frame.devices())
+	{
+		fillGradient( dst.subspan( range.first, range.count ), from, to );
+	}
+}
+
+void WaveLayer::render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept
+{
+	renderRange( frame, dst, 0, std::min( dst.size(), frame.positions().size() ), time );
+}
+
+void WaveLayer::renderRange( const FrameBuffer & frame, Span< Color > dst, size_t first, size_t count, std::chrono::milliseconds time ) noexcept
+{
+	const uint8_t * sine = sineTable();
+
+	// phase of each LED = its position / wavelength - elapsed waves, all in 16-bit fixed point
+	float length = std::max( wavelength, 1.0f / 256.0f );
+	uint64_t positionFactor = uint64_t( 65536.0f / length );  // 16.16 fixed point
+	uint16_t timeOffset = cyclePhase( time, speed );
+
+	Span< const uint16_t > positions = frame.positions();
+	for (size_t i = first; i < first + count; ++i)
+	{
+		uint16_t phase = uint16_t( uint32_t( (positions[i] * positionFactor) >> 16 ) - timeOffset );
+		dst[i] = scaled( color, sine[ phase >> 8 ] );
+	}
+}
+
+void BreathingLayer::render( const FrameBuffer & frame, Span< Color > dst, std::chrono::milliseconds time ) noexcept
+{
+	renderRange( frame, dst, 0, dst.size(), time );
+}
+
+void BreathingLayer::renderRange( const FrameBuffer &, Span< Color > dst, size_t first, size_t count, std::chrono::milliseconds time ) noexcept
+{
+	double breathsPerSecond = period > 0.0f ? 1.0 / period : 0.0;
+	uint8_t brightness = sineTable()[ cyclePhase( time, breathsPerSecond ) >> 8 ];
+
+	// all LEDs have the same color, so there is no point calculating it for each of them
+	fillColors( dst.subspan( first, count ), scaled( color, brightness ) );
+}
+
+void SparkleLayer::resize( const FrameBuffer & frame )
+{
+	_levels.assign( frame.size(), 0 );
+}
+
+uint32_t SparkleLayer::nextRandom() noexcept
+{
+	// xorshift32, good enough for visual effects and much cheaper than std::mt19937
+	_random ^= _random << 13;
+	_random ^= _random >> 17;
+	_random ^= _random << 5;
+	return _random;
+}
+
+void SparkleLayer::render( const FrameBuffer &, Span< Color > dst, std::chrono::milliseconds time ) noexcept
+{
+	size_t count = std::min( dst.size(), _levels.size() );
+
+	// time can jump backwards when the animation is restarted, start over without advancing the state
+	float elapsed = 0.0f;
+	if (_lastTime.count() >= 0 && time >= _lastTime)
+		elapsed = float( (time - _lastTime).count() ) / 1000.0f;
+	_lastTime = time;
+
+	// fade out the existing sparks
+	_pendingFade += fadeTime > 0.0f ? elapsed * 255.0f / fadeTime : 255.0f;
+	uint32_t fade = uint32_t( std::min( _pendingFade, 255.0f ) );
+	_pendingFade -= float( fade );
+	if (fade > 0)
+	{
+		for (size_t i = 0; i < count; ++i)
+			_levels[i] = uint8_t( _levels[i] > fade ? _levels[i] - fade : 0 );
+	}
+
+	// light up new ones
+	if (count > 0)
+	{
+		_pendingSparks += sparksPerSecond * elapsed * float( count );
+		uint32_t newSparks = uint32_t( std::min( _pendingSparks, float( count ) ) );
+		_pendingSparks -= float( newSparks );
+		for (uint32_t i = 0; i < newSparks; ++i)
+			_levels[ nextRandom() % count ] = 255;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = scaled( color, _levels[i] );
+	for (size_t i = count; i < dst.size(); ++i)
+		dst[i] = Color::Black;
+}
+
+
+//======================================================================================================================
+//  EffectEngine
+
+// Small enough to balance the work between threads even with a few big devices, but big enough to keep
+// the per-task overhead low and give the SIMD kernels long runs.
+static const uint32_t maxChunkSize = 1024;
+
+void EffectEngine::reset( const DeviceList & devices )
+{
+	_devices = &devices;
+	_frame.reset( devices );
+	updateLayout();
+}
+
+void EffectEngine::sync( const DeviceList & devices )
+{
+	_devices = &devices;
+	_frame.sync( devices );
+	updateLayout();
+}
+
+void EffectEngine::updateLayout()
+{
+	_layerBuffer.assign( _frame.size(), Color::Black );
+
+	_chunks.clear();
+	for (const FrameBuffer::DeviceRange & range : _frame.devices())
+	{
+		for (uint32_t offset = 0; offset < range.count; offset += maxChunkSize)
+		{
+			_chunks.push_back({ range.first + offset, std::min( maxChunkSize, range.count - offset ) });
+		}
+	}
+
+	for (auto & layer : _layers)
+		layer->resize( _frame );
+}
+
+static bool isVisible( const Layer & layer ) noexcept
+{
+	return layer.enabled && layer.opacity != 0;
+}
+
+/// Blends rendered colors of a layer into the frame, the layer colors are overwritten.
+static void composite( const Layer & layer, Span< Color > frame, Span< Color > layerColors ) noexcept
+{
+	// combine the layer with the frame in the layer buffer, so that the opacity can be applied in one pass
+	switch (layer.blendMode)
+	{
+		case BlendMode::Add:       addColors( layerColors, frame ); break;
+		case BlendMode::Lighten:   maxColors( layerColors, frame ); break;
+		case BlendMode::Multiply:  multiplyColors( layerColors, frame ); break;
+		default: break;
+	}
+
+	if (layer.opacity == 255)
+		std::memcpy( frame.data(), layerColors.data(), frame.size() * sizeof(Color) );
+	else
+		blendColors( frame, frame, layerColors, layer.opacity );
+}
+
+void EffectEngine::render( std::chrono::milliseconds time ) noexcept
+{
+	Span< Color > frame = _frame.colors();
+	Span< Color > layerColors = _layerBuffer;
+
+	fillColors( frame, Color::Black );
+
+	for (auto & layer : _layers)
+	{
+		if (!isVisible( *layer ))
+			continue;
+
+		layer->render( _frame, layerColors, time );
+		composite( *layer, frame, layerColors );
+	}
+}
+
+void EffectEngine::render( std::chrono::milliseconds time, ThreadPool & pool )
+{
+	size_t frameSize = _frame.size();
+
+	// layers with a state can't be split, render them whole on this thread first
+	size_t serialLayers = 0;
+	for (auto & layer : _layers)
+		if (isVisible( *layer ) && !layer->isParallel())
+			serialLayers++;
+	if (_serialLayersBuffer.size() < serialLayers * frameSize)
+		_serialLayersBuffer.resize( serialLayers * frameSize );
+
+	Color * serialBuffer = _serialLayersBuffer.data();
+	for (auto & layer : _layers)
+	{
+		if (isVisible( *layer ) && !layer->isParallel())
+		{
+			layer->render( _frame, Span< Color >( serialBuffer, frameSize ), time );
+			serialBuffer += frameSize;
+		}
+	}
+
+	pool.parallelFor( _chunks.size(), [ this, time ]( size_t chunkIdx )
+	{
+		renderChunk( _chunks[ chunkIdx ], time );
+	});
+}
+
+void EffectEngine::renderChunk( Chunk chunk, std::chrono::milliseconds time ) noexcept
+{
+	Span< Color > frame = _frame.colors().subspan( chunk.first, chunk.count );
+	Span< Color > layerColors = Span< Color >( _layerBuffer ).subspan( chunk.first, chunk.count );
+
+	fillColors( frame, Color::Black );
+
+	const Color * serialBuffer = _serialLayersBuffer.data();
+	for (auto & layer : _layers)
+	{
+		if (!isVisible( *layer ))
+			continue;
+
+		if (layer->isParallel())
+		{
+			layer->renderRange( _frame, _layerBuffer, chunk.first, chunk.count, time );
+		}
+		else
+		{
+			std::memcpy( layerColors.data(), serialBuffer + chunk.first, chunk.count * sizeof(Color) );
+			serialBuffer += _frame.size();
+		}
+
+		composite( *layer, frame, layerColors );
+	}
+}
+
+RequestStatus EffectEngine::push( Client & client ) noexcept
+{
+	if (!_devices)
+		return RequestStatus::Success;
+
+	RequestStatus firstFailure = RequestStatus::Success;
+	Span< const FrameBuffer::DeviceRange > ranges = _frame.devices();
+	for (uint32_t i = 0; i < ranges.size(); ++i)
+	{
+		if (ranges[i].count == 0)
+			continue;
+
+		RequestStatus status = client.setDeviceColors( (*_devices)[i], _frame.deviceColors(i) );
+		if (status != RequestStatus::Success && firstFailure == RequestStatus::Success)
+			firstFailure = status;
+	}
+	return firstFailure;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,162 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: precise pacing of animation frames and statistics of their timing
+//======================================================================================================================
+
+#include <OpenRGB/FrameScheduler.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <thread>     // sleep_until, yield
+#include <algorithm>  // min, max
+#include <cstring>    // memset
+using namespace std::chrono;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  TimeHistogram
+
+constexpr uint32_t TimeHistogram::bucketCount;
+
+void TimeHistogram::clear() noexcept
+{
+	std::memset( _buckets, 0, sizeof(_buckets) );
+	_count = 0;
+	_min = INT64_MAX;
+	_max = 0;
+	_sum = 0;
+}
+
+void TimeHistogram::record( nanoseconds duration ) noexcept
+{
+	int64_t ns = std::max( duration.count(), int64_t( 0 ) );  // a spurious early wake-up can give a negative jitter
+
+	uint64_t us = uint64_t( ns ) / 1000;
+	uint32_t idx = 0;
+	while (us > 0 && idx < bucketCount - 1)  // position of the highest set bit
+	{
+		us >>= 1;
+		idx++;
+	}
+	_buckets[ idx ]++;
+
+	_count++;
+	_min = std::min( _min, ns );
+	_max = std::max( _max, ns );
+	_sum += ns;
+}
+
+nanoseconds TimeHistogram::percentile( double fraction ) const noexcept
+{
+	if (_count == 0)
+		return nanoseconds( 0 );
+
+	uint64_t target = uint64_t( fraction * double( _count ) + 0.5 );
+	target = std::max( std::min( target, _count ), uint64_t( 1 ) );
+
+	uint64_t cumulative = 0;
+	for (uint32_t i = 0; i < bucketCount - 1; ++i)
+	{
+		cumulative += _buckets[i];
+		if (cumulative >= target)
+			return nanoseconds( std::min( int64_t( bucketLimit( i ) * 1000 ), _max ) );
+	}
+	return nanoseconds( _max );
+}
+
+
+//======================================================================================================================
+//  FrameScheduler
+
+FrameScheduler::FrameScheduler( double framesPerSecond ) noexcept
+:
+	_period(),
+	_spinThreshold( milliseconds( 1 ) ),
+	_started( false ),
+	_nextFrameIdx( 0 )
+{
+	setFrameRate( framesPerSecond );
+}
+
+void FrameScheduler::setFrameRate( double framesPerSecond ) noexcept
+{
+	if (!(framesPerSecond > 0.0))  // also catches NaN
+		framesPerSecond = 1.0;
+	_period = duration_cast< Clock::duration >( duration< double >( 1.0 / framesPerSecond ) );
+	if (_period <= Clock::duration::zero())
+		_period = Clock::duration( 1 );
+}
+
+static void sleepUntil( FrameScheduler::Clock::time_point deadline, FrameScheduler::Clock::duration spinThreshold ) noexcept
+{
+	auto now = FrameScheduler::Clock::now();
+	if (deadline - now > spinThreshold)
+	{
+		std::this_thread::sleep_until( deadline - spinThreshold );
+	}
+	if (spinThreshold > FrameScheduler::Clock::duration::zero())
+	{
+		while (FrameScheduler::Clock::now() < deadline)
+			std::this_thread::yield();
+	}
+}
+
+FrameScheduler::Frame FrameScheduler::waitForNextFrame() noexcept
+{
+	auto now = Clock::now();
+
+	if (!_started)
+	{
+		_started = true;
+		_start = now;
+		_nextDeadline = now;
+		_nextFrameIdx = 0;
+	}
+
+	// if even the deadline after this one has passed, skip to the latest one that has passed instead of bursting
+	if (now - _nextDeadline >= _period)
+	{
+		uint64_t missed = uint64_t( (now - _nextDeadline) / _period );
+		_nextDeadline += _period * missed;
+		_nextFrameIdx += missed;
+		_stats.skippedFrames += missed;
+	}
+
+	Frame frame;
+	frame.idx = _nextFrameIdx;
+	frame.deadline = _nextDeadline;
+	frame.time = duration_cast< milliseconds >( _nextDeadline - _start );
+
+	sleepUntil( _nextDeadline, _spinThreshold );
+
+	_frameStart = Clock::now();
+	_renderEnd = _frameStart;
+	_stats.frames++;
+	_stats.jitter.record( _frameStart - _nextDeadline );
+
+	_nextDeadline += _period;
+	_nextFrameIdx++;
+
+	return frame;
+}
+
+void FrameScheduler::markRendered() noexcept
+{
+	_renderEnd = Clock::now();
+	_stats.renderTime.record( _renderEnd - _frameStart );
+}
+
+void FrameScheduler::markSent() noexcept
+{
+	_stats.sendTime.record( Clock::now() - _renderEnd );
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,367 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: positions of all LEDs in a shared 3D space and per-LED evaluation of effects
+//======================================================================================================================
+
+#include <OpenRGB/Layout.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cstdio>
+#include <cstdlib>    // strtof, strtoul
+#include <algorithm>  // min, max
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  enum to string conversion
+
+const char * enumString( LayoutStatus status ) noexcept
+{
+	static const char * const LayoutStatusStr [] =
+	{
+		"The operation was successful.",
+		"The layout file doesn't exist or cannot be read.",
+		"A line of the layout file is not a valid command.",
+		"The layout file refers to a device that is not in the device list.",
+		"The layout file refers to a LED index that the device doesn't have.",
+		"Internal error of this library. Please create a github issue.",
+	};
+	static_assert( size_t(LayoutStatus::UnexpectedError) + 1 == fut::size(LayoutStatusStr), "update the LayoutStatusStr" );
+
+	if (size_t(status) < fut::size(LayoutStatusStr))
+	{
+		return LayoutStatusStr[ size_t(status) ];
+	}
+	else
+	{
+		return "<invalid status>";
+	}
+}
+
+
+//======================================================================================================================
+//  automatic positions
+
+void Layout::reset( const DeviceList & devices )
+{
+	size_t totalLeds = 0;
+	for (const Device & device : devices)
+		totalLeds += device.leds.size();
+
+	_localX.assign( totalLeds, 0.0f );
+	_localY.assign( totalLeds, 0.0f );
+	_localZ.assign( totalLeds, 0.0f );
+	_x.resize( totalLeds );
+	_y.resize( totalLeds );
+	_z.resize( totalLeds );
+	_devices.clear();
+	_deviceNames.clear();
+
+	vector< float > sumX, sumY;
+	vector< uint32_t > cellCount;
+
+	uint32_t deviceFirst = 0;
+	float nextDeviceY = 0.0f;
+	for (const Device & device : devices)
+	{
+		uint32_t deviceLeds = uint32_t( device.leds.size() );
+		float * localX = _localX.data() + deviceFirst;
+		float * localY = _localY.data() + deviceFirst;
+
+		uint32_t zonesEnd = 0;
+		float zoneY = 0.0f;
+		for (const Zone & zone : device.zones)
+		{
+			uint32_t zoneFirst = zone.start_idx;
+			uint32_t zoneLeds = std::min( zone.leds_count, deviceLeds - zoneFirst );
+
+			if (zone.type == ZoneType::Matrix && zone.matrix_width > 0 && zone.matrix_height > 0)
+			{
+				// a LED can cover more cells (wide keys), put it in the middle of them
+				sumX.assign( zoneLeds, 0.0f );
+				sumY.assign( zoneLeds, 0.0f );
+				cellCount.assign( zoneLeds, 0 );
+				size_t cells = std::min( size_t( zone.matrix_width ) * zone.matrix_height, zone.matrix_values.size() );
+				for (size_t cell = 0; cell < cells; ++cell)
+				{
+					uint32_t ledIdx = zone.matrix_values[ cell ];
+					if (ledIdx >= zoneLeds)
+						continue;
+					sumX[ ledIdx ] += float( cell % zone.matrix_width );
+					sumY[ ledIdx ] += float( cell / zone.matrix_width );
+					cellCount[ ledIdx ]++;
+				}
+				for (uint32_t i = 0; i < zoneLeds; ++i)
+				{
+					// LEDs missing in the matrix are put in a row below it
+					bool inMatrix = cellCount[i] > 0;
+					localX[ zoneFirst + i ] = inMatrix ? sumX[i] / float( cellCount[i] ) : float( i );
+					localY[ zoneFirst + i ] = zoneY + (inMatrix ? sumY[i] / float( cellCount[i] ) : float( zone.matrix_height ));
+				}
+				zoneY += float( zone.matrix_height ) + 1.0f;
+			}
+			else
+			{
+				for (uint32_t i = 0; i < zoneLeds; ++i)
+				{
+					localX[ zoneFirst + i ] = float( i );
+					localY[ zoneFirst + i ] = zoneY;
+				}
+				zoneY += 1.0f;
+			}
+
+			zonesEnd = zoneFirst + zoneLeds;
+		}
+		// LEDs that don't belong to any zone
+		for (uint32_t i = zonesEnd; i < deviceLeds; ++i)
+		{
+			localX[i] = float( i - zonesEnd );
+			localY[i] = zoneY;
+		}
+		if (zonesEnd < deviceLeds)
+			zoneY += 1.0f;
+
+		_devices.push_back({ deviceFirst, deviceLeds, Point3( 0.0f, nextDeviceY, 0.0f ), 1.0f });
+		_deviceNames.push_back( device.name );
+		updateDevice( uint32_t( _devices.size() - 1 ) );
+
+		deviceFirst += deviceLeds;
+		nextDeviceY += std::max( zoneY, 1.0f ) + 1.0f;
+	}
+}
+
+void Layout::updateDevice( uint32_t deviceIdx ) noexcept
+{
+	const DevicePlacement & device = _devices[ deviceIdx ];
+	size_t first = device.firstLed;
+	size_t end = first + device.ledCount;
+	for (size_t i = first; i < end; ++i)
+	{
+		_x[i] = device.origin.x + _localX[i] * device.scale;
+		_y[i] = device.origin.y + _localY[i] * device.scale;
+		_z[i] = device.origin.z + _localZ[i] * device.scale;
+	}
+}
+
+void Layout::placeDevice( uint32_t deviceIdx, Point3 origin, float scale ) noexcept
+{
+	if (deviceIdx >= _devices.size())
+		return;
+
+	_devices[ deviceIdx ].origin = origin;
+	_devices[ deviceIdx ].scale = scale;
+	updateDevice( deviceIdx );
+}
+
+void Layout::setLedPosition( uint32_t deviceIdx, uint32_t ledIdx, Point3 position ) noexcept
+{
+	if (deviceIdx >= _devices.size() || ledIdx >= _devices[ deviceIdx ].ledCount)
+		return;
+
+	const DevicePlacement & device = _devices[ deviceIdx ];
+	size_t i = device.firstLed + ledIdx;
+	_localX[i] = position.x;
+	_localY[i] = position.y;
+	_localZ[i] = position.z;
+	_x[i] = device.origin.x + position.x * device.scale;
+	_y[i] = device.origin.y + position.y * device.scale;
+	_z[i] = device.origin.z + position.z * device.scale;
+}
+
+
+//======================================================================================================================
+//  layout file
+
+/// Splits a line of the layout file into words, a word in quotes can contain spaces.
+static bool tokenize( StringView line, vector< string > & tokens )
+{
+	tokens.clear();
+	size_t pos = 0;
+	while (pos < line.size())
+	{
+		char c = line[ pos ];
+		if (c == ' ' || c == '\t' || c == '\r')
+		{
+			pos++;
+		}
+		else if (c == '"')
+		{
+			size_t end = pos + 1;
+			while (end < line.size() && line[ end ] != '"')
+				end++;
+			if (end == line.size())
+				return false;  // missing closing quote
+			tokens.emplace_back( line.data() + pos + 1, end - pos - 1 );
+			pos = end + 1;
+		}
+		else
+		{
+			size_t end = pos;
+			while (end < line.size() && line[ end ] != ' ' && line[ end ] != '\t' && line[ end ] != '\r')
+				end++;
+			tokens.emplace_back( line.data() + pos, end - pos );
+			pos = end;
+		}
+	}
+	return true;
+}
+
+static bool parseFloat( const string & token, float & value )
+{
+	char * end;
+	value = std::strtof( token.c_str(), &end );
+	return !token.empty() && *end == '\0';
+}
+
+static bool parseUInt( const string & token, uint32_t & value )
+{
+	char * end;
+	unsigned long parsed = std::strtoul( token.c_str(), &end, 10 );
+	value = uint32_t( parsed );
+	return !token.empty() && token[0] != '-' && *end == '\0' && parsed <= 0xFFFFFFFFul;
+}
+
+static bool parsePoint( const vector< string > & tokens, size_t first, Point3 & point )
+{
+	return parseFloat( tokens[ first ], point.x )
+	    && parseFloat( tokens[ first + 1 ], point.y )
+	    && parseFloat( tokens[ first + 2 ], point.z );
+}
+
+LayoutStatus Layout::parse( StringView text ) noexcept
+{
+	try
+	{
+		_errorLine = 0;
+
+		auto findDevice = [ this ]( const string & name ) -> uint32_t
+		{
+			for (uint32_t i = 0; i < _deviceNames.size(); ++i)
+				if (_deviceNames[i] == name)
+					return i;
+			return uint32_t( -1 );
+		};
+
+		vector< string > tokens;
+		uint32_t lineNum = 0;
+		size_t lineStart = 0;
+		while (lineStart < text.size())
+		{
+			lineNum++;
+			size_t lineEnd = lineStart;
+			while (lineEnd < text.size() && text[ lineEnd ] != '\n')
+				lineEnd++;
+			StringView line( text.data() + lineStart, lineEnd - lineStart );
+			lineStart = lineEnd + 1;
+
+			if (!tokenize( line, tokens ))
+			{
+				_errorLine = lineNum;
+				return LayoutStatus::InvalidSyntax;
+			}
+			if (tokens.empty() || tokens[0][0] == '#')
+			{
+				continue;
+			}
+
+			if (tokens[0] == "device" && (tokens.size() == 5 || tokens.size() == 6))
+			{
+				Point3 origin;
+				float scale = 1.0f;
+				if (!parsePoint( tokens, 2, origin ) || (tokens.size() == 6 && !parseFloat( tokens[5], scale )))
+				{
+					_errorLine = lineNum;
+					return LayoutStatus::InvalidSyntax;
+				}
+				uint32_t deviceIdx = findDevice( tokens[1] );
+				if (deviceIdx >= _devices.size())
+				{
+					_errorLine = lineNum;
+					return LayoutStatus::UnknownDevice;
+				}
+				placeDevice( deviceIdx, origin, scale );
+			}
+			else if (tokens[0] == "led" && tokens.size() == 6)
+			{
+				uint32_t ledIdx;
+				Point3 position;
+				if (!parseUInt( tokens[2], ledIdx ) || !parsePoint( tokens, 3, position ))
+				{
+					_errorLine = lineNum;
+					return LayoutStatus::InvalidSyntax;
+				}
+				uint32_t deviceIdx = findDevice( tokens[1] );
+				if (deviceIdx >= _devices.size())
+				{
+					_errorLine = lineNum;
+					return LayoutStatus::UnknownDevice;
+				}
+				if (ledIdx >= _devices[ deviceIdx ].ledCount)
+				{
+					_errorLine = lineNum;
+					return LayoutStatus::LedOutOfRange;
+				}
+				setLedPosition( deviceIdx, ledIdx, position );
+			}
+			else
+			{
+				_errorLine = lineNum;
+				return LayoutStatus::InvalidSyntax;
+			}
+		}
+
+		return LayoutStatus::Success;
+	}
+	catch (...)
+	{
+		return LayoutStatus::UnexpectedError;
+	}
+}
+
+LayoutStatus Layout::load( const std::string & filePath ) noexcept
+{
+	try
+	{
+		_errorLine = 0;
+
+		FILE * file = fopen( filePath.c_str(), "rb" );
+		if (!file)
+		{
+			return LayoutStatus::CannotOpenFile;
+		}
+
+		string content;
+		char buffer [4096];
+		size_t read;
+		while ((read = fread( buffer, 1, sizeof(buffer), file )) > 0)
+			content.append( buffer, read );
+		bool failed = ferror( file ) != 0;
+		fclose( file );
+		if (failed)
+		{
+			return LayoutStatus::CannotOpenFile;
+		}
+
+		return parse( content );
+	}
+	catch (...)
+	{
+		return LayoutStatus::UnexpectedError;
+	}
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,186 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: read-only memory mapping of a file
+//======================================================================================================================
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+#include <cstdio>  // rename, remove
+#include <atomic>
+#include <string>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+MappedFile::MappedFile() noexcept
+:
+	_data( nullptr ),
+	_size( 0 ),
+#ifdef _WIN32
+	_fileHandle( INVALID_HANDLE_VALUE ),
+	_mappingHandle( nullptr ),
+#endif
+	_lastSystemError( 0 )
+{}
+
+MappedFile::~MappedFile() noexcept
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	// FILE_SHARE_DELETE allows the writer to replace the file while we have it mapped
+	_fileHandle = CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+	                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if (_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		_lastSystemError = GetLastError();
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx( _fileHandle, &fileSize ) || fileSize.QuadPart == 0)
+	{
+		_lastSystemError = GetLastError();
+		close();
+		return false;
+	}
+
+	_mappingHandle = CreateFileMappingA( _fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if (!_mappingHandle)
+	{
+		_lastSystemError = GetLastError();
+		close();
+		return false;
+	}
+
+	void * data = MapViewOfFile( _mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+	if (!data)
+	{
+		_lastSystemError = GetLastError();
+		close();
+		return false;
+	}
+
+	_data = static_cast< const uint8_t * >( data );
+	_size = size_t( fileSize.QuadPart );
+	return true;
+}
+
+void MappedFile::close() noexcept
+{
+	if (_data)
+		UnmapViewOfFile( _data );
+	if (_mappingHandle)
+		CloseHandle( _mappingHandle );
+	if (_fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle( _fileHandle );
+
+	_data = nullptr;
+	_size = 0;
+	_mappingHandle = nullptr;
+	_fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else // POSIX
+
+bool MappedFile::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	int fd = ::open( filePath.c_str(), O_RDONLY );
+	if (fd < 0)
+	{
+		_lastSystemError = errno;
+		return false;
+	}
+
+	struct stat fileInfo;
+	if (fstat( fd, &fileInfo ) != 0 || fileInfo.st_size == 0)
+	{
+		_lastSystemError = errno;
+		::close( fd );
+		return false;
+	}
+
+	// the mapping stays valid after the file descriptor is closed
+	void * data = mmap( nullptr, size_t( fileInfo.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+	::close( fd );
+	if (data == MAP_FAILED)
+	{
+		_lastSystemError = errno;
+		return false;
+	}
+
+	_data = static_cast< const uint8_t * >( data );
+	_size = size_t( fileInfo.st_size );
+	return true;
+}
+
+void MappedFile::close() noexcept
+{
+	if (_data)
+		munmap( const_cast< uint8_t * >( _data ), _size );
+
+	_data = nullptr;
+	_size = 0;
+}
+
+#endif // _WIN32
+
+
+//======================================================================================================================
+//  writing files that others may have mapped
+
+std::string uniqueTempPath( const std::string & filePath )
+{
+	// the process id separates the processes, the counter the threads and the repeated writes of one process
+	static std::atomic< unsigned > counter( 0 );
+ #ifdef _WIN32
+	unsigned long processId = GetCurrentProcessId();
+ #else
+	unsigned long processId = (unsigned long)getpid();
+ #endif
+	return filePath + '.' + std::to_string( processId ) + '.' + std::to_string( counter++ ) + ".tmp";
+}
+
+bool replaceFile( const std::string & tempPath, const std::string & filePath ) noexcept
+{
+ #ifdef _WIN32
+	// succeeds only when all the readers have opened the file with FILE_SHARE_DELETE, as MappedFile does
+	bool replaced = MoveFileExA( tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+ #else
+	bool replaced = rename( tempPath.c_str(), filePath.c_str() ) == 0;
+ #endif
+	if (!replaced)
+	{
+		remove( tempPath.c_str() );
+	}
+	return replaced;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
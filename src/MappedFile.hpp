@@ -0,0 +1,82 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: read-only memory mapping of a file
+//======================================================================================================================
+
+#ifndef OPENRGB_MAPPED_FILE_INCLUDED
+#define OPENRGB_MAPPED_FILE_INCLUDED
+
+
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <OpenRGB/SystemErrorType.hpp>
+
+#include <cstdint>
+#include <string>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+/// Maps a whole file into the address space of this process for reading.
+/** Multiple processes mapping the same file share the same physical pages. The file can be replaced by replaceFile()
+  * while it's mapped, the mapping keeps the old content. */
+
+class MappedFile
+{
+
+ public:
+
+	MappedFile() noexcept;
+	~MappedFile() noexcept;
+
+	MappedFile( const MappedFile & other ) = delete;
+	MappedFile & operator=( const MappedFile & other ) = delete;
+
+	/// Maps the file, returns false and remembers the system error code on failure.
+	bool open( const std::string & filePath ) noexcept;
+
+	void close() noexcept;
+
+	bool isOpen() const noexcept  { return _data != nullptr; }
+
+	const uint8_t * data() const noexcept  { return _data; }
+	size_t size() const noexcept  { return _size; }
+
+	system_error_t getLastSystemError() const noexcept  { return _lastSystemError; }
+
+ private:
+
+	const uint8_t * _data;
+	size_t _size;
+#ifdef _WIN32
+	void * _fileHandle;
+	void * _mappingHandle;
+#endif
+
+	system_error_t _lastSystemError;
+
+};
+
+
+//======================================================================================================================
+//  writing files that others may have mapped
+
+/// Path for writing the new content of a file, unique for every call, so that concurrent writers don't clobber each other.
+std::string uniqueTempPath( const std::string & filePath );
+
+/// Atomically replaces the file with the temporary one, the readers see either the old or the new file, never a part.
+/** Existing mappings keep the old content. On failure, the temporary file is removed. */
+bool replaceFile( const std::string & tempPath, const std::string & filePath ) noexcept;
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_MAPPED_FILE_INCLUDED
@@ -0,0 +1,229 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: serialization of protocol messages generated from a list of their fields
+//======================================================================================================================
+
+#ifndef OPENRGB_MESSAGE_CODEC_INCLUDED
+#define OPENRGB_MESSAGE_CODEC_INCLUDED
+
+
+#include "ProtocolCommon.hpp"  // BinaryStream with little endian default
+
+#include <OpenRGB/Color.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  field types
+
+/// How a value of a particular type is written into a message.
+template< typename Type, typename Enable = void >
+struct FieldTraits;
+
+/// Numbers and enums are written as they are.
+template< typename Type >
+struct FieldTraits< Type, typename std::enable_if< std::is_arithmetic< Type >::value || std::is_enum< Type >::value >::type >
+{
+	static constexpr bool isFixedSize = true;
+	static constexpr size_t fixedSize = sizeof( Type );
+
+	static size_t size( const Type & ) noexcept  { return sizeof( Type ); }
+	static void write( own::BinaryOutputStream & stream, const Type & value )  { stream << value; }
+	static void read( own::BinaryInputStream & stream, Type & value ) noexcept  { stream >> value; }
+	static void store( uint8_t * pos, const Type & value ) noexcept  { protocol::store( pos, value ); }
+};
+
+/// Colors are written as the 3 components and a padding byte.
+template<>
+struct FieldTraits< Color >
+{
+	static constexpr bool isFixedSize = true;
+	static constexpr size_t fixedSize = 4;  // Color::calcSize()
+
+	static size_t size( const Color & color ) noexcept  { return color.calcSize(); }
+	static void write( own::BinaryOutputStream & stream, const Color & color )  { stream << color; }
+	static void read( own::BinaryInputStream & stream, Color & color ) noexcept  { stream >> color; }
+	static void store( uint8_t * pos, const Color & color ) noexcept  { std::memcpy( pos, &color, fixedSize ); }
+};
+
+/// Strings directly in a message are terminated by '\0' and have no length, unlike the strings inside the devices.
+template<>
+struct FieldTraits< std::string >
+{
+	static constexpr bool isFixedSize = false;
+	static constexpr size_t fixedSize = 0;
+
+	static size_t size( const std::string & str ) noexcept  { return str.size() + 1; }
+	static void write( own::BinaryOutputStream & stream, const std::string & str )  { stream.writeString0( str ); }
+	static void read( own::BinaryInputStream & stream, std::string & str ) noexcept  { stream.readString0( str ); }
+};
+
+
+//======================================================================================================================
+//  field lists
+
+/// One field of a message, the member it is stored in and the protocol version that has added it.
+/** A field that isn't part of the negotiated protocol version is neither written, nor read, it keeps its value. */
+template< typename Msg, typename Type, Type Msg::* member, uint32_t sinceVersion = 0 >
+struct Field
+{
+	using Traits = FieldTraits< Type >;
+
+	// whether the field is present depends on the version, so its size can't be a constant
+	static constexpr bool isFixedSize = Traits::isFixedSize && sinceVersion == 0;
+	static constexpr size_t fixedSize = isFixedSize ? Traits::fixedSize : 0;
+
+	static bool isPresent( uint32_t protocolVersion ) noexcept
+	{
+		return sinceVersion == 0 || protocolVersion >= sinceVersion;
+	}
+
+	static size_t size( const Msg & msg, uint32_t protocolVersion ) noexcept
+	{
+		return isPresent( protocolVersion ) ? Traits::size( msg.*member ) : 0;
+	}
+	static void write( own::BinaryOutputStream & stream, const Msg & msg, uint32_t protocolVersion )
+	{
+		if (isPresent( protocolVersion ))
+			Traits::write( stream, msg.*member );
+	}
+	static void read( own::BinaryInputStream & stream, Msg & msg, uint32_t protocolVersion ) noexcept
+	{
+		if (isPresent( protocolVersion ))
+			Traits::read( stream, msg.*member );
+	}
+	/// Only for fixed-size fields, which are always present.
+	template< size_t offset >
+	static void store( uint8_t * body, const Msg & msg ) noexcept
+	{
+		Traits::store( body + offset, msg.*member );
+	}
+};
+
+/// Fields of a message body in the order in which they are sent.
+/** The recursion is expanded at compile time, so write(...) is the same sequence of stream operations that would be
+  * written by hand. When all the fields have a fixed size, store(...) also knows the offset of every field at compile
+  * time and stores each of them directly at its place in the buffer, without any stream keeping the position. */
+template< typename ... Fields >
+struct MessageFields;
+
+template<>
+struct MessageFields<>
+{
+	static constexpr bool isFixedSize = true;
+	static constexpr size_t fixedSize = 0;
+
+	template< typename Msg >
+	static size_t size( const Msg &, uint32_t ) noexcept  { return 0; }
+	template< typename Msg >
+	static void write( own::BinaryOutputStream &, const Msg &, uint32_t ) {}
+	template< typename Msg >
+	static void read( own::BinaryInputStream &, Msg &, uint32_t ) noexcept {}
+	template< typename Msg, size_t offset = 0 >
+	static void store( uint8_t *, const Msg & ) noexcept {}
+};
+
+template< typename First, typename ... Rest >
+struct MessageFields< First, Rest ... >
+{
+	using Others = MessageFields< Rest ... >;
+
+	static constexpr bool isFixedSize = First::isFixedSize && Others::isFixedSize;
+	static constexpr size_t fixedSize = First::fixedSize + Others::fixedSize;
+
+	template< typename Msg >
+	static size_t size( const Msg & msg, uint32_t protocolVersion ) noexcept
+	{
+		return First::size( msg, protocolVersion ) + Others::size( msg, protocolVersion );
+	}
+	template< typename Msg >
+	static void write( own::BinaryOutputStream & stream, const Msg & msg, uint32_t protocolVersion )
+	{
+		First::write( stream, msg, protocolVersion );
+		Others::write( stream, msg, protocolVersion );
+	}
+	template< typename Msg >
+	static void read( own::BinaryInputStream & stream, Msg & msg, uint32_t protocolVersion ) noexcept
+	{
+		First::read( stream, msg, protocolVersion );
+		Others::read( stream, msg, protocolVersion );
+	}
+	template< typename Msg, size_t offset = 0 >
+	static void store( uint8_t * body, const Msg & msg ) noexcept
+	{
+		static_assert( First::isFixedSize, "only the fields of a fixed size have a constant offset" );
+		First::template store< offset >( body, msg );
+		Others::template store< Msg, offset + First::fixedSize >( body, msg );
+	}
+};
+
+
+//======================================================================================================================
+//  generated methods
+
+/// Base of the messages described by a list of fields, it generates the methods used for templated processing.
+/** The message has to declare its body as a public member type Fields = MessageFields< Field<...>, ... >.
+  * It's looked up only when the methods are used, after the message is complete. */
+template< typename Msg >
+struct MessageCodec
+{
+	/// Size of the body when all the fields have a constant size, it can't be used otherwise.
+	static constexpr uint32_t fixedDataSize() noexcept
+	{
+		static_assert( Msg::Fields::isFixedSize, "the message has a variable size, use calcDataSize()" );
+		return uint32_t( Msg::Fields::fixedSize );
+	}
+
+	uint32_t calcDataSize( uint32_t protocolVersion = 0 ) const noexcept
+	{
+		// when the size is constant, the fields don't need to be visited at all
+		return Msg::Fields::isFixedSize
+			? uint32_t( Msg::Fields::fixedSize )
+			: uint32_t( Msg::Fields::size( self(), protocolVersion ) );
+	}
+
+	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion = 0 ) const
+	{
+		self().header.serialize( stream );
+		Msg::Fields::write( stream, self(), protocolVersion );
+	}
+
+	/// Stores the fields at their constant offsets, preferred by protocol::serializeMessage(...) when available.
+	/** The buffer must have the header size plus fixedDataSize() bytes. */
+	template< typename M = Msg, REQUIRES( M::Fields::isFixedSize ) >
+	void serialize( uint8_t * buffer, uint32_t /*protocolVersion*/ = 0 ) const noexcept
+	{
+		uint8_t * body = self().header.serialize( buffer );
+		Msg::Fields::store( body, self() );
+	}
+
+	bool deserializeBody( own::BinaryInputStream & stream, uint32_t protocolVersion = 0 ) noexcept
+	{
+		Msg::Fields::read( stream, self(), protocolVersion );
+		return !stream.failed();
+	}
+
+ private:
+
+	const Msg & self() const noexcept  { return static_cast< const Msg & >( *this ); }
+	Msg & self() noexcept  { return static_cast< Msg & >( *this ); }
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_MESSAGE_CODEC_INCLUDED
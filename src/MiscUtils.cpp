@@ -8,6 +8,7 @@
 #include "MiscUtils.hpp"
 
 #include <cstdio>
+#include <cstring>  // memcpy
 #include <iostream>
 
 
@@ -26,5 +27,36 @@ void indent( std::ostream & os, unsigned int indentLevel )
 		os << '\t';
 }
 
+static inline uint64_t mix( uint64_t x ) noexcept
+{
+	x ^= x >> 31;
+	x *= 0xBF58476D1CE4E5B9ull;
+	x ^= x >> 27;
+	return x;
+}
+
+uint64_t hashBytes( const uint8_t * data, size_t size ) noexcept
+{
+	const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+	uint64_t hash = size * multiplier;
+
+	// 8 bytes at a time, the unaligned loads are done by memcpy
+	size_t pos = 0;
+	for (; pos + 8 <= size; pos += 8)
+	{
+		uint64_t word;
+		memcpy( &word, data + pos, 8 );
+		hash = (hash ^ mix( word )) * multiplier;
+	}
+	if (pos < size)
+	{
+		uint64_t word = 0;
+		memcpy( &word, data + pos, size - pos );
+		hash = (hash ^ mix( word )) * multiplier;
+	}
+
+	return mix( hash ^ (hash >> 32) );
+}
+
 
 } // namespace orgb
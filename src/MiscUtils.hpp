@@ -12,6 +12,10 @@
 #include <CppUtils-Essential/Essential.hpp>
 
 #include <iosfwd>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>     // fprintf in CATCH_ALL
+#include <exception>
 
 
 namespace orgb {
@@ -21,6 +25,19 @@ void indent( unsigned int indentLevel );
 
 void indent( std::ostream & os, unsigned int indentLevel );
 
+/// Fast non-cryptographic 64-bit hash for detecting changes of received data.
+uint64_t hashBytes( const uint8_t * data, size_t size ) noexcept;
+
+/// Ends a try block of the noexcept wrappers of the API, reports any exception and then executes the arguments.
+#define CATCH_ALL( ... ) \
+	catch (const std::exception & ex) { \
+		fprintf( stderr, "Unexpected std::exception was thrown: %s\n", ex.what() ); \
+		__VA_ARGS__ \
+	} catch (...) { \
+		fprintf( stderr, "Unexpected unknown exception was thrown\n" ); \
+		__VA_ARGS__ \
+	}
+
 
 } // namespace orgb
 
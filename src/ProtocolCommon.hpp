@@ -13,14 +13,24 @@
 #include <CppUtils-Essential/BinaryStream.hpp>
 MAKE_LITTLE_ENDIAN_DEFAULT
 
+#include <OpenRGB/Color.hpp>
+#include <OpenRGB/ColorKernels.hpp>
+#include <OpenRGB/Span.hpp>
+#include "CorrectionSegment.hpp"
+
 #include <cstring>
+#include <algorithm>  // min, max
 #include <string>
 #include <vector>
+#include <type_traits>
 
 
 namespace orgb {
 
 
+static_assert( sizeof(Color) == 4 && alignof(Color) == 1, "colors are stored into the messages directly as they are" );
+
+
 //======================================================================================================================
 // Putting these template functions into a struct allows us to collectively mark them as friend and allow them to access
 // methods of Mode, Zone, LED that should be private to the user of the library, but accessible to the library itself.
@@ -166,6 +176,110 @@ struct protocol
 		return !stream.failed();
 	}
 
+	//-- colors --------------------------------------------------------------------------------------------------------
+
+	static size_t sizeofColors( size_t count ) noexcept
+	{
+		return 2 + count * sizeof( Color );
+	}
+	static size_t sizeofColors( Span< const Color > colors ) noexcept
+	{
+		return sizeofColors( colors.size() );
+	}
+
+	static void writeColors( own::BinaryOutputStream & stream, Span< const Color > colors )
+	{
+		stream << uint16_t(colors.size());
+		for (const Color & color : colors)
+		{
+			stream << color;
+		}
+	}
+
+
+	//-- direct stores -------------------------------------------------------------------------------------------------
+	//  The messages sent every frame are stored straight into a send buffer of their exact size, without the bounds
+	//  checks and byte order handling BinaryOutputStream does for every single value.
+	//  Each store returns the position behind the stored value.
+
+	/// Stores a number or an enum in little endian.
+	template< typename Type, REQUIRES( std::is_integral<Type>::value || std::is_enum<Type>::value ) >
+	static uint8_t * store( uint8_t * pos, Type value ) noexcept
+	{
+		uint64_t bits = uint64_t( value );
+		for (size_t i = 0; i < sizeof(Type); ++i)  // compiled into a single store on little endian CPUs
+		{
+			pos[i] = uint8_t( bits >> (8 * i) );
+		}
+		return pos + sizeof(Type);
+	}
+
+	/// Stores the array of colors and applies the corrections on the way, so that they don't need another buffer.
+	/** The segments must be sorted and must not overlap. */
+	static uint8_t * storeColors( uint8_t * pos, Span< const Color > colors, Span< const CorrectionSegment > corrections ) noexcept
+	{
+		pos = store( pos, uint16_t(colors.size()) );
+		Span< Color > dst( reinterpret_cast< Color * >( pos ), colors.size() );
+
+		size_t done = 0;
+		for (const CorrectionSegment & segment : corrections)
+		{
+			size_t segmentBegin = std::max( done, std::min( size_t(segment.first), colors.size() ) );
+			size_t segmentEnd = std::max( segmentBegin, std::min( size_t(segment.first) + segment.count, colors.size() ) );
+			std::memcpy( dst.data() + done, colors.data() + done, (segmentBegin - done) * sizeof(Color) );
+			segment.correction->apply( colors.subspan( segmentBegin, segmentEnd - segmentBegin ),
+			                           dst.subspan( segmentBegin, segmentEnd - segmentBegin ) );
+			done = segmentEnd;
+		}
+		std::memcpy( dst.data() + done, colors.data() + done, (colors.size() - done) * sizeof(Color) );
+
+		return pos + colors.size() * sizeof(Color);
+	}
+
+	/// Stores the same color count times, the segments are corrected the same way as above.
+	static uint8_t * storeColors( uint8_t * pos, Color color, size_t count, Span< const CorrectionSegment > corrections ) noexcept
+	{
+		pos = store( pos, uint16_t(count) );
+		Span< Color > dst( reinterpret_cast< Color * >( pos ), count );
+
+		fillColors( dst, color );
+		for (const CorrectionSegment & segment : corrections)
+		{
+			size_t segmentBegin = std::min( size_t(segment.first), count );
+			size_t segmentEnd = std::max( segmentBegin, std::min( size_t(segment.first) + segment.count, count ) );
+			fillColors( dst.subspan( segmentBegin, segmentEnd - segmentBegin ), segment.correction->apply( color ) );
+		}
+
+		return pos + count * sizeof(Color);
+	}
+
+
+	//-- whole messages ------------------------------------------------------------------------------------------------
+
+	/// Serializes the message into a buffer of exactly header.size() + header.message_size bytes.
+	/** The messages that can store themselves directly, having serialize( uint8_t *, uint32_t ), are preferred. */
+	template< typename Message >
+	static void serializeMessage( const Message & message, uint8_t * buffer, size_t size, uint32_t protocolVersion )
+	{
+		serializeMessage( message, buffer, size, protocolVersion, 0 );
+	}
+
+ private:
+
+	template< typename Message >
+	static auto serializeMessage( const Message & message, uint8_t * buffer, size_t, uint32_t protocolVersion, int )
+		-> decltype( message.serialize( buffer, protocolVersion ), void() )
+	{
+		message.serialize( buffer, protocolVersion );
+	}
+
+	template< typename Message >
+	static void serializeMessage( const Message & message, uint8_t * buffer, size_t size, uint32_t protocolVersion, long )
+	{
+		own::BinaryOutputStream stream( own::span< uint8_t >( buffer, size ) );
+		message.serialize( stream, protocolVersion );
+	}
+
 };
 
 
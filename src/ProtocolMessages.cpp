@@ -51,7 +51,7 @@ const char * enumString( MessageType type ) noexcept
 	}
 }
 
-static bool isValidMessageType( MessageType type )
+bool isValidMessageType( MessageType type ) noexcept
 {
 	switch (type)
 	{
@@ -83,6 +83,14 @@ void Header::serialize( BinaryOutputStream & stream ) const
 	stream << message_size;
 }
 
+uint8_t * Header::serialize( uint8_t * pos ) const noexcept
+{
+	std::memcpy( pos, magic, sizeof(magic) );
+	pos = protocol::store( pos + sizeof(magic), device_idx );
+	pos = protocol::store( pos, message_type );
+	return protocol::store( pos, message_size );
+}
+
 bool Header::deserialize( BinaryInputStream & stream ) noexcept
 {
 	stream >> magic;
@@ -102,37 +110,14 @@ bool Header::deserialize( BinaryInputStream & stream ) noexcept
 //======================================================================================================================
 //  main protocol messages
 
-//----------------------------------------------------------------------------------------------------------------------
-
-void ReplyControllerCount::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << count;
-}
-
-bool ReplyControllerCount::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> count;
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-void RequestControllerData::serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << protocolVersion;
-}
-
-bool RequestControllerData::deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> protocolVersion;
-
-	return !stream.failed();
-}
+// the sizes generated from the field lists, as described in the protocol documentation
+static_assert( ReplyControllerCount::fixedDataSize() == 4, "wrong size of ReplyControllerCount" );
+static_assert( RequestControllerData::fixedDataSize() == 4, "wrong size of RequestControllerData" );
+static_assert( RequestProtocolVersion::fixedDataSize() == 4, "wrong size of RequestProtocolVersion" );
+static_assert( ReplyProtocolVersion::fixedDataSize() == 4, "wrong size of ReplyProtocolVersion" );
+static_assert( ResizeZone::fixedDataSize() == 8, "wrong size of ResizeZone" );
+static_assert( UpdateSingleLED::fixedDataSize() == 8, "wrong size of UpdateSingleLED" );
+static_assert( SetCustomMode::fixedDataSize() == 0, "wrong size of SetCustomMode" );
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -164,103 +149,32 @@ bool ReplyControllerData::deserializeBody( BinaryInputStream & stream, uint32_t
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void RequestProtocolVersion::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << clientVersion;
-}
-
-bool RequestProtocolVersion::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> clientVersion;
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-void ReplyProtocolVersion::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << serverVersion;
-}
-
-bool ReplyProtocolVersion::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> serverVersion;
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-uint32_t SetClientName::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
-{
-	size_t size = 0;
-
-	size += name.size() + 1;
-
-	return uint32_t( size );
-}
-
-void SetClientName::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream.writeString0( name );
-}
-
-bool SetClientName::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream.readString0( name );
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-void ResizeZone::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << zone_idx;
-	stream << new_size;
-}
-
-bool ResizeZone::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> zone_idx;
-	stream >> new_size;
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
 uint32_t UpdateLEDs::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
 {
 	size_t size = 0;
 
 	size += sizeof( data_size );
-	size += protocol::sizeofArray( colors );
+	size += protocol::sizeofColors( fillCount ? fillCount : colors.size() );
 
 	return uint32_t( size );
 }
 
-void UpdateLEDs::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
+void UpdateLEDs::serialize( uint8_t * buffer, uint32_t /*protocolVersion*/ ) const noexcept
 {
-	header.serialize( stream );
+	uint8_t * pos = header.serialize( buffer );
 
-	stream << data_size;
-	protocol::writeArray( stream, colors );
+	pos = protocol::store( pos, data_size );
+	if (fillCount)
+		protocol::storeColors( pos, fillColor, fillCount, corrections );
+	else
+		protocol::storeColors( pos, colors, corrections );
 }
 
 bool UpdateLEDs::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
 {
 	stream >> data_size;
-	protocol::readArray( stream, colors );
+	protocol::readArray( stream, receivedColors );
+	colors = receivedColors;
 
 	return !stream.failed();
 }
@@ -273,53 +187,29 @@ uint32_t UpdateZoneLEDs::calcDataSize( uint32_t /*protocolVersion*/ ) const noex
 
 	size += sizeof( data_size );
 	size += sizeof( zone_idx );
-	size += protocol::sizeofArray( colors );
+	size += protocol::sizeofColors( fillCount ? fillCount : colors.size() );
 
 	return uint32_t( size );
 }
 
-void UpdateZoneLEDs::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
+void UpdateZoneLEDs::serialize( uint8_t * buffer, uint32_t /*protocolVersion*/ ) const noexcept
 {
-	header.serialize( stream );
+	uint8_t * pos = header.serialize( buffer );
 
-	stream << data_size;
-	stream << zone_idx;
-	protocol::writeArray( stream, colors );
+	pos = protocol::store( pos, data_size );
+	pos = protocol::store( pos, zone_idx );
+	if (fillCount)
+		protocol::storeColors( pos, fillColor, fillCount, corrections );
+	else
+		protocol::storeColors( pos, colors, corrections );
 }
 
 bool UpdateZoneLEDs::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
 {
 	stream >> data_size;
 	stream >> zone_idx;
-	protocol::readArray( stream, colors );
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-uint32_t UpdateSingleLED::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
-{
-	size_t size = 0;
-
-	size += sizeof( led_idx );
-	size += color.calcSize();
-
-	return uint32_t( size );
-}
-
-void UpdateSingleLED::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream << led_idx;
-	stream << color;
-}
-
-bool UpdateSingleLED::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream >> led_idx;
-	stream >> color;
+	protocol::readArray( stream, receivedColors );
+	colors = receivedColors;
 
 	return !stream.failed();
 }
@@ -332,7 +222,7 @@ uint32_t UpdateMode::calcDataSize( uint32_t protocolVersion ) const noexcept
 
 	size += sizeof( data_size );
 	size += sizeof( mode_idx );
-	size += mode_desc.calcSize( protocolVersion );
+	size += mode_desc->calcSize( protocolVersion, params );
 
 	return uint32_t( size );
 }
@@ -343,14 +233,16 @@ void UpdateMode::serialize( BinaryOutputStream & stream, uint32_t protocolVersio
 
 	stream << data_size;
 	stream << mode_idx;
-	mode_desc.serialize( stream, protocolVersion );
+	mode_desc->serialize( stream, protocolVersion, params );
 }
 
 bool UpdateMode::deserializeBody( BinaryInputStream & stream, uint32_t protocolVersion ) noexcept
 {
 	stream >> data_size;
 	stream >> mode_idx;
-	mode_desc.deserialize( stream, mode_idx, header.device_idx, protocolVersion );
+	receivedMode.deserialize( stream, protocolVersion, mode_idx, header.device_idx );
+	mode_desc = &receivedMode;
+	params = ModeParams( receivedMode );
 
 	return !stream.failed();
 }
@@ -364,7 +256,7 @@ uint32_t SaveMode::calcDataSize( uint32_t protocolVersion ) const noexcept
 
 	size += sizeof( data_size );
 	size += sizeof( mode_idx );
-	size += mode_desc.calcSize( protocolVersion );
+	size += mode_desc->calcSize( protocolVersion, params );
 
 	return uint32_t( size );
 }
@@ -375,14 +267,16 @@ void SaveMode::serialize( BinaryOutputStream & stream, uint32_t protocolVersion
 
 	stream << data_size;
 	stream << mode_idx;
-	mode_desc.serialize( stream, protocolVersion );
+	mode_desc->serialize( stream, protocolVersion, params );
 }
 
 bool SaveMode::deserializeBody( BinaryInputStream & stream, uint32_t protocolVersion ) noexcept
 {
 	stream >> data_size;
 	stream >> mode_idx;
-	mode_desc.deserialize( stream, mode_idx, header.device_idx, protocolVersion );
+	receivedMode.deserialize( stream, protocolVersion, mode_idx, header.device_idx );
+	mode_desc = &receivedMode;
+	params = ModeParams( receivedMode );
 
 	return !stream.failed();
 }
@@ -394,12 +288,7 @@ uint32_t ReplyProfileList::calcDataSize( uint32_t /*protocolVersion*/ ) const no
 	size_t size = 0;
 
 	size += sizeof( data_size );
-	// Unfortunatelly, these strings break the consistency with the rest by not including the '\0' so it must be counted manually.
-	size += sizeof( uint16_t );  // num_profiles
-	for (const std::string & profile : profiles)
-	{
-		size += 2 + profile.size();
-	}
+	size += protocol::sizeofArray( profiles );
 
 	return uint32_t( size );
 }
@@ -409,13 +298,7 @@ void ReplyProfileList::serialize( own::BinaryOutputStream & stream, uint32_t /*p
 	header.serialize( stream );
 
 	stream << data_size;
-	// Unfortunatelly, these strings break the consistency with the rest by not including the '\0' so it must be written manually.
-	stream << uint16_t( profiles.size() );
-	for (const auto & profile : profiles)
-	{
-		stream << uint16_t( profile.size() );
-		stream.writeString( profile );
-	}
+	protocol::writeArray( stream, profiles );
 }
 
 bool ReplyProfileList::deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
@@ -426,81 +309,6 @@ bool ReplyProfileList::deserializeBody( own::BinaryInputStream & stream, uint32_
 	return !stream.failed();
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-
-uint32_t RequestSaveProfile::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
-{
-	size_t size = 0;
-
-	size += profileName.size() + 1;
-
-	return uint32_t( size );
-}
-
-void RequestSaveProfile::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream.writeString0( profileName );
-}
-
-bool RequestSaveProfile::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream.readString0( profileName );
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-uint32_t RequestLoadProfile::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
-{
-	size_t size = 0;
-
-	size += profileName.size() + 1;
-
-	return uint32_t( size );
-}
-
-void RequestLoadProfile::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream.writeString0( profileName );
-}
-
-bool RequestLoadProfile::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream.readString0( profileName );
-
-	return !stream.failed();
-}
-
-//----------------------------------------------------------------------------------------------------------------------
-
-uint32_t RequestDeleteProfile::calcDataSize( uint32_t /*protocolVersion*/ ) const noexcept
-{
-	size_t size = 0;
-
-	size += profileName.size() + 1;
-
-	return uint32_t( size );
-}
-
-void RequestDeleteProfile::serialize( BinaryOutputStream & stream, uint32_t /*protocolVersion*/ ) const
-{
-	header.serialize( stream );
-
-	stream.writeString0( profileName );
-}
-
-bool RequestDeleteProfile::deserializeBody( BinaryInputStream & stream, uint32_t /*protocolVersion*/ ) noexcept
-{
-	stream.readString0( profileName );
-
-	return !stream.failed();
-}
-
 
 //======================================================================================================================
 
@@ -12,7 +12,7 @@ How to add a new protocol message:
 1. Add an element to enum MessageType with the correct code and update the enumString(...) and isValidMessageType(...)
 
 2. Create a struct from the following template.
-struct NewMessage
+struct NewMessage : public MessageCodec< NewMessage >
 {
 	Header header;
 	... type specific fields ...
@@ -31,18 +31,28 @@ struct NewMessage
 		),
 		... type specific initialization ...
 	{
-		// If the message size is static, you can make calcDataSize constexpr
-		// and move this to the header initializer above.
+		// If the message size is static, you can move this to the header initializer above.
 		header.message_size = calcDataSize();
 	}
 
-	uint32_t calcDataSize( uint32_t protocolVersion ) const noexcept;
-	void serialize( own::BufferOutputStream & stream, uint32_t protocolVersion ) const;
-	bool deserializeBody( own::BufferInputStream & stream, uint32_t protocolVersion ) noexcept;
+	using Fields = MessageFields<
+		Field< NewMessage, uint32_t, &NewMessage::some_field >,
+		... other fields in the order in which they are sent ...
+	>;
 };
 
-3. Implement calcDataSize(), serialize(...) and deserializeBody(...) in the cpp file.
-   If the implementation is really trivial, it can be inline in the header.
+3. The calcDataSize(), serialize(...) and deserializeBody(...) are generated by MessageCodec from the Fields.
+   When all the fields have a fixed size, add a static_assert of fixedDataSize() to the cpp file, the message is then
+   also sent through serialize( uint8_t * buffer, uint32_t protocolVersion ), which stores the fields at constant offsets.
+
+   Bodies that consist of whole devices or modes, or that need special treatment like the color corrections,
+   don't fit into a field list. Such a struct doesn't derive from MessageCodec, it declares
+	uint32_t calcDataSize( uint32_t protocolVersion ) const noexcept;
+	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion ) const;
+	bool deserializeBody( own::BinaryInputStream & stream, uint32_t protocolVersion ) noexcept;
+   and implements them in the cpp file. A message sent often can declare
+	void serialize( uint8_t * buffer, uint32_t protocolVersion ) const noexcept;
+   instead of the stream variant, see protocol::serializeMessage(...).
 
 
 How to extend an existing message:
@@ -52,11 +62,14 @@ How to extend an existing message:
 
 2. If required, add this member to the constructor params and to the initialization list.
 
-3. Extend the implementation of calcDataSize(), serialize(...) and deserializeBody(...) to count with the new member.
+3. Add the member to the Fields with the protocol version that introduced it, for example
+   Field< NewMessage, uint32_t, &NewMessage::new_field, 4 >. The constructor must then pass the protocol version
+   to calcDataSize(...). For the hand-written messages, extend the implementation of calcDataSize(), serialize(...)
+   and deserializeBody(...) instead.
 
 4. Increment the implementedProtocolVersion constant.
 
-4. Edit the protocol_description.txt to mirror these changes.
+5. Edit the protocol_description.txt to mirror these changes.
 
 */
 
@@ -68,6 +81,9 @@ How to extend an existing message:
 
 #include <OpenRGB/DeviceInfo.hpp>
 #include <OpenRGB/Color.hpp>
+#include <OpenRGB/Span.hpp>
+#include "CorrectionSegment.hpp"
+#include "MessageCodec.hpp"
 
 #include <cstdint>
 #include <string>
@@ -112,6 +128,7 @@ enum class MessageType : uint32_t
 	RGBCONTROLLER_SAVEMODE         = 1102,
 };
 const char * enumString( MessageType ) noexcept;
+bool isValidMessageType( MessageType ) noexcept;
 
 /// Every protocol message starts with this.
 struct Header
@@ -130,6 +147,7 @@ struct Header
 	static constexpr size_t size() noexcept { return sizeof(Header); }  // all members are equally big, no padding will take place
 
 	void serialize( own::BinaryOutputStream & stream ) const;
+	uint8_t * serialize( uint8_t * pos ) const noexcept;
 	bool deserialize( own::BinaryInputStream & stream ) noexcept;
 };
 
@@ -138,7 +156,7 @@ struct Header
 //  main protocol messages
 
 /// Asks server how many RGB devices (controllers) there are.
-struct RequestControllerCount
+struct RequestControllerCount : public MessageCodec< RequestControllerCount >
 {
 	Header header;
 
@@ -155,22 +173,11 @@ struct RequestControllerCount
 		)
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return 0;
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const
-	{
-		header.serialize( stream );
-	}
-	bool deserializeBody( own::BinaryInputStream & /*stream*/, uint32_t /*protocolVersion*/ = 0 ) noexcept
-	{
-		return true;
-	}
+	using Fields = MessageFields<>;
 };
 
 /// A reply to RequestControllerCount
-struct ReplyControllerCount
+struct ReplyControllerCount : public MessageCodec< ReplyControllerCount >
 {
 	Header header;
 	uint32_t count;
@@ -190,16 +197,13 @@ struct ReplyControllerCount
 		count( count )
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return sizeof( count );
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< ReplyControllerCount, uint32_t, &ReplyControllerCount::count >
+	>;
 };
 
 /// Asks for all information and supported modes about a specific RGB device (controller).
-struct RequestControllerData
+struct RequestControllerData : public MessageCodec< RequestControllerData >
 {
 	Header header;
 	uint32_t protocolVersion;
@@ -219,12 +223,9 @@ struct RequestControllerData
 		protocolVersion( protocolVersion )
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return sizeof( protocolVersion );
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< RequestControllerData, uint32_t, &RequestControllerData::protocolVersion >
+	>;
 };
 
 /// A reply to RequestControllerData
@@ -256,7 +257,7 @@ struct ReplyControllerData
 };
 
 /// Tells the server in what version of the protocol the client wants to communite in.
-struct RequestProtocolVersion
+struct RequestProtocolVersion : public MessageCodec< RequestProtocolVersion >
 {
 	Header header;
 	uint32_t clientVersion;
@@ -265,6 +266,7 @@ struct RequestProtocolVersion
 
 	static constexpr MessageType thisType = MessageType::REQUEST_PROTOCOL_VERSION;
 
+	RequestProtocolVersion() noexcept {}
 	RequestProtocolVersion( uint32_t clientVersion )
 	:
 		header(
@@ -275,16 +277,13 @@ struct RequestProtocolVersion
 		clientVersion( clientVersion )
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return sizeof( clientVersion );
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< RequestProtocolVersion, uint32_t, &RequestProtocolVersion::clientVersion >
+	>;
 };
 
 /// A reply to RequestProtocolVersion. Contains the maximum version the server supports.
-struct ReplyProtocolVersion
+struct ReplyProtocolVersion : public MessageCodec< ReplyProtocolVersion >
 {
 	Header header;
 	uint32_t serverVersion;
@@ -304,16 +303,13 @@ struct ReplyProtocolVersion
 		serverVersion( serverVersion )
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return sizeof( serverVersion );
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< ReplyProtocolVersion, uint32_t, &ReplyProtocolVersion::serverVersion >
+	>;
 };
 
 /// Announces a custom name of the client to the server.
-struct SetClientName
+struct SetClientName : public MessageCodec< SetClientName >
 {
 	Header header;
 	std::string name;
@@ -334,13 +330,13 @@ struct SetClientName
 		header.message_size = calcDataSize();
 	}
 
-	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< SetClientName, std::string, &SetClientName::name >
+	>;
 };
 
 /// This is sent from the server everytime its device list has changed.
-struct DeviceListUpdated
+struct DeviceListUpdated : public MessageCodec< DeviceListUpdated >
 {
 	Header header;
 
@@ -357,22 +353,11 @@ struct DeviceListUpdated
 		)
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return 0;
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const
-	{
-		header.serialize( stream );
-	}
-	bool deserializeBody( own::BinaryInputStream & /*stream*/, uint32_t /*protocolVersion*/ = 0 ) noexcept
-	{
-		return true;
-	}
+	using Fields = MessageFields<>;
 };
 
 /// Resizes a zone of LEDs, if the device supports it.
-struct ResizeZone
+struct ResizeZone : public MessageCodec< ResizeZone >
 {
 	Header header;
 	uint32_t zone_idx;
@@ -394,12 +379,10 @@ struct ResizeZone
 		new_size( newSize )
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return sizeof( zone_idx ) + sizeof( new_size );
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< ResizeZone, uint32_t, &ResizeZone::zone_idx >,
+		Field< ResizeZone, uint32_t, &ResizeZone::new_size >
+	>;
 };
 
 /// Applies individually selected color to every LED.
@@ -407,26 +390,50 @@ struct UpdateLEDs
 {
 	Header  header;
 	uint32_t  data_size;
-	std::vector< Color >  colors;
+	Span< const Color >  colors;  ///< points either to the caller's colors or to receivedColors
+	Span< const CorrectionSegment >  corrections;  ///< applied during serialization, not part of the message
+	Color     fillColor;      ///< sent fillCount times instead of the colors, when fillCount is not 0
+	uint32_t  fillCount = 0;
+
+	std::vector< Color >  receivedColors;  ///< storage for deserialization
 
  // support for templated processing
 
 	static constexpr MessageType thisType = MessageType::RGBCONTROLLER_UPDATELEDS;
 
 	UpdateLEDs() noexcept {}
-	UpdateLEDs( uint32_t deviceIdx, const std::vector< Color > & colors )
+	UpdateLEDs( uint32_t deviceIdx, Span< const Color > colors, Span< const CorrectionSegment > corrections = {} )
 	:
 		header(
 			/*message_type*/ thisType,
 			/*device_idx*/   deviceIdx
 		),
-		colors( colors )
+		colors( colors ),
+		corrections( corrections )
+	{
+		header.message_size = data_size = calcDataSize();
+	}
+	/// Sets all the LEDs to the same color without needing an array of them.
+	UpdateLEDs( uint32_t deviceIdx, Color color, uint32_t ledCount, Span< const CorrectionSegment > corrections = {} )
+	:
+		header(
+			/*message_type*/ thisType,
+			/*device_idx*/   deviceIdx
+		),
+		corrections( corrections ),
+		fillColor( color ),
+		fillCount( ledCount )
 	{
 		header.message_size = data_size = calcDataSize();
 	}
 
+	// a copy would point to the colors of the original
+	UpdateLEDs( const UpdateLEDs & other ) = delete;
+	UpdateLEDs( UpdateLEDs && other ) noexcept = default;
+	UpdateLEDs & operator=( UpdateLEDs && other ) noexcept = default;
+
 	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
+	void serialize( uint8_t * buffer, uint32_t /*protocolVersion*/ = 0 ) const noexcept;
 	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
 };
 
@@ -436,32 +443,57 @@ struct UpdateZoneLEDs
 	Header  header;
 	uint32_t  data_size;
 	uint32_t  zone_idx;
-	std::vector< Color >  colors;
+	Span< const Color >  colors;  ///< points either to the caller's colors or to receivedColors
+	Span< const CorrectionSegment >  corrections;  ///< applied during serialization, not part of the message
+	Color     fillColor;      ///< sent fillCount times instead of the colors, when fillCount is not 0
+	uint32_t  fillCount = 0;
+
+	std::vector< Color >  receivedColors;  ///< storage for deserialization
 
  // support for templated processing
 
 	static constexpr MessageType thisType = MessageType::RGBCONTROLLER_UPDATEZONELEDS;
 
 	UpdateZoneLEDs() noexcept {}
-	UpdateZoneLEDs( uint32_t deviceIdx, uint32_t zoneIdx, const std::vector< Color > & colors )
+	UpdateZoneLEDs( uint32_t deviceIdx, uint32_t zoneIdx, Span< const Color > colors, Span< const CorrectionSegment > corrections = {} )
 	:
 		header(
 			/*message_type*/ thisType,
 			/*device_idx*/   deviceIdx
 		),
 		zone_idx( zoneIdx ),
-		colors( colors )
+		colors( colors ),
+		corrections( corrections )
+	{
+		header.message_size = data_size = calcDataSize();
+	}
+	/// Sets all the LEDs of the zone to the same color without needing an array of them.
+	UpdateZoneLEDs( uint32_t deviceIdx, uint32_t zoneIdx, Color color, uint32_t ledCount, Span< const CorrectionSegment > corrections = {} )
+	:
+		header(
+			/*message_type*/ thisType,
+			/*device_idx*/   deviceIdx
+		),
+		zone_idx( zoneIdx ),
+		corrections( corrections ),
+		fillColor( color ),
+		fillCount( ledCount )
 	{
 		header.message_size = data_size = calcDataSize();
 	}
 
+	// a copy would point to the colors of the original
+	UpdateZoneLEDs( const UpdateZoneLEDs & other ) = delete;
+	UpdateZoneLEDs( UpdateZoneLEDs && other ) noexcept = default;
+	UpdateZoneLEDs & operator=( UpdateZoneLEDs && other ) noexcept = default;
+
 	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
+	void serialize( uint8_t * buffer, uint32_t /*protocolVersion*/ = 0 ) const noexcept;
 	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
 };
 
 /// Changes color of a single particular LED.
-struct UpdateSingleLED
+struct UpdateSingleLED : public MessageCodec< UpdateSingleLED >
 {
 	Header  header;
 	uint32_t  led_idx;
@@ -483,13 +515,14 @@ struct UpdateSingleLED
 		color( color )
 	{}
 
-	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< UpdateSingleLED, uint32_t, &UpdateSingleLED::led_idx >,
+		Field< UpdateSingleLED, Color, &UpdateSingleLED::color >
+	>;
 };
 
 /// Switches mode of a device to a directly controlled one.
-struct SetCustomMode
+struct SetCustomMode : public MessageCodec< SetCustomMode >
 {
 	Header  header;
 
@@ -507,18 +540,7 @@ struct SetCustomMode
 		)
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return 0;
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const
-	{
-		header.serialize( stream );
-	}
-	bool deserializeBody( own::BinaryInputStream & /*stream*/, uint32_t /*protocolVersion*/ = 0 ) noexcept
-	{
-		return true;
-	}
+	using Fields = MessageFields<>;
 };
 
 /// Updates the parameters of a mode and also switches the device to this mode.
@@ -527,25 +549,31 @@ struct UpdateMode
 	Header  header;
 	uint32_t  data_size;
 	uint32_t  mode_idx;
-	Mode      mode_desc;
+	Mode  receivedMode;  ///< storage for deserialization, declared first so that it exists before params point to it
+	const Mode *  mode_desc;  ///< points either to the caller's mode or to receivedMode
+	ModeParams    params;     ///< sent instead of the parameters stored in mode_desc
 
  // support for templated processing
 
 	static constexpr MessageType thisType = MessageType::RGBCONTROLLER_UPDATEMODE;
 
-	UpdateMode() noexcept {}
-	UpdateMode( uint32_t deviceIdx, uint32_t modeIdx, const Mode & mode, uint32_t protocolVersion )
+	UpdateMode() noexcept : mode_desc( &receivedMode ), params( receivedMode ) {}
+	UpdateMode( uint32_t deviceIdx, uint32_t modeIdx, const Mode & mode, const ModeParams & params, uint32_t protocolVersion )
 	:
 		header(
 			/*message_type*/ thisType,
 			/*device_idx*/   deviceIdx
 		),
 		mode_idx( modeIdx ),
-		mode_desc( mode )
+		mode_desc( &mode ),
+		params( params )
 	{
 		header.message_size = data_size = calcDataSize( protocolVersion );
 	}
 
+	// a copy would point to the mode of the original
+	UpdateMode( const UpdateMode & other ) = delete;
+
 	uint32_t calcDataSize( uint32_t protocolVersion ) const noexcept;
 	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion ) const;
 	bool deserializeBody( own::BinaryInputStream & stream, uint32_t protocolVersion ) noexcept;
@@ -557,32 +585,38 @@ struct SaveMode
 	Header  header;
 	uint32_t  data_size;
 	uint32_t  mode_idx;
-	Mode      mode_desc;
+	Mode  receivedMode;  ///< storage for deserialization, declared first so that it exists before params point to it
+	const Mode *  mode_desc;  ///< points either to the caller's mode or to receivedMode
+	ModeParams    params;     ///< sent instead of the parameters stored in mode_desc
 
  // support for templated processing
 
 	static constexpr MessageType thisType = MessageType::RGBCONTROLLER_SAVEMODE;
 
-	SaveMode() noexcept {}
-	SaveMode( uint32_t deviceIdx, uint32_t modeIdx, const Mode & mode, uint32_t protocolVersion )
+	SaveMode() noexcept : mode_desc( &receivedMode ), params( receivedMode ) {}
+	SaveMode( uint32_t deviceIdx, uint32_t modeIdx, const Mode & mode, const ModeParams & params, uint32_t protocolVersion )
 	:
 		header(
 			/*message_type*/ thisType,
 			/*device_idx*/   deviceIdx
 		),
 		mode_idx( modeIdx ),
-		mode_desc( mode )
+		mode_desc( &mode ),
+		params( params )
 	{
 		header.message_size = data_size = calcDataSize( protocolVersion );
 	}
 
+	// a copy would point to the mode of the original
+	SaveMode( const SaveMode & other ) = delete;
+
 	uint32_t calcDataSize( uint32_t protocolVersion ) const noexcept;
 	void serialize( own::BinaryOutputStream & stream, uint32_t protocolVersion ) const;
 	bool deserializeBody( own::BinaryInputStream & stream, uint32_t protocolVersion ) noexcept;
 };
 
 /// Asks for a list of saved profiles.
-struct RequestProfileList
+struct RequestProfileList : public MessageCodec< RequestProfileList >
 {
 	Header  header;
 
@@ -599,18 +633,7 @@ struct RequestProfileList
 		)
 	{}
 
-	constexpr uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept
-	{
-		return 0;
-	}
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const
-	{
-		header.serialize( stream );
-	}
-	bool deserializeBody( own::BinaryInputStream & /*stream*/, uint32_t /*protocolVersion*/ = 0 ) noexcept
-	{
-		return true;
-	}
+	using Fields = MessageFields<>;
 };
 
 /// A reply to RequestProfileList
@@ -633,7 +656,7 @@ struct ReplyProfileList
 		),
 		profiles( profiles )
 	{
-		header.message_size = calcDataSize();
+		header.message_size = data_size = calcDataSize();
 	}
 
 	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
@@ -643,7 +666,7 @@ struct ReplyProfileList
 
 
 /// Saves the current configuration of all devices under a new profile name.
-struct RequestSaveProfile
+struct RequestSaveProfile : public MessageCodec< RequestSaveProfile >
 {
 	Header  header;
 	std::string profileName;
@@ -652,6 +675,7 @@ struct RequestSaveProfile
 
 	static constexpr MessageType thisType = MessageType::REQUEST_SAVE_PROFILE;
 
+	RequestSaveProfile() noexcept {}
 	RequestSaveProfile( const std::string & profileName ) noexcept
 	:
 		header(
@@ -663,13 +687,13 @@ struct RequestSaveProfile
 		header.message_size = calcDataSize();
 	}
 
-	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< RequestSaveProfile, std::string, &RequestSaveProfile::profileName >
+	>;
 };
 
 /// Applies an existing profile.
-struct RequestLoadProfile
+struct RequestLoadProfile : public MessageCodec< RequestLoadProfile >
 {
 	Header  header;
 	std::string profileName;
@@ -678,6 +702,7 @@ struct RequestLoadProfile
 
 	static constexpr MessageType thisType = MessageType::REQUEST_LOAD_PROFILE;
 
+	RequestLoadProfile() noexcept {}
 	RequestLoadProfile( const std::string & profileName ) noexcept
 	:
 		header(
@@ -689,13 +714,13 @@ struct RequestLoadProfile
 		header.message_size = calcDataSize();
 	}
 
-	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< RequestLoadProfile, std::string, &RequestLoadProfile::profileName >
+	>;
 };
 
 /// Removes an existing profile.
-struct RequestDeleteProfile
+struct RequestDeleteProfile : public MessageCodec< RequestDeleteProfile >
 {
 	Header  header;
 	std::string profileName;
@@ -704,6 +729,7 @@ struct RequestDeleteProfile
 
 	static constexpr MessageType thisType = MessageType::REQUEST_DELETE_PROFILE;
 
+	RequestDeleteProfile() noexcept {}
 	RequestDeleteProfile( const std::string & profileName ) noexcept
 	:
 		header(
@@ -715,9 +741,9 @@ struct RequestDeleteProfile
 		header.message_size = calcDataSize();
 	}
 
-	uint32_t calcDataSize( uint32_t /*protocolVersion*/ = 0 ) const noexcept;
-	void serialize( own::BinaryOutputStream & stream, uint32_t /*protocolVersion*/ = 0 ) const;
-	bool deserializeBody( own::BinaryInputStream & stream, uint32_t /*protocolVersion*/ = 0 ) noexcept;
+	using Fields = MessageFields<
+		Field< RequestDeleteProfile, std::string, &RequestDeleteProfile::profileName >
+	>;
 };
 
 
@@ -0,0 +1,791 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: OpenRGB protocol server for exposing devices to OpenRGB clients
+//======================================================================================================================
+
+#include <OpenRGB/Server.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include "ProtocolMessages.hpp"
+#include "MiscUtils.hpp"
+
+#include <CppUtils-Essential/BinaryStream.hpp>
+using own::BinaryOutputStream;
+using own::BinaryInputStream;
+#include <CppUtils-Essential/Span.hpp>
+using own::span;
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <memory>
+using std::unique_ptr;
+#include <unordered_map>
+#include <atomic>
+#include <algorithm>  // min
+
+#ifdef __linux__
+	#include <sys/socket.h>
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <arpa/inet.h>
+	#include <unistd.h>
+#endif
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  enum to string conversion
+
+const char * enumString( ServerStatus status ) noexcept
+{
+	static const char * const ServerStatusStr [] =
+	{
+		"The operation was successful.",
+		"The server is not implemented on this operating system yet.",
+		"The server is already listening.",
+		"The server is not listening.",
+		"The address to listen on is not a valid IPv4 address.",
+		"The socket could not be bound to the address or port.",
+		"Other system error.",
+		"Internal error of this library. Please create a github issue.",
+	};
+	static_assert( size_t(ServerStatus::UnexpectedError) + 1 == fut::size(ServerStatusStr), "update the ServerStatusStr" );
+
+	if (size_t(status) < fut::size(ServerStatusStr))
+	{
+		return ServerStatusStr[ size_t(status) ];
+	}
+	else
+	{
+		return "<invalid status>";
+	}
+}
+
+
+#ifdef __linux__
+
+
+//======================================================================================================================
+//  implementation based on epoll
+
+// Anything bigger is not a valid OpenRGB message, most likely garbage or an attack.
+static const uint32_t maxMessageSize = 16 * 1024 * 1024;
+// A client that doesn't read its replies is disconnected before it exhausts our memory.
+static const size_t maxPendingOutput = 16 * 1024 * 1024;
+
+// How much is read from one client at once. Reading once per event keeps the server fair to all the clients.
+static const size_t receiveChunk = 64 * 1024;
+
+static const int maxEventsAtOnce = 64;
+
+struct Connection
+{
+	int socket;
+	ServerClientInfo info;
+	vector< uint8_t > received;  ///< bytes of the messages that haven't been processed yet
+	vector< uint8_t > toSend;    ///< replies that didn't fit into the socket buffer
+	size_t sentBytes;            ///< how much of toSend has already been sent
+	bool waitingForWrite;        ///< whether we're subscribed for the writability of the socket
+	bool failed;                 ///< the connection should be closed as soon as we're done with it
+
+	Connection( int socket ) : socket( socket ), info(), sentBytes( 0 ), waitingForWrite( false ), failed( false ) {}
+};
+
+template< typename Message >
+static bool parseMessage( Message & message, const Header & header, const uint8_t * body, uint32_t protocolVersion ) noexcept
+{
+	message.header = header;
+	BinaryInputStream stream( span< const uint8_t >( body, header.message_size ) );
+	return message.deserializeBody( stream, protocolVersion );
+}
+
+struct Server::Impl
+{
+	ServerHandler & handler;
+
+	int listenSocket;
+	int epollFd;
+	int wakeFd;  ///< eventfd for waking up the thread waiting in epoll
+	uint16_t listenPort;
+
+	uint64_t nextClientId;
+	std::unordered_map< int, unique_ptr< Connection > > connections;
+	vector< uint8_t > receiveBuffer;  ///< where the bytes of any client are read before they are appended to its messages
+
+	std::atomic< bool > interruptRequested;
+	std::atomic< bool > deviceListUpdated;
+
+	system_error_t lastSystemError;
+
+	Impl( ServerHandler & handler )
+	:
+		handler( handler ),
+		listenSocket( -1 ),
+		epollFd( -1 ),
+		wakeFd( -1 ),
+		listenPort( 0 ),
+		nextClientId( 1 ),
+		interruptRequested( false ),
+		deviceListUpdated( false ),
+		lastSystemError( 0 )
+	{}
+
+	//-- listening -----------------------------------------------------------------------------------------------------
+
+	ServerStatus start( uint16_t port, const string & address )
+	{
+		if (listenSocket >= 0)
+			return ServerStatus::AlreadyRunning;
+
+		sockaddr_in addr;
+		memset( &addr, 0, sizeof(addr) );
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons( port );
+		if (inet_pton( AF_INET, address.c_str(), &addr.sin_addr ) != 1)
+			return ServerStatus::InvalidAddress;
+
+		listenSocket = ::socket( AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+		if (listenSocket < 0)
+			return failStart( ServerStatus::OtherSystemError );
+
+		// allow restarting the server immediately, without waiting for the old connections to time out
+		int one = 1;
+		setsockopt( listenSocket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+
+		socklen_t addrLen = sizeof(addr);
+		if (::bind( listenSocket, reinterpret_cast< sockaddr * >( &addr ), sizeof(addr) ) != 0
+		 || ::listen( listenSocket, SOMAXCONN ) != 0
+		 || ::getsockname( listenSocket, reinterpret_cast< sockaddr * >( &addr ), &addrLen ) != 0)
+		{
+			return failStart( ServerStatus::CannotListen );
+		}
+		listenPort = ntohs( addr.sin_port );
+
+		epollFd = epoll_create1( EPOLL_CLOEXEC );
+		wakeFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+		if (epollFd < 0 || wakeFd < 0 || !watch( listenSocket, EPOLLIN, EPOLL_CTL_ADD ) || !watch( wakeFd, EPOLLIN, EPOLL_CTL_ADD ))
+			return failStart( ServerStatus::OtherSystemError );
+
+		return ServerStatus::Success;
+	}
+
+	ServerStatus failStart( ServerStatus status )
+	{
+		lastSystemError = errno;
+		stop();
+		return status;
+	}
+
+	void stop()
+	{
+		while (!connections.empty())
+			closeConnection( connections.begin() );
+
+		for (int * fd : { &listenSocket, &epollFd, &wakeFd })
+		{
+			if (*fd >= 0)
+			{
+				::close( *fd );
+				*fd = -1;
+			}
+		}
+		listenPort = 0;
+	}
+
+	bool isRunning() const  { return listenSocket >= 0; }
+	uint16_t port() const  { return listenPort; }
+	size_t clientCount() const  { return connections.size(); }
+
+	bool watch( int fd, uint32_t events, int operation )
+	{
+		epoll_event event;
+		memset( &event, 0, sizeof(event) );
+		event.events = events;
+		event.data.fd = fd;
+		return epoll_ctl( epollFd, operation, fd, &event ) == 0;
+	}
+
+	//-- event loop ----------------------------------------------------------------------------------------------------
+
+	ServerStatus processEvents( int timeoutMs )
+	{
+		if (listenSocket < 0)
+			return ServerStatus::NotRunning;
+
+		epoll_event events [maxEventsAtOnce];
+		int eventCount = epoll_wait( epollFd, events, maxEventsAtOnce, timeoutMs );
+		if (eventCount < 0)
+		{
+			if (errno == EINTR)
+				return ServerStatus::Success;
+			lastSystemError = errno;
+			return ServerStatus::OtherSystemError;
+		}
+
+		for (int i = 0; i < eventCount; ++i)
+		{
+			int fd = events[i].data.fd;
+			if (fd == listenSocket)
+			{
+				acceptClients();
+			}
+			else if (fd == wakeFd)
+			{
+				uint64_t value;
+				while (::read( wakeFd, &value, sizeof(value) ) > 0) {}
+			}
+			else
+			{
+				// the connection could have been closed by a previous event of this batch
+				auto connIter = connections.find( fd );
+				if (connIter == connections.end())
+					continue;
+				Connection & conn = *connIter->second;
+
+				if (events[i].events & EPOLLERR)
+					conn.failed = true;
+				// EPOLLHUP comes with EPOLLIN, recv will report the closed connection after the remaining data
+				if (!conn.failed && (events[i].events & (EPOLLIN | EPOLLHUP)))
+					receive( conn );
+				if (!conn.failed && (events[i].events & EPOLLOUT))
+					flush( conn );
+
+				if (conn.failed)
+					closeConnection( connIter );
+			}
+		}
+
+		// checked after every wake up, so that the notification is sent even when the wake up event was consumed earlier
+		if (deviceListUpdated.exchange( false ))
+			broadcastDeviceListUpdated();
+
+		return ServerStatus::Success;
+	}
+
+	ServerStatus run()
+	{
+		while (!interruptRequested.exchange( false ))
+		{
+			ServerStatus status = processEvents( -1 );
+			if (status != ServerStatus::Success)
+				return status;
+		}
+		return ServerStatus::Success;
+	}
+
+	void wakeUp()
+	{
+		// write() is async-signal-safe, so this can be called from a signal handler
+		if (wakeFd >= 0)
+		{
+			uint64_t one = 1;
+			ssize_t written = ::write( wakeFd, &one, sizeof(one) );
+			(void)written;  // the counter can only overflow when already signalled
+		}
+	}
+
+	//-- connections ---------------------------------------------------------------------------------------------------
+
+	void acceptClients()
+	{
+		for (;;)
+		{
+			sockaddr_in addr;
+			socklen_t addrLen = sizeof(addr);
+			int socket = accept4( listenSocket, reinterpret_cast< sockaddr * >( &addr ), &addrLen, SOCK_NONBLOCK | SOCK_CLOEXEC );
+			if (socket < 0)
+			{
+				if (errno == EINTR || errno == ECONNABORTED)
+					continue;
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+					lastSystemError = errno;  // most likely out of file descriptors, try again on the next event
+				return;
+			}
+
+			// the replies are always whole messages, don't let the kernel delay them
+			int one = 1;
+			setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+
+			if (!watch( socket, EPOLLIN, EPOLL_CTL_ADD ))
+			{
+				lastSystemError = errno;
+				::close( socket );
+				continue;
+			}
+
+			unique_ptr< Connection > conn( new Connection( socket ) );
+			conn->info.id = nextClientId++;
+			char addrStr [INET_ADDRSTRLEN] = "";
+			inet_ntop( AF_INET, &addr.sin_addr, addrStr, sizeof(addrStr) );
+			conn->info.address = addrStr;
+			conn->info.protocolVersion = 0;
+
+			const ServerClientInfo & info = conn->info;
+			auto connIter = connections.emplace( socket, std::move( conn ) ).first;
+			try
+			{
+				handler.clientConnected( info );
+			}
+			CATCH_ALL(
+				// the handler doesn't know about this client, so it won't get clientDisconnected(...) either
+				connections.erase( connIter );
+				epoll_ctl( epollFd, EPOLL_CTL_DEL, socket, nullptr );
+				::close( socket );
+			)
+		}
+	}
+
+	void closeConnection( std::unordered_map< int, unique_ptr< Connection > >::iterator connIter )
+	{
+		unique_ptr< Connection > conn = std::move( connIter->second );
+		connections.erase( connIter );
+
+		epoll_ctl( epollFd, EPOLL_CTL_DEL, conn->socket, nullptr );
+		::close( conn->socket );
+
+		try
+		{
+			handler.clientDisconnected( conn->info );
+		}
+		CATCH_ALL()
+	}
+
+	void receive( Connection & conn )
+	{
+		// Growing conn.received by a whole chunk would zero-fill it on every event, so read into a shared buffer
+		// and append only what has arrived.
+		if (receiveBuffer.empty())
+			receiveBuffer.resize( receiveChunk );
+		ssize_t received = ::recv( conn.socket, receiveBuffer.data(), receiveBuffer.size(), 0 );
+
+		if (received == 0)
+		{
+			conn.failed = true;  // closed by the client
+			return;
+		}
+		else if (received < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+				conn.failed = true;
+			return;
+		}
+
+		conn.received.insert( conn.received.end(), receiveBuffer.begin(), receiveBuffer.begin() + received );
+		processMessages( conn );
+	}
+
+	void processMessages( Connection & conn )
+	{
+		size_t pos = 0;
+		while (!conn.failed && conn.received.size() - pos >= Header::size())
+		{
+			const uint8_t * messageData = conn.received.data() + pos;
+
+			// We can't stay in sync with a client that sends something else than messages.
+			if (memcmp( messageData, "ORGB", 4 ) != 0)
+			{
+				conn.failed = true;
+				break;
+			}
+
+			Header header;
+			BinaryInputStream headerStream( span< const uint8_t >( messageData, Header::size() ) );
+			bool isKnownType = header.deserialize( headerStream );
+			if (header.message_size > maxMessageSize)
+			{
+				conn.failed = true;
+				break;
+			}
+
+			size_t messageSize = Header::size() + header.message_size;
+			if (conn.received.size() - pos < messageSize)
+				break;  // wait for the rest
+
+			// messages of newer protocol versions are skipped, the client can't expect us to understand them
+			if (isKnownType)
+			{
+				try
+				{
+					if (!handleMessage( conn, header, messageData + Header::size() ))
+						conn.failed = true;
+				}
+				CATCH_ALL (
+					conn.failed = true;
+				)
+			}
+
+			pos += messageSize;
+		}
+
+		conn.received.erase( conn.received.begin(), conn.received.begin() + ptrdiff_t( pos ) );
+	}
+
+	//-- requests ------------------------------------------------------------------------------------------------------
+
+	bool isValidDevice( uint32_t deviceIdx )
+	{
+		return deviceIdx < handler.deviceCount();
+	}
+
+	// returns false when the message is damaged
+	bool handleMessage( Connection & conn, const Header & header, const uint8_t * body )
+	{
+		ServerClientInfo & info = conn.info;
+
+		switch (header.message_type)
+		{
+			case MessageType::REQUEST_CONTROLLER_COUNT:
+			{
+				sendMessage( conn, ReplyControllerCount( handler.deviceCount() ) );
+				return true;
+			}
+			case MessageType::REQUEST_CONTROLLER_DATA:
+			{
+				// older clients don't send the version
+				uint32_t version = 0;
+				if (header.message_size > 0)
+				{
+					RequestControllerData request;
+					if (!parseMessage( request, header, body, info.protocolVersion ))
+						return false;
+					version = std::min( request.protocolVersion, uint32_t( implementedProtocolVersion ) );
+				}
+				// requests for devices that don't exist are ignored like in OpenRGB
+				const Device * device = handler.device( header.device_idx );
+				if (device)
+					sendMessage( conn, ReplyControllerData( header.device_idx, *device, version ), version );
+				return true;
+			}
+			case MessageType::REQUEST_PROTOCOL_VERSION:
+			{
+				RequestProtocolVersion request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				info.protocolVersion = std::min( request.clientVersion, uint32_t( implementedProtocolVersion ) );
+				sendMessage( conn, ReplyProtocolVersion( implementedProtocolVersion ) );
+				return true;
+			}
+			case MessageType::SET_CLIENT_NAME:
+			{
+				SetClientName request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				info.name = std::move( request.name );
+				handler.clientNamed( info );
+				return true;
+			}
+			case MessageType::REQUEST_PROFILE_LIST:
+			{
+				sendMessage( conn, ReplyProfileList( handler.profileList( info ) ) );
+				return true;
+			}
+			case MessageType::REQUEST_SAVE_PROFILE:
+			{
+				RequestSaveProfile request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				handler.saveProfile( info, request.profileName );
+				return true;
+			}
+			case MessageType::REQUEST_LOAD_PROFILE:
+			{
+				RequestLoadProfile request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				handler.loadProfile( info, request.profileName );
+				return true;
+			}
+			case MessageType::REQUEST_DELETE_PROFILE:
+			{
+				RequestDeleteProfile request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				handler.deleteProfile( info, request.profileName );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_RESIZEZONE:
+			{
+				ResizeZone request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.resizeZone( info, header.device_idx, request.zone_idx, request.new_size );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_UPDATELEDS:
+			{
+				UpdateLEDs request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.updateLEDs( info, header.device_idx, request.colors );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_UPDATEZONELEDS:
+			{
+				UpdateZoneLEDs request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.updateZoneLEDs( info, header.device_idx, request.zone_idx, request.colors );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_UPDATESINGLELED:
+			{
+				UpdateSingleLED request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.updateSingleLED( info, header.device_idx, request.led_idx, request.color );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_SETCUSTOMMODE:
+			{
+				if (isValidDevice( header.device_idx ))
+					handler.setCustomMode( info, header.device_idx );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_UPDATEMODE:
+			{
+				UpdateMode request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.updateMode( info, header.device_idx, request.receivedMode );
+				return true;
+			}
+			case MessageType::RGBCONTROLLER_SAVEMODE:
+			{
+				SaveMode request;
+				if (!parseMessage( request, header, body, info.protocolVersion ))
+					return false;
+				if (isValidDevice( header.device_idx ))
+					handler.saveMode( info, header.device_idx, request.receivedMode );
+				return true;
+			}
+			default:
+			{
+				// DEVICE_LIST_UPDATED is sent only by the server
+				return true;
+			}
+		}
+	}
+
+	//-- replies -------------------------------------------------------------------------------------------------------
+
+	template< typename Message >
+	void sendMessage( Connection & conn, const Message & message )
+	{
+		sendMessage( conn, message, conn.info.protocolVersion );
+	}
+
+	template< typename Message >
+	void sendMessage( Connection & conn, const Message & message, uint32_t protocolVersion )
+	{
+		// serialize directly behind the replies that are still waiting (header.message_size is calculated in constructor)
+		size_t messageSize = message.header.size() + message.header.message_size;
+		size_t offset = conn.toSend.size();
+		conn.toSend.resize( offset + messageSize );
+		protocol::serializeMessage( message, conn.toSend.data() + offset, messageSize, protocolVersion );
+
+		if (conn.toSend.size() - conn.sentBytes > maxPendingOutput)
+		{
+			conn.failed = true;
+			return;
+		}
+
+		// if the socket was already full, just wait for EPOLLOUT
+		if (!conn.waitingForWrite)
+			flush( conn );
+	}
+
+	void flush( Connection & conn )
+	{
+		while (conn.sentBytes < conn.toSend.size())
+		{
+			ssize_t sent = ::send( conn.socket, conn.toSend.data() + conn.sentBytes, conn.toSend.size() - conn.sentBytes, MSG_NOSIGNAL );
+			if (sent < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+				{
+					conn.failed = true;
+					return;
+				}
+				// the socket buffer is full, continue when the client reads some
+				if (!conn.waitingForWrite)
+				{
+					conn.waitingForWrite = true;
+					if (!watch( conn.socket, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD ))
+						conn.failed = true;
+				}
+				return;
+			}
+			conn.sentBytes += size_t( sent );
+		}
+
+		// everything is sent, the buffer keeps its capacity for the next replies
+		conn.toSend.clear();
+		conn.sentBytes = 0;
+		if (conn.waitingForWrite)
+		{
+			conn.waitingForWrite = false;
+			if (!watch( conn.socket, EPOLLIN, EPOLL_CTL_MOD ))
+				conn.failed = true;
+		}
+	}
+
+	void broadcastDeviceListUpdated()
+	{
+		DeviceListUpdated message;
+		for (auto connIter = connections.begin(); connIter != connections.end(); )
+		{
+			sendMessage( *connIter->second, message );
+			if (connIter->second->failed)
+			{
+				auto failedIter = connIter++;
+				closeConnection( failedIter );
+			}
+			else
+			{
+				++connIter;
+			}
+		}
+	}
+};
+
+
+#else // __linux__
+
+
+//======================================================================================================================
+//  other systems are not supported yet
+
+struct Server::Impl
+{
+	std::atomic< bool > interruptRequested;
+	std::atomic< bool > deviceListUpdated;
+	system_error_t lastSystemError;
+
+	Impl( ServerHandler & ) : interruptRequested( false ), deviceListUpdated( false ), lastSystemError( 0 ) {}
+
+	ServerStatus start( uint16_t, const string & )  { return ServerStatus::NotSupported; }
+	void stop() {}
+	bool isRunning() const  { return false; }
+	uint16_t port() const  { return 0; }
+	size_t clientCount() const  { return 0; }
+	ServerStatus processEvents( int )  { return ServerStatus::NotSupported; }
+	ServerStatus run()  { return ServerStatus::NotSupported; }
+	void wakeUp() {}
+};
+
+
+#endif // __linux__
+
+
+//======================================================================================================================
+//  Server
+
+Server::Server( ServerHandler & handler ) noexcept
+:
+	_impl( new Impl( handler ) )
+{}
+
+Server::~Server() noexcept
+{
+	stop();
+}
+
+ServerStatus Server::start( uint16_t port, const std::string & address ) noexcept
+{
+	try
+	{
+		return _impl->start( port, address );
+	}
+	CATCH_ALL (
+		_impl->stop();
+		return ServerStatus::UnexpectedError;
+	)
+}
+
+void Server::stop() noexcept
+{
+	try
+	{
+		_impl->stop();
+	}
+	CATCH_ALL()
+}
+
+bool Server::isRunning() const noexcept
+{
+	return _impl->isRunning();
+}
+
+uint16_t Server::port() const noexcept
+{
+	return _impl->port();
+}
+
+size_t Server::clientCount() const noexcept
+{
+	return _impl->clientCount();
+}
+
+ServerStatus Server::processEvents( std::chrono::milliseconds timeout ) noexcept
+{
+	try
+	{
+		return _impl->processEvents( int( timeout.count() ) );
+	}
+	CATCH_ALL (
+		return ServerStatus::UnexpectedError;
+	)
+}
+
+ServerStatus Server::run() noexcept
+{
+	try
+	{
+		return _impl->run();
+	}
+	CATCH_ALL (
+		return ServerStatus::UnexpectedError;
+	)
+}
+
+void Server::interrupt() noexcept
+{
+	_impl->interruptRequested = true;
+	_impl->wakeUp();
+}
+
+void Server::notifyDeviceListUpdated() noexcept
+{
+	_impl->deviceListUpdated = true;
+	_impl->wakeUp();
+}
+
+system_error_t Server::getLastSystemError() const noexcept
+{
+	return _impl->lastSystemError;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
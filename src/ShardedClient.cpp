@@ -0,0 +1,281 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: client spreading the devices over several connections to the same server
+//======================================================================================================================
+
+#include <OpenRGB/ShardedClient.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <OpenRGB/Effects.hpp>     // FrameBuffer
+#include <OpenRGB/ThreadPool.hpp>
+#include "MiscUtils.hpp"
+
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cstdio>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <algorithm>  // stable_sort, min_element
+#include <chrono>
+using std::chrono::milliseconds;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+//  enum to string conversion
+
+const char * enumString( ShardingStrategy strategy ) noexcept
+{
+	static const char * const ShardingStrategyStr [] =
+	{
+		"RoundRobin",
+		"ByLEDCount",
+	};
+	static_assert( size_t(ShardingStrategy::ByLEDCount) + 1 == fut::size(ShardingStrategyStr), "update the ShardingStrategyStr" );
+
+	if (size_t(strategy) < fut::size(ShardingStrategyStr))
+	{
+		return ShardingStrategyStr[ size_t(strategy) ];
+	}
+	else
+	{
+		return "<invalid strategy>";
+	}
+}
+
+
+//======================================================================================================================
+//  ShardedClient
+
+ShardedClient::ShardedClient( size_t shardCount, const std::string & clientName, ShardingStrategy strategy )
+:
+	_strategy( strategy )
+{
+	shardCount = std::max( shardCount, size_t(1) );
+	_shards.reserve( shardCount );
+	for (size_t i = 0; i < shardCount; ++i)
+	{
+		_shards.emplace_back( clientName );
+	}
+}
+
+ShardedClient::~ShardedClient() noexcept {}
+
+bool ShardedClient::isConnected() const noexcept
+{
+	for (const Client & shard : _shards)
+		if (!shard.isConnected())
+			return false;
+	return true;
+}
+
+ConnectStatus ShardedClient::connect( const std::string & host, uint16_t port ) noexcept
+{
+	for (Client & shard : _shards)
+	{
+		ConnectStatus status = shard.connect( host, port );
+		if (status != ConnectStatus::Success)
+		{
+			// don't leave the client half-connected
+			for (Client & other : _shards)
+				if (&other != &shard && other.isConnected())
+					other.disconnect();
+			return status;
+		}
+	}
+	return ConnectStatus::Success;
+}
+
+bool ShardedClient::disconnect() noexcept
+{
+	bool success = true;
+	for (Client & shard : _shards)
+		success &= shard.disconnect();
+	return success;
+}
+
+bool ShardedClient::setTimeout( std::chrono::milliseconds timeout ) noexcept
+{
+	bool success = true;
+	for (Client & shard : _shards)
+		success &= shard.setTimeout( timeout );
+	return success;
+}
+
+DeviceListResult ShardedClient::requestDeviceList() noexcept
+{
+	return requestDeviceList( RequestLimits() );
+}
+
+DeviceListResult ShardedClient::requestDeviceList( const RequestLimits & limits ) noexcept
+{
+	DeviceListResult result = _shards[0].requestDeviceList( limits );
+	if (result.status == RequestStatus::Success)
+	{
+		// the other connections have received the same notifications, but they don't request the list themselves
+		for (size_t shardIdx = 1; shardIdx < _shards.size(); ++shardIdx)
+			_shards[ shardIdx ]._isDeviceListOutOfDate = false;
+
+		try {
+			assignShards( result.devices );
+		} CATCH_ALL (
+			return { RequestStatus::UnexpectedError, DeviceList() };
+		)
+	}
+	return result;
+}
+
+DeviceInfoResult ShardedClient::requestDeviceInfo( uint32_t deviceIdx ) noexcept
+{
+	return _shards[ shardOf( deviceIdx ) ].requestDeviceInfo( deviceIdx );
+}
+
+DeviceInfoResult ShardedClient::requestDeviceInfo( uint32_t deviceIdx, const RequestLimits & limits ) noexcept
+{
+	return _shards[ shardOf( deviceIdx ) ].requestDeviceInfo( deviceIdx, limits );
+}
+
+UpdateStatus ShardedClient::checkForDeviceUpdates() noexcept
+{
+	bool outOfDate = false;
+	UpdateStatus error = UpdateStatus::UpToDate;
+	for (Client & shard : _shards)
+	{
+		UpdateStatus status = shard.checkForDeviceUpdates();
+		if (status == UpdateStatus::OutOfDate)
+			outOfDate = true;
+		else if (status != UpdateStatus::UpToDate && error == UpdateStatus::UpToDate)
+			error = status;
+	}
+	if (error != UpdateStatus::UpToDate)
+		return error;
+	return outOfDate ? UpdateStatus::OutOfDate : UpdateStatus::UpToDate;
+}
+
+void ShardedClient::assignShards( const DeviceList & devices )
+{
+	_deviceShards.resize( devices.size() );
+
+	if (_strategy == ShardingStrategy::RoundRobin)
+	{
+		for (uint32_t deviceIdx = 0; deviceIdx < devices.size(); ++deviceIdx)
+		{
+			_deviceShards[ deviceIdx ] = uint32_t( deviceIdx % _shards.size() );
+		}
+	}
+	else
+	{
+		// greedy balancing, the biggest devices first so that the small ones can fill the gaps
+		vector< uint32_t > order( devices.size() );
+		for (uint32_t deviceIdx = 0; deviceIdx < devices.size(); ++deviceIdx)
+			order[ deviceIdx ] = deviceIdx;
+		std::stable_sort( order.begin(), order.end(), [&devices]( uint32_t a, uint32_t b )
+		{
+			return devices[a].leds.size() > devices[b].leds.size();
+		});
+
+		vector< size_t > ledCounts( _shards.size(), 0 );
+		for (uint32_t deviceIdx : order)
+		{
+			auto leastLoaded = std::min_element( ledCounts.begin(), ledCounts.end() );
+			*leastLoaded += devices[ deviceIdx ].leds.size();
+			_deviceShards[ deviceIdx ] = uint32_t( leastLoaded - ledCounts.begin() );
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  requests routed to the connection of the device
+
+RequestStatus ShardedClient::switchToCustomMode( const Device & device ) noexcept
+{
+	return _shards[ shardOf( device.idx ) ].switchToCustomMode( device );
+}
+
+RequestStatus ShardedClient::changeMode( const Device & device, const Mode & mode ) noexcept
+{
+	return _shards[ shardOf( device.idx ) ].changeMode( device, mode );
+}
+
+RequestStatus ShardedClient::changeMode( const Device & device, const Mode & mode, const ModeParams & params ) noexcept
+{
+	return _shards[ shardOf( device.idx ) ].changeMode( device, mode, params );
+}
+
+RequestStatus ShardedClient::setDeviceColor( const Device & device, Color color ) noexcept
+{
+	return _shards[ shardOf( device.idx ) ].setDeviceColor( device, color );
+}
+
+RequestStatus ShardedClient::setZoneColor( const Zone & zone, Color color ) noexcept
+{
+	return _shards[ shardOf( zone.parentIdx ) ].setZoneColor( zone, color );
+}
+
+RequestStatus ShardedClient::setDeviceColors( const Device & device, Span< const Color > colors ) noexcept
+{
+	return _shards[ shardOf( device.idx ) ].setDeviceColors( device, colors );
+}
+
+RequestStatus ShardedClient::setZoneColors( const Zone & zone, Span< const Color > colors ) noexcept
+{
+	return _shards[ shardOf( zone.parentIdx ) ].setZoneColors( zone, colors );
+}
+
+RequestStatus ShardedClient::setZoneSize( const Zone & zone, uint32_t newSize ) noexcept
+{
+	return _shards[ shardOf( zone.parentIdx ) ].setZoneSize( zone, newSize );
+}
+
+RequestStatus ShardedClient::setLEDColor( const LED & led, Color color ) noexcept
+{
+	return _shards[ shardOf( led.parentIdx ) ].setLEDColor( led, color );
+}
+
+RequestStatus ShardedClient::setFrameColors( const DeviceList & devices, const FrameBuffer & frame, ThreadPool * pool ) noexcept
+{
+	// every connection is used by one thread only, so the connections don't need any locking
+	vector< RequestStatus > statuses( _shards.size(), RequestStatus::Success );
+	auto sendShard = [&]( size_t shardIdx )
+	{
+		for (const Device & device : devices)
+		{
+			if (shardOf( device.idx ) != shardIdx)
+				continue;
+			RequestStatus status = _shards[ shardIdx ].setDeviceColors( device, frame.deviceColors( device.idx ) );
+			if (status != RequestStatus::Success && statuses[ shardIdx ] == RequestStatus::Success)
+				statuses[ shardIdx ] = status;
+		}
+	};
+
+	try {
+		if (pool)
+		{
+			pool->parallelFor( _shards.size(), sendShard );
+		}
+		else
+		{
+			for (size_t shardIdx = 0; shardIdx < _shards.size(); ++shardIdx)
+				sendShard( shardIdx );
+		}
+	} CATCH_ALL (
+		return RequestStatus::UnexpectedError;
+	)
+
+	for (RequestStatus status : statuses)
+		if (status != RequestStatus::Success)
+			return status;
+	return RequestStatus::Success;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,490 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: binary snapshot of a device list that can be shared between processes via memory mapping
+//======================================================================================================================
+
+#include <OpenRGB/Snapshot.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include "MappedFile.hpp"
+
+#include <CppUtils-Essential/LangUtils.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <cstddef>  // offsetof
+#include <cstdint>  // uintptr_t
+#include <cerrno>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+
+namespace orgb {
+
+
+static const char snapshotMagic [8] = { 'O','R','G','B','S','N','A','P' };
+static const uint32_t byteOrderMark = 0x01020304;
+
+// The enums are stored as they are, so their values must be checked on opening just like the network messages are.
+static bool isValidDeviceType( DeviceType type )  { return size_t( type ) <= size_t( DeviceType::Unknown ); }
+static bool isValidDirection( Direction dir )     { return size_t( dir ) <= size_t( Direction::Vertical ); }
+static bool isValidColorMode( ColorMode mode )    { return size_t( mode ) <= size_t( ColorMode::Random ); }
+static bool isValidZoneType( ZoneType type )      { return size_t( type ) <= size_t( ZoneType::Matrix ); }
+
+
+//======================================================================================================================
+//  enum to string conversion
+
+const char * enumString( SnapshotStatus status ) noexcept
+{
+	static const char * const SnapshotStatusStr [] =
+	{
+		"The operation was successful.",
+		"The file could not be opened, created or mapped into memory.",
+		"The file could not be written or replaced.",
+		"The data are not a snapshot or they are damaged.",
+		"The snapshot was written by an incompatible version of this library or on a different architecture.",
+		"Internal error of this library. Please create a github issue.",
+	};
+	static_assert( size_t(SnapshotStatus::UnexpectedError) + 1 == fut::size(SnapshotStatusStr), "update the SnapshotStatusStr" );
+
+	if (size_t(status) < fut::size(SnapshotStatusStr))
+	{
+		return SnapshotStatusStr[ size_t(status) ];
+	}
+	else
+	{
+		return "<invalid status>";
+	}
+}
+
+
+//======================================================================================================================
+//  writing
+
+// Appends objects at the end of the buffer and links the self-relative references to them.
+// All positions are indexes into the buffer, because the buffer gets reallocated as it grows.
+class SnapshotWriter
+{
+	vector< uint8_t > & _buffer;
+
+ public:
+
+	SnapshotWriter( vector< uint8_t > & buffer ) : _buffer( buffer ) {}
+
+	size_t allocate( size_t size, size_t alignment )
+	{
+		size_t pos = (_buffer.size() + alignment - 1) & ~(alignment - 1);
+		_buffer.resize( pos + size );  // the gaps are zeroed, so the output is deterministic
+		return pos;
+	}
+
+	template< typename Type >
+	Type & at( size_t pos )
+	{
+		return *reinterpret_cast< Type * >( _buffer.data() + pos );
+	}
+
+	void writeString( size_t refPos, const string & str )
+	{
+		size_t strPos = allocate( str.size() + 1, 1 );
+		memcpy( _buffer.data() + strPos, str.c_str(), str.size() + 1 );
+
+		SnapshotString & ref = at< SnapshotString >( refPos );
+		ref.offset = int32_t( strPos - refPos );
+		ref.size = uint32_t( str.size() );
+	}
+
+	template< typename Elem >
+	size_t allocateArray( size_t refPos, size_t count )
+	{
+		size_t arrayPos = allocate( count * sizeof(Elem), alignof(Elem) );
+
+		SnapshotArray< Elem > & ref = at< SnapshotArray< Elem > >( refPos );
+		ref.offset = int32_t( arrayPos - refPos );
+		ref.count = uint32_t( count );
+
+		return arrayPos;
+	}
+
+	template< typename Elem >
+	void writeArray( size_t refPos, const vector< Elem > & vec )
+	{
+		size_t arrayPos = allocateArray< Elem >( refPos, vec.size() );
+		if (!vec.empty())
+			memcpy( _buffer.data() + arrayPos, vec.data(), vec.size() * sizeof(Elem) );
+	}
+};
+
+#define FIELD_POS( recordPos, Record, field ) ((recordPos) + offsetof( Record, field ))
+
+static void writeLEDs( SnapshotWriter & writer, size_t refPos, const vector< LED > & leds )
+{
+	size_t arrayPos = writer.allocateArray< SnapshotLED >( refPos, leds.size() );
+	for (size_t i = 0; i < leds.size(); ++i)
+	{
+		size_t recPos = arrayPos + i * sizeof(SnapshotLED);
+		writer.at< SnapshotLED >( recPos ).value = leds[i].value;
+		writer.writeString( FIELD_POS( recPos, SnapshotLED, name ), leds[i].name );
+	}
+}
+
+static void writeZones( SnapshotWriter & writer, size_t refPos, const vector< Zone > & zones )
+{
+	size_t arrayPos = writer.allocateArray< SnapshotZone >( refPos, zones.size() );
+	for (size_t i = 0; i < zones.size(); ++i)
+	{
+		const Zone & zone = zones[i];
+		size_t recPos = arrayPos + i * sizeof(SnapshotZone);
+		{
+			SnapshotZone & rec = writer.at< SnapshotZone >( recPos );
+			rec.type = zone.type;
+			rec.leds_min = zone.leds_min;
+			rec.leds_max = zone.leds_max;
+			rec.leds_count = zone.leds_count;
+			rec.matrix_height = zone.matrix_height;
+			rec.matrix_width = zone.matrix_width;
+		}
+		writer.writeString( FIELD_POS( recPos, SnapshotZone, name ), zone.name );
+		writer.writeArray( FIELD_POS( recPos, SnapshotZone, matrix_values ), zone.matrix_values );
+	}
+}
+
+static void writeModes( SnapshotWriter & writer, size_t refPos, const vector< Mode > & modes )
+{
+	size_t arrayPos = writer.allocateArray< SnapshotMode >( refPos, modes.size() );
+	for (size_t i = 0; i < modes.size(); ++i)
+	{
+		const Mode & mode = modes[i];
+		size_t recPos = arrayPos + i * sizeof(SnapshotMode);
+		{
+			SnapshotMode & rec = writer.at< SnapshotMode >( recPos );
+			rec.value = mode.value;
+			rec.flags = mode.flags;
+			rec.speed_min = mode.speed_min;
+			rec.speed_max = mode.speed_max;
+			rec.brightness_min = mode.brightness_min;
+			rec.brightness_max = mode.brightness_max;
+			rec.colors_min = mode.colors_min;
+			rec.colors_max = mode.colors_max;
+			rec.speed = mode.speed;
+			rec.brightness = mode.brightness;
+			// the server leaves the direction uninitialized when the mode has none
+			rec.direction = isValidDirection( mode.direction ) ? mode.direction : Direction::Left;
+			rec.color_mode = mode.color_mode;
+		}
+		writer.writeString( FIELD_POS( recPos, SnapshotMode, name ), mode.name );
+		writer.writeArray( FIELD_POS( recPos, SnapshotMode, colors ), mode.colors );
+	}
+}
+
+vector< uint8_t > makeSnapshot( const DeviceList & devices, uint64_t sequence )
+{
+	vector< uint8_t > buffer;
+	buffer.reserve( 4096 );
+	SnapshotWriter writer( buffer );
+
+	size_t headerPos = writer.allocate( sizeof(SnapshotHeader), alignof(SnapshotHeader) );
+	{
+		SnapshotHeader & header = writer.at< SnapshotHeader >( headerPos );
+		memcpy( header.magic, snapshotMagic, sizeof(header.magic) );
+		header.format_version = snapshotFormatVersion;
+		header.byte_order = byteOrderMark;
+		header.sequence = sequence;
+	}
+
+	size_t devicesPos = writer.allocateArray< SnapshotDevice >( FIELD_POS( headerPos, SnapshotHeader, devices ), devices.size() );
+	for (size_t i = 0; i < devices.size(); ++i)
+	{
+		const Device & device = devices[ uint32_t(i) ];
+		size_t recPos = devicesPos + i * sizeof(SnapshotDevice);
+		{
+			SnapshotDevice & rec = writer.at< SnapshotDevice >( recPos );
+			rec.idx = device.idx;
+			// device types added by newer servers are tolerated by the client, but they would not pass the validation
+			rec.type = isValidDeviceType( device.type ) ? device.type : DeviceType::Unknown;
+			rec.active_mode = device.active_mode;
+		}
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, name ), device.name );
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, vendor ), device.vendor );
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, description ), device.description );
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, version ), device.version );
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, serial ), device.serial );
+		writer.writeString( FIELD_POS( recPos, SnapshotDevice, location ), device.location );
+		writeModes( writer, FIELD_POS( recPos, SnapshotDevice, modes ), device.modes );
+		writeZones( writer, FIELD_POS( recPos, SnapshotDevice, zones ), device.zones );
+		writeLEDs( writer, FIELD_POS( recPos, SnapshotDevice, leds ), device.leds );
+		writer.writeArray( FIELD_POS( recPos, SnapshotDevice, colors ), device.colors );
+	}
+
+	// round the size up, so that snapshots can be concatenated or placed one after another in a shared memory
+	writer.allocate( 0, alignof(SnapshotHeader) );
+	writer.at< SnapshotHeader >( headerPos ).total_size = buffer.size();
+
+	return buffer;
+}
+
+#undef FIELD_POS
+
+SnapshotStatus saveSnapshot( const DeviceList & devices, const std::string & filePath, uint64_t sequence ) noexcept
+{
+	try
+	{
+		vector< uint8_t > snapshot = makeSnapshot( devices, sequence );
+
+		string tempPath = uniqueTempPath( filePath );
+		FILE * file = fopen( tempPath.c_str(), "wb" );
+		if (!file)
+		{
+			return SnapshotStatus::CannotOpenFile;
+		}
+
+		bool written = fwrite( snapshot.data(), 1, snapshot.size(), file ) == snapshot.size();
+		written &= fclose( file ) == 0;
+		if (!written)
+		{
+			remove( tempPath.c_str() );
+			return SnapshotStatus::CannotWriteFile;
+		}
+
+		if (!replaceFile( tempPath, filePath ))
+		{
+			return SnapshotStatus::CannotWriteFile;
+		}
+
+		return SnapshotStatus::Success;
+	}
+	catch (...)
+	{
+		return SnapshotStatus::UnexpectedError;
+	}
+}
+
+
+//======================================================================================================================
+//  validation
+//
+//  The snapshot may come from anywhere, so every reference is checked once on opening to point inside the snapshot
+//  and every enum to have a known value. After that the views can be used without any checks.
+
+class SnapshotValidator
+{
+	const uint8_t * _begin;
+	const uint8_t * _end;
+
+ public:
+
+	SnapshotValidator( const uint8_t * begin, size_t size ) : _begin( begin ), _end( begin + size ) {}
+
+	bool isInside( const void * ptr, size_t size, size_t alignment ) const
+	{
+		const uint8_t * bytePtr = static_cast< const uint8_t * >( ptr );
+		return bytePtr >= _begin && bytePtr <= _end && size <= size_t( _end - bytePtr )
+		    && (reinterpret_cast< uintptr_t >( bytePtr ) & (alignment - 1)) == 0;
+	}
+
+	bool check( const SnapshotString & ref ) const
+	{
+		const char * str = ref.c_str();
+		return isInside( str, size_t( ref.size ) + 1, 1 ) && str[ ref.size ] == '\0';
+	}
+
+	template< typename Elem >
+	bool check( const SnapshotArray< Elem > & ref ) const
+	{
+		const void * array = reinterpret_cast< const char * >( &ref ) + ref.offset;
+		return isInside( array, size_t( ref.count ) * sizeof(Elem), alignof(Elem) );
+	}
+
+	bool check( const SnapshotLED & led ) const
+	{
+		return check( led.name );
+	}
+
+	bool check( const SnapshotZone & zone ) const
+	{
+		return isValidZoneType( zone.type ) && check( zone.name ) && check( zone.matrix_values );
+	}
+
+	bool check( const SnapshotMode & mode ) const
+	{
+		return isValidDirection( mode.direction ) && isValidColorMode( mode.color_mode )
+		    && check( mode.name ) && check( mode.colors );
+	}
+
+	bool check( const SnapshotDevice & device ) const
+	{
+		if (!isValidDeviceType( device.type ))
+			return false;
+
+		if (!check( device.name ) || !check( device.vendor ) || !check( device.description )
+		 || !check( device.version ) || !check( device.serial ) || !check( device.location ))
+			return false;
+
+		if (!check( device.modes ) || !check( device.zones ) || !check( device.leds ) || !check( device.colors ))
+			return false;
+
+		for (const SnapshotMode & mode : device.getModes())
+			if (!check( mode ))
+				return false;
+		for (const SnapshotZone & zone : device.getZones())
+			if (!check( zone ))
+				return false;
+		for (const SnapshotLED & led : device.getLEDs())
+			if (!check( led ))
+				return false;
+
+		return true;
+	}
+};
+
+static SnapshotStatus validateSnapshot( const uint8_t * data, size_t size )
+{
+	if (size < sizeof(SnapshotHeader) || (reinterpret_cast< uintptr_t >( data ) & (alignof(SnapshotHeader) - 1)) != 0)
+	{
+		return SnapshotStatus::InvalidFormat;
+	}
+
+	const SnapshotHeader & header = *reinterpret_cast< const SnapshotHeader * >( data );
+	if (memcmp( header.magic, snapshotMagic, sizeof(header.magic) ) != 0)
+	{
+		return SnapshotStatus::InvalidFormat;
+	}
+	if (header.format_version != snapshotFormatVersion || header.byte_order != byteOrderMark)
+	{
+		return SnapshotStatus::VersionNotSupported;
+	}
+	if (header.total_size < sizeof(SnapshotHeader) || header.total_size > size)
+	{
+		return SnapshotStatus::InvalidFormat;
+	}
+
+	SnapshotValidator validator( data, size_t( header.total_size ) );
+	if (!validator.check( header.devices ))
+	{
+		return SnapshotStatus::InvalidFormat;
+	}
+	for (const SnapshotDevice & device : header.devices.view())
+	{
+		if (!validator.check( device ))
+		{
+			return SnapshotStatus::InvalidFormat;
+		}
+	}
+
+	return SnapshotStatus::Success;
+}
+
+
+//======================================================================================================================
+//  DeviceListSnapshot
+
+DeviceListSnapshot::DeviceListSnapshot() noexcept
+:
+	_file(),
+	_header( nullptr ),
+	_devices(),
+	_lastSystemError( 0 )
+{}
+
+DeviceListSnapshot::~DeviceListSnapshot() noexcept {}
+
+DeviceListSnapshot::DeviceListSnapshot( DeviceListSnapshot && other ) noexcept
+:
+	_file( move( other._file ) ),
+	_header( other._header ),
+	_devices( other._devices ),
+	_lastSystemError( other._lastSystemError )
+{
+	other._header = nullptr;
+	other._devices = {};
+}
+
+DeviceListSnapshot & DeviceListSnapshot::operator=( DeviceListSnapshot && other ) noexcept
+{
+	_file = move( other._file );
+	_header = other._header;
+	_devices = other._devices;
+	_lastSystemError = other._lastSystemError;
+	other._header = nullptr;
+	other._devices = {};
+	return *this;
+}
+
+SnapshotStatus DeviceListSnapshot::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	std::unique_ptr< MappedFile > file( new (std::nothrow) MappedFile );
+	if (!file)
+	{
+		return SnapshotStatus::UnexpectedError;
+	}
+
+	if (!file->open( filePath ))
+	{
+		_lastSystemError = file->getLastSystemError();
+		return SnapshotStatus::CannotOpenFile;
+	}
+
+	SnapshotStatus status = attach( file->data(), file->size() );
+	if (status == SnapshotStatus::Success)
+	{
+		_file = move( file );
+	}
+	return status;
+}
+
+SnapshotStatus DeviceListSnapshot::attach( const void * data, size_t size ) noexcept
+{
+	_header = nullptr;
+	_devices = {};
+	if (_file && _file->data() != data)
+	{
+		_file.reset();  // the user switched to his own memory
+	}
+
+	const uint8_t * bytes = static_cast< const uint8_t * >( data );
+	SnapshotStatus status = validateSnapshot( bytes, size );
+	if (status != SnapshotStatus::Success)
+	{
+		return status;
+	}
+
+	_header = reinterpret_cast< const SnapshotHeader * >( bytes );
+	_devices = _header->devices.view();
+	return SnapshotStatus::Success;
+}
+
+void DeviceListSnapshot::close() noexcept
+{
+	_header = nullptr;
+	_devices = {};
+	_file.reset();
+}
+
+const SnapshotDevice * DeviceListSnapshot::find( DeviceType deviceType ) const noexcept
+{
+	for (const SnapshotDevice & device : _devices)
+		if (device.type == deviceType)
+			return &device;
+	return nullptr;
+}
+
+const SnapshotDevice * DeviceListSnapshot::find( StringView deviceName ) const noexcept
+{
+	for (const SnapshotDevice & device : _devices)
+		if (device.getName() == deviceName)
+			return &device;
+	return nullptr;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
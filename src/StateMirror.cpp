@@ -0,0 +1,126 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: local copy of the device state written through a Client
+//======================================================================================================================
+
+#include "StateMirror.hpp"
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <algorithm>
+using std::min;
+using std::copy;
+using std::fill;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+void StateMirror::seed( const DeviceList & devices )
+{
+	_devices.clear();
+	for (const Device & device : devices)
+	{
+		seed( device );
+	}
+}
+
+void StateMirror::seed( const Device & device )
+{
+	if (device.idx >= _devices.size())
+		_devices.resize( device.idx + 1 );
+
+	DeviceEntry & entry = _devices[ device.idx ];
+	entry.seeded = true;
+	entry.activeMode = device.active_mode;
+	entry.colors = device.colors;
+	entry.zoneOffsets.clear();
+	entry.zoneSizes.clear();
+	for (const Zone & zone : device.zones)
+	{
+		entry.zoneOffsets.push_back( zone.start_idx );
+		entry.zoneSizes.push_back( zone.leds_count );
+	}
+}
+
+const StateMirror::DeviceEntry * StateMirror::find( uint32_t deviceIdx ) const noexcept
+{
+	if (deviceIdx >= _devices.size() || !_devices[ deviceIdx ].seeded)
+		return nullptr;
+	return &_devices[ deviceIdx ];
+}
+
+StateMirror::DeviceEntry * StateMirror::findMutable( uint32_t deviceIdx ) noexcept
+{
+	return const_cast< DeviceEntry * >( find( deviceIdx ) );
+}
+
+void StateMirror::zoneRange( const DeviceEntry & entry, uint32_t zoneIdx, size_t & offset, size_t & count ) const noexcept
+{
+	offset = 0;
+	count = 0;
+	if (zoneIdx >= entry.zoneOffsets.size() || entry.zoneOffsets[ zoneIdx ] >= entry.colors.size())
+		return;
+
+	offset = entry.zoneOffsets[ zoneIdx ];
+	count = min( size_t( entry.zoneSizes[ zoneIdx ] ), entry.colors.size() - offset );
+}
+
+void StateMirror::setActiveMode( uint32_t deviceIdx, uint32_t modeIdx ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+		entry->activeMode = modeIdx;
+}
+
+void StateMirror::setDeviceColor( uint32_t deviceIdx, Color color ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+		fill( entry->colors.begin(), entry->colors.end(), color );
+}
+
+void StateMirror::setDeviceColors( uint32_t deviceIdx, Span< const Color > colors ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+	{
+		// the server ignores the colors that don't fit the device
+		size_t count = min( colors.size(), entry->colors.size() );
+		copy( colors.begin(), colors.begin() + count, entry->colors.begin() );
+	}
+}
+
+void StateMirror::setZoneColor( uint32_t deviceIdx, uint32_t zoneIdx, Color color ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+	{
+		size_t offset, count;
+		zoneRange( *entry, zoneIdx, offset, count );
+		fill( entry->colors.begin() + offset, entry->colors.begin() + offset + count, color );
+	}
+}
+
+void StateMirror::setZoneColors( uint32_t deviceIdx, uint32_t zoneIdx, Span< const Color > colors ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+	{
+		size_t offset, count;
+		zoneRange( *entry, zoneIdx, offset, count );
+		count = min( count, colors.size() );
+		copy( colors.begin(), colors.begin() + count, entry->colors.begin() + offset );
+	}
+}
+
+void StateMirror::setLEDColor( uint32_t deviceIdx, uint32_t ledIdx, Color color ) noexcept
+{
+	if (DeviceEntry * entry = findMutable( deviceIdx ))
+		if (ledIdx < entry->colors.size())
+			entry->colors[ ledIdx ] = color;
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -0,0 +1,79 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: local copy of the device state written through a Client
+//======================================================================================================================
+
+#ifndef OPENRGB_STATE_MIRROR_INCLUDED
+#define OPENRGB_STATE_MIRROR_INCLUDED
+
+
+#include <OpenRGB/DeviceInfo.hpp>
+#include <OpenRGB/Color.hpp>
+#include <OpenRGB/Span.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// Colors and active modes of the devices as they were last sent by a Client.
+/** Seeded from the devices received from the server and then updated after every successful request.
+  * The updates of devices or LEDs that were not seeded are ignored. */
+class StateMirror
+{
+
+ public:
+
+	struct DeviceEntry
+	{
+		bool seeded = false;
+		uint32_t activeMode = 0;
+		std::vector< Color > colors;
+		std::vector< uint32_t > zoneOffsets;  ///< index of the first LED of each zone
+		std::vector< uint32_t > zoneSizes;
+	};
+
+	/// Replaces the whole mirror with the state of the devices.
+	void seed( const DeviceList & devices );
+
+	/// Replaces the state of a single device.
+	void seed( const Device & device );
+
+	void clear() noexcept  { _devices.clear(); }
+
+	/// Returns nullptr when the device has not been seeded.
+	const DeviceEntry * find( uint32_t deviceIdx ) const noexcept;
+
+	void setActiveMode( uint32_t deviceIdx, uint32_t modeIdx ) noexcept;
+	void setDeviceColor( uint32_t deviceIdx, Color color ) noexcept;
+	void setDeviceColors( uint32_t deviceIdx, Span< const Color > colors ) noexcept;
+	void setZoneColor( uint32_t deviceIdx, uint32_t zoneIdx, Color color ) noexcept;
+	void setZoneColors( uint32_t deviceIdx, uint32_t zoneIdx, Span< const Color > colors ) noexcept;
+	void setLEDColor( uint32_t deviceIdx, uint32_t ledIdx, Color color ) noexcept;
+
+ private:
+
+	DeviceEntry * findMutable( uint32_t deviceIdx ) noexcept;
+
+	/// Range of LEDs of a zone clamped to the LEDs of its device, count is 0 when the zone doesn't exist.
+	void zoneRange( const DeviceEntry & entry, uint32_t zoneIdx, size_t & offset, size_t & count ) const noexcept;
+
+	// indexed by the device index, the device indexes are dense
+	std::vector< DeviceEntry > _devices;
+
+};
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
+
+
+#endif // OPENRGB_STATE_MIRROR_INCLUDED
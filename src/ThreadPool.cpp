@@ -0,0 +1,207 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: small work-stealing thread pool for splitting the rendering of frames
+//======================================================================================================================
+
+#include <OpenRGB/ThreadPool.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include <CppUtils-Essential/LangUtils.hpp>
+using fut::make_unique;
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+using std::vector;
+using std::unique_ptr;
+
+
+namespace orgb {
+
+
+//======================================================================================================================
+
+/// Tasks waiting for one thread, the owner takes them from the front and thieves from the back.
+struct TaskQueue
+{
+	std::mutex mutex;
+	size_t begin = 0;
+	size_t end = 0;
+	char padding [64];  // keep the queues of different threads in different cache lines
+};
+
+struct ThreadPool::Impl
+{
+	vector< unique_ptr< TaskQueue > > queues;  ///< one per thread, index 0 belongs to the thread calling parallelFor
+	vector< std::thread > workers;
+
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+	uint64_t generation = 0;  ///< incremented for every parallelFor, so that the workers know there is new work
+	unsigned running = 0;     ///< workers that haven't finished the current parallelFor yet
+	bool stop = false;
+
+	TaskFunc func = nullptr;
+	void * context = nullptr;
+
+	bool takeTask( unsigned self, size_t & taskIdx ) noexcept;
+	bool steal( unsigned self ) noexcept;
+	void work( unsigned self ) noexcept;
+	void workerLoop( unsigned self ) noexcept;
+};
+
+bool ThreadPool::Impl::takeTask( unsigned self, size_t & taskIdx ) noexcept
+{
+	TaskQueue & queue = *queues[ self ];
+	std::lock_guard< std::mutex > lock( queue.mutex );
+	if (queue.begin >= queue.end)
+		return false;
+	taskIdx = queue.begin++;
+	return true;
+}
+
+bool ThreadPool::Impl::steal( unsigned self ) noexcept
+{
+	unsigned threadCount = unsigned( queues.size() );
+	for (unsigned i = 1; i < threadCount; ++i)
+	{
+		TaskQueue & victim = *queues[ (self + i) % threadCount ];
+
+		size_t stolenBegin, stolenEnd;
+		{
+			std::lock_guard< std::mutex > lock( victim.mutex );
+			if (victim.begin >= victim.end)
+				continue;
+			size_t remaining = victim.end - victim.begin;
+			stolenEnd = victim.end;
+			stolenBegin = stolenEnd - (remaining + 1) / 2;
+			victim.end = stolenBegin;
+		}
+
+		// only one queue is locked at a time, so two threads stealing from each other can't deadlock
+		TaskQueue & own = *queues[ self ];
+		std::lock_guard< std::mutex > lock( own.mutex );
+		own.begin = stolenBegin;
+		own.end = stolenEnd;
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::Impl::work( unsigned self ) noexcept
+{
+	size_t taskIdx;
+	while (true)
+	{
+		if (takeTask( self, taskIdx ))
+			func( context, taskIdx );
+		else if (!steal( self ))
+			return;  // nothing is waiting anymore, the rest is being executed by other threads
+	}
+}
+
+void ThreadPool::Impl::workerLoop( unsigned self ) noexcept
+{
+	std::unique_lock< std::mutex > lock( mutex );
+	// not the current generation, the first parallelFor may have started before this thread got here
+	uint64_t seenGeneration = 0;
+	while (true)
+	{
+		wakeUp.wait( lock, [&]() { return stop || generation != seenGeneration; } );
+		if (stop)
+			return;
+		seenGeneration = generation;
+
+		lock.unlock();
+		work( self );
+		lock.lock();
+
+		if (--running == 0)
+			finished.notify_one();
+	}
+}
+
+
+//======================================================================================================================
+
+ThreadPool::ThreadPool( unsigned threadCount )
+:
+	_impl( new Impl )
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0)  // the number couldn't be determined
+		threadCount = 1;
+
+	for (unsigned i = 0; i < threadCount; ++i)
+		_impl->queues.push_back( make_unique< TaskQueue >() );
+
+	// the calling thread is the first one, so start one less
+	for (unsigned i = 1; i < threadCount; ++i)
+		_impl->workers.emplace_back( &Impl::workerLoop, _impl.get(), i );
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+	{
+		std::lock_guard< std::mutex > lock( _impl->mutex );
+		_impl->stop = true;
+	}
+	_impl->wakeUp.notify_all();
+
+	for (std::thread & worker : _impl->workers)
+		worker.join();
+}
+
+unsigned ThreadPool::threadCount() const noexcept
+{
+	return unsigned( _impl->queues.size() );
+}
+
+void ThreadPool::run( size_t taskCount, TaskFunc func, void * context )
+{
+	if (taskCount == 0)
+		return;
+
+	if (_impl->workers.empty())
+	{
+		for (size_t i = 0; i < taskCount; ++i)
+			func( context, i );
+		return;
+	}
+
+	// split the tasks evenly, the stealing will balance it when some tasks are slower
+	size_t threadCount = _impl->queues.size();
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		TaskQueue & queue = *_impl->queues[i];
+		std::lock_guard< std::mutex > lock( queue.mutex );
+		queue.begin = taskCount * i / threadCount;
+		queue.end = taskCount * (i + 1) / threadCount;
+	}
+
+	{
+		std::lock_guard< std::mutex > lock( _impl->mutex );
+		_impl->func = func;
+		_impl->context = context;
+		_impl->running = unsigned( _impl->workers.size() );
+		_impl->generation++;
+	}
+	_impl->wakeUp.notify_all();
+
+	_impl->work( 0 );
+
+	// the tasks may still be running on the other threads
+	std::unique_lock< std::mutex > lock( _impl->mutex );
+	_impl->finished.wait( lock, [&]() { return _impl->running == 0; } );
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
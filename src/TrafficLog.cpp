@@ -0,0 +1,200 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: recording of the raw protocol traffic of a Client into a log file and reading it back
+//======================================================================================================================
+
+#include <OpenRGB/TrafficLog.hpp>
+#include <CppUtils-Essential/Essential.hpp>
+
+#include "MappedFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>  // uintptr_t
+#include <algorithm>  // min
+using namespace std::chrono;
+
+
+namespace orgb {
+
+
+static const char trafficLogMagic [8] = { 'O','R','G','B','T','R','A','F' };
+static const uint32_t byteOrderMark = 0x01020304;
+
+static const size_t recordAlignment = 8;
+
+static size_t paddingOf( size_t size )
+{
+	return (recordAlignment - size % recordAlignment) % recordAlignment;
+}
+
+
+//======================================================================================================================
+//  TrafficRecorder
+
+TrafficRecorder::TrafficRecorder() noexcept
+:
+	_file( nullptr ),
+	_start(),
+	_recordCount( 0 ),
+	_lastSystemError( 0 )
+{}
+
+TrafficRecorder::~TrafficRecorder() noexcept
+{
+	close();
+}
+
+bool TrafficRecorder::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	_file = fopen( filePath.c_str(), "wb" );
+	if (!_file)
+	{
+		_lastSystemError = system_error_t( errno );
+		return false;
+	}
+
+	TrafficLogHeader header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, trafficLogMagic, sizeof(header.magic) );
+	header.format_version = trafficLogFormatVersion;
+	header.byte_order = byteOrderMark;
+	if (fwrite( &header, 1, sizeof(header), _file ) != sizeof(header))
+	{
+		_lastSystemError = system_error_t( errno );
+		close();
+		return false;
+	}
+
+	_start = steady_clock::now();
+	_recordCount = 0;
+	return true;
+}
+
+void TrafficRecorder::close() noexcept
+{
+	if (_file)
+	{
+		fclose( _file );
+		_file = nullptr;
+	}
+}
+
+void TrafficRecorder::record( TrafficDirection direction, Span< const uint8_t > part1, Span< const uint8_t > part2 ) noexcept
+{
+	if (!_file)
+		return;
+
+	TrafficRecordHeader header;
+	memset( &header, 0, sizeof(header) );
+	header.timestamp_us = uint64_t( duration_cast< microseconds >( steady_clock::now() - _start ).count() );
+	header.size = uint32_t( part1.size() + part2.size() );
+	header.direction = direction;
+
+	static const uint8_t padding [recordAlignment] = {};
+	size_t paddingSize = paddingOf( header.size );
+
+	bool written = fwrite( &header, 1, sizeof(header), _file ) == sizeof(header);
+	written = written && (part1.empty() || fwrite( part1.data(), 1, part1.size(), _file ) == part1.size());
+	written = written && (part2.empty() || fwrite( part2.data(), 1, part2.size(), _file ) == part2.size());
+	written = written && (paddingSize == 0 || fwrite( padding, 1, paddingSize, _file ) == paddingSize);
+	if (!written)
+	{
+		// a broken log must not break the client, just stop recording
+		_lastSystemError = system_error_t( errno );
+		close();
+		return;
+	}
+
+	_recordCount++;
+}
+
+
+//======================================================================================================================
+//  TrafficLogReader
+
+TrafficLogReader::TrafficLogReader() noexcept
+:
+	_file(),
+	_position( 0 ),
+	_lastSystemError( 0 )
+{}
+
+TrafficLogReader::~TrafficLogReader() noexcept {}
+
+bool TrafficLogReader::open( const std::string & filePath ) noexcept
+{
+	close();
+
+	std::unique_ptr< MappedFile > file( new (std::nothrow) MappedFile );
+	if (!file)
+	{
+		return false;
+	}
+
+	if (!file->open( filePath ))
+	{
+		_lastSystemError = file->getLastSystemError();
+		return false;
+	}
+
+	if (file->size() < sizeof(TrafficLogHeader) || (reinterpret_cast< uintptr_t >( file->data() ) & (alignof(TrafficRecordHeader) - 1)) != 0)
+	{
+		return false;
+	}
+	const TrafficLogHeader & header = *reinterpret_cast< const TrafficLogHeader * >( file->data() );
+	if (memcmp( header.magic, trafficLogMagic, sizeof(header.magic) ) != 0
+	 || header.format_version != trafficLogFormatVersion || header.byte_order != byteOrderMark)
+	{
+		return false;
+	}
+
+	_file = std::move( file );
+	_position = sizeof(TrafficLogHeader);
+	return true;
+}
+
+void TrafficLogReader::close() noexcept
+{
+	_file.reset();
+	_position = 0;
+}
+
+bool TrafficLogReader::next( Record & record ) noexcept
+{
+	if (!_file)
+		return false;
+
+	size_t fileSize = _file->size();
+	if (fileSize - _position < sizeof(TrafficRecordHeader))
+		return false;
+
+	const TrafficRecordHeader & header = *reinterpret_cast< const TrafficRecordHeader * >( _file->data() + _position );
+	size_t dataPos = _position + sizeof(TrafficRecordHeader);
+	if (header.size > fileSize - dataPos)
+		return false;
+
+	record.time = microseconds( header.timestamp_us );
+	record.direction = header.direction;
+	record.data = Span< const uint8_t >( _file->data() + dataPos, header.size );
+
+	_position = std::min( dataPos + header.size + paddingOf( header.size ), fileSize );
+	return true;
+}
+
+void TrafficLogReader::rewind() noexcept
+{
+	if (_file)
+		_position = sizeof(TrafficLogHeader);
+}
+
+
+//======================================================================================================================
+
+
+} // namespace orgb
@@ -1,17 +1,44 @@
 #include <CppUtils-Essential/Essential.hpp>
 
 #include <OpenRGB/Client.hpp>
+#include <OpenRGB/ColorConversion.hpp>
+#include <OpenRGB/Animation.hpp>
+#include <OpenRGB/Layout.hpp>
+#include <OpenRGB/Server.hpp>
+#include <OpenRGB/Snapshot.hpp>
+#include <OpenRGB/ThreadPool.hpp>
+#include <OpenRGB/TrafficLog.hpp>
+#include "../ProtocolMessages.hpp"  // the self test builds the devices and compares the messages byte by byte
 using namespace orgb;
 
 #include <CppUtils-Essential/StringUtils.hpp>
 #include <CppUtils-Essential/StreamUtils.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 using namespace std;
 
+#ifdef __linux__
+	#include <arpa/inet.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
+	#include <sys/time.h>
+	#include <unistd.h>
+#endif
+
 
 //======================================================================================================================
 
@@ -218,6 +245,303 @@ const Mode * findMode( const Device & device, const PartID & modeID )
 	return mode;
 }
 
+// exact floating point conversion from hue, chroma and the darkest channel, the reference for the fixed-point ones
+static Color referenceHueToRgb( uint16_t hue, double chroma, double minC )
+{
+	double sector = hue * 6.0 / 65536.0;
+	double x = chroma * (1.0 - fabs( fmod( sector, 2.0 ) - 1.0 ));
+	double r = 0.0, g = 0.0, b = 0.0;
+	switch (int( sector ))
+	{
+		case 0:  r = chroma; g = x;      break;
+		case 1:  r = x;      g = chroma; break;
+		case 2:  g = chroma; b = x;      break;
+		case 3:  g = x;      b = chroma; break;
+		case 4:  r = x;      b = chroma; break;
+		default: r = chroma; b = x;      break;
+	}
+	return Color( uint8_t( lround( (r + minC) * 255.0 ) ), uint8_t( lround( (g + minC) * 255.0 ) ), uint8_t( lround( (b + minC) * 255.0 ) ) );
+}
+
+static Color referenceHsvToRgb( HSV hsv )
+{
+	double s = hsv.s / 255.0, v = hsv.v / 255.0;
+	return referenceHueToRgb( hsv.h, v * s, v - v * s );
+}
+
+static Color referenceHslToRgb( HSL hsl )
+{
+	double s = hsl.s / 255.0, l = hsl.l / 255.0;
+	double chroma = (1.0 - fabs( 2.0 * l - 1.0 )) * s;
+	return referenceHueToRgb( hsl.h, chroma, l - chroma / 2.0 );
+}
+
+static int maxChannelDiff( Color a, Color b )
+{
+	return max( { abs( a.r - b.r ), abs( a.g - b.g ), abs( a.b - b.b ) } );
+}
+
+
+//======================================================================================================================
+//  helpers of the self test
+
+/// Prints why a check failed, returns the condition so that the checks can be chained with &&.
+static bool expect( bool condition, const char * failure )
+{
+	if (!condition)
+		cout << " -> failed: " << failure << endl;
+	return condition;
+}
+
+static bool reportResult( bool success )
+{
+	if (success)
+		cout << " -> success" << endl;
+	return success;
+}
+
+static bool sameColor( Color a, Color b )
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static bool sameColors( Span< const Color > a, Span< const Color > b )
+{
+	return a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin(), sameColor );
+}
+
+static vector< uint8_t > readFile( const string & filePath )
+{
+	std::ifstream file( filePath, std::ios::binary );
+	return vector< uint8_t >( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+}
+
+static bool writeFile( const string & filePath, const uint8_t * data, size_t size )
+{
+	std::ofstream file( filePath, std::ios::binary | std::ios::trunc );
+	file.write( reinterpret_cast< const char * >( data ), std::streamsize( size ) );
+	return bool( file );
+}
+
+/// Writes the numbers and strings the way they are sent in the OpenRGB protocol, independently of the library.
+struct ProtocolWriter
+{
+	vector< uint8_t > bytes;
+
+	ProtocolWriter & u16( uint16_t value )
+	{
+		bytes.push_back( uint8_t( value ) );
+		bytes.push_back( uint8_t( value >> 8 ) );
+		return *this;
+	}
+	ProtocolWriter & u32( uint32_t value )
+	{
+		for (unsigned i = 0; i < 4; ++i)
+			bytes.push_back( uint8_t( value >> (8 * i) ) );
+		return *this;
+	}
+	ProtocolWriter & str( const string & s )  // the strings inside devices have a length
+	{
+		u16( uint16_t( s.size() + 1 ) );
+		return str0( s );
+	}
+	ProtocolWriter & str0( const string & s )  // the strings directly in a message don't
+	{
+		bytes.insert( bytes.end(), s.begin(), s.end() );
+		bytes.push_back( 0 );
+		return *this;
+	}
+	ProtocolWriter & color( Color c )
+	{
+		bytes.insert( bytes.end(), { c.r, c.g, c.b, 0 } );
+		return *this;
+	}
+	ProtocolWriter & header( uint32_t deviceIdx, MessageType messageType, uint32_t messageSize )
+	{
+		bytes.insert( bytes.end(), { 'O', 'R', 'G', 'B' } );
+		return u32( deviceIdx ).u32( uint32_t( messageType ) ).u32( messageSize );
+	}
+};
+
+template< typename Message >
+static vector< uint8_t > serializeToBytes( const Message & message, uint32_t protocolVersion )
+{
+	vector< uint8_t > bytes( message.header.size() + message.header.message_size );
+	protocol::serializeMessage( message, bytes.data(), bytes.size(), protocolVersion );
+	return bytes;
+}
+
+/// Serializes a message generated from a field list through the output stream, instead of the direct stores.
+template< typename Message >
+static vector< uint8_t > streamToBytes( const Message & message, uint32_t protocolVersion )
+{
+	vector< uint8_t > bytes( message.header.size() + message.header.message_size );
+	own::BinaryOutputStream stream( own::span< uint8_t >( bytes.data(), bytes.size() ) );
+	message.serialize( stream, protocolVersion );
+	return bytes;
+}
+
+/// Devices can only be received, so the self test parses the bytes a server would send about them.
+static unique_ptr< ReplyControllerData > makeTestDevice( uint32_t deviceIdx, DeviceType type, const string & name,
+                                                           const vector< uint32_t > & zoneSizes, bool lastZoneIsMatrix )
+{
+	uint32_t ledCount = 0;
+	for (uint32_t zoneSize : zoneSizes)
+		ledCount += zoneSize;
+
+	ProtocolWriter body;
+	body.u32( 0 );  // data_size, not used when parsing
+	body.u32( uint32_t( type ) ).str( name ).str( "OpenRGB-cppSDK" ).str( "self test device" ).str( "1.0" ).str( "" ).str( "nowhere" );
+	body.u16( 1 ).u32( 0 );  // modes, active mode
+	body.str( "Direct" ).u32( 0 ).u32( HasPerLedColor ).u32( 0 ).u32( 0 ).u32( 0 ).u32( 0 ).u32( 0 ).u32( 0 )
+	    .u32( 0 ).u32( 0 ).u32( uint32_t( Direction::Left ) ).u32( uint32_t( ColorMode::PerLed ) ).u16( 0 );
+	body.u16( uint16_t( zoneSizes.size() ) );
+	for (size_t zoneIdx = 0; zoneIdx < zoneSizes.size(); ++zoneIdx)
+	{
+		uint32_t zoneSize = zoneSizes[ zoneIdx ];
+		bool isMatrix = lastZoneIsMatrix && zoneIdx == zoneSizes.size() - 1;
+		body.str( "Zone " + std::to_string( zoneIdx ) ).u32( uint32_t( isMatrix ? ZoneType::Matrix : ZoneType::Linear ) );
+		body.u32( zoneSize ).u32( zoneSize ).u32( zoneSize );
+		if (isMatrix)  // 2 columns, the last cell is empty when the size is odd
+		{
+			uint32_t height = (zoneSize + 1) / 2;
+			body.u16( uint16_t( 8 + height * 2 * 4 ) ).u32( height ).u32( 2 );
+			for (uint32_t cell = 0; cell < height * 2; ++cell)
+				body.u32( cell < zoneSize ? cell : 0xFFFFFFFF );
+		}
+		else
+		{
+			body.u16( 0 );
+		}
+	}
+	body.u16( uint16_t( ledCount ) );
+	for (uint32_t ledIdx = 0; ledIdx < ledCount; ++ledIdx)
+		body.str( "LED " + std::to_string( ledIdx ) ).u32( ledIdx );
+	body.u16( uint16_t( ledCount ) );
+	for (uint32_t ledIdx = 0; ledIdx < ledCount; ++ledIdx)
+		body.color( Color( uint8_t( ledIdx ), 0, 0 ) );
+
+	unique_ptr< ReplyControllerData > device( new ReplyControllerData );
+	device->header = Header( MessageType::REQUEST_CONTROLLER_DATA, deviceIdx, uint32_t( body.bytes.size() ) );
+	own::BinaryInputStream stream( own::span< const uint8_t >( body.bytes.data(), body.bytes.size() ) );
+	if (!device->deserializeBody( stream, implementedProtocolVersion ))
+		return nullptr;
+	return device;
+}
+
+/// Server of this library exposing the test devices.
+struct TestServerHandler : public ServerHandler
+{
+	vector< unique_ptr< ReplyControllerData > > devices;
+
+	std::mutex mutex;  ///< the following are written by the server thread
+	uint32_t updatedDevice = uint32_t( -1 );
+	vector< Color > updatedColors;
+
+	uint32_t deviceCount() override
+	{
+		return uint32_t( devices.size() );
+	}
+	const Device * device( uint32_t deviceIdx ) override
+	{
+		return deviceIdx < devices.size() ? &devices[ deviceIdx ]->device_desc : nullptr;
+	}
+	void updateLEDs( const ServerClientInfo &, uint32_t deviceIdx, Span< const Color > colors ) override
+	{
+		std::lock_guard< std::mutex > lock( mutex );
+		updatedDevice = deviceIdx;
+		updatedColors.assign( colors.begin(), colors.end() );
+	}
+	vector< string > profileList( const ServerClientInfo & ) override
+	{
+		// slower than the deadline of the request in checkServer(...), so that the reply arrives late
+		std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+		return { "Test profile" };
+	}
+};
+
+#ifdef __linux__
+
+/// Sockets that send what a Client or a Server of this library would never send.
+static int listenOnLoopback( uint16_t & port )
+{
+	int fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+	sockaddr_in addr;
+	memset( &addr, 0, sizeof(addr) );
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	socklen_t addrLen = sizeof(addr);
+	if (fd < 0
+	 || ::bind( fd, reinterpret_cast< sockaddr * >( &addr ), sizeof(addr) ) != 0
+	 || ::listen( fd, 1 ) != 0
+	 || ::getsockname( fd, reinterpret_cast< sockaddr * >( &addr ), &addrLen ) != 0)
+	{
+		if (fd >= 0)
+			::close( fd );
+		return -1;
+	}
+	port = ntohs( addr.sin_port );
+	return fd;
+}
+
+static int connectToLoopback( uint16_t port )
+{
+	int fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+	sockaddr_in addr;
+	memset( &addr, 0, sizeof(addr) );
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons( port );
+	addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	if (fd >= 0 && ::connect( fd, reinterpret_cast< sockaddr * >( &addr ), sizeof(addr) ) != 0)
+	{
+		::close( fd );
+		return -1;
+	}
+	return fd;
+}
+
+/// Nothing in the self test should take long, a timeout means the other side is stuck.
+static void setReceiveTimeout( int fd )
+{
+	timeval timeout = { 1, 0 };
+	setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+}
+
+static bool sendAll( int fd, const vector< uint8_t > & bytes )
+{
+	return ::send( fd, bytes.data(), bytes.size(), MSG_NOSIGNAL ) == ssize_t( bytes.size() );
+}
+
+/// Returns the number of bytes received before the connection was closed or the timeout expired.
+static size_t receiveAll( int fd, uint8_t * data, size_t size )
+{
+	size_t received = 0;
+	while (received < size)
+	{
+		ssize_t chunk = ::recv( fd, data + received, size - received, 0 );
+		if (chunk <= 0)
+			break;
+		received += size_t( chunk );
+	}
+	return received;
+}
+
+/// Receives a whole message and returns its type, or -1 when it can't be received.
+static int64_t receiveMessage( int fd )
+{
+	uint8_t header [16];
+	if (receiveAll( fd, header, sizeof(header) ) != sizeof(header) || memcmp( header, "ORGB", 4 ) != 0)
+		return -1;
+	uint32_t messageType = uint32_t( header[8] | header[9] << 8 | header[10] << 16 | uint32_t( header[11] ) << 24 );
+	uint32_t messageSize = uint32_t( header[12] | header[13] << 8 | header[14] << 16 | uint32_t( header[15] ) << 24 );
+	vector< uint8_t > body( messageSize );
+	if (receiveAll( fd, body.data(), body.size() ) != body.size())
+		return -1;
+	return messageType;
+}
+
+#endif // __linux__
+
 
 //======================================================================================================================
 //  commands
@@ -244,6 +568,8 @@ static bool help( const ArgList & )
 	cout << "  saveprofile                                  # orgb::Client::saveProfile\n";
 	cout << "  loadprofile                                  # orgb::Client::loadProfile\n";
 	cout << "  delprofile                                   # orgb::Client::deleteProfile\n";
+	cout << "  checkconv                                    # compares orgb::hsvToRgb and orgb::hslToRgb of arrays with single colors\n";
+	cout << "  selftest                                     # checks the parsers, decoders and the server without any OpenRGB\n";
 	cout << '\n';
 	cout.flush();
 
@@ -659,6 +985,599 @@ static bool delprofile( const ArgList & args )
 	}
 }
 
+static bool checkconv( const ArgList & )
+{
+	cout << "Checking the " << colorConversionsImplementation() << " conversions of arrays against the single color ones." << endl;
+
+	// odd count, so that also the remainders not filling a whole vector register are processed
+	const size_t count = 256 * 3 + 7;
+	vector< HSV > hsv( count );
+	vector< HSL > hsl( count );
+	vector< Color > hsvColors( count );
+	vector< Color > hslColors( count );
+	size_t simdMismatches = 0;
+	size_t referenceMismatches = 0;
+
+	for (uint32_t hue = 0; hue < 65536; hue += 97)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			uint8_t saturation = uint8_t( i * 7 );
+			uint8_t brightness = uint8_t( i / 3 );
+			hsv[i] = HSV( uint16_t( hue + i ), saturation, brightness );
+			hsl[i] = HSL( uint16_t( hue + i ), saturation, brightness );
+		}
+
+		hsvToRgb( hsv, hsvColors );
+		hslToRgb( hsl, hslColors );
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			Color hsvColor = hsvToRgb( hsv[i] );
+			Color hslColor = hslToRgb( hsl[i] );
+			if (maxChannelDiff( hsvColors[i], hsvColor ) != 0 || maxChannelDiff( hslColors[i], hslColor ) != 0)
+				++simdMismatches;
+			if (maxChannelDiff( hsvColor, referenceHsvToRgb( hsv[i] ) ) > 1
+			 || maxChannelDiff( hslColor, referenceHslToRgb( hsl[i] ) ) > 1)
+				++referenceMismatches;
+		}
+	}
+
+	if (simdMismatches == 0 && referenceMismatches == 0)
+	{
+		cout << " -> success" << endl;
+		return true;
+	}
+	else
+	{
+		cout << " -> failed: " << simdMismatches << " colors differ from the single color conversions, "
+		     << referenceMismatches << " colors differ from the floating point reference by more than 1" << endl;
+		return false;
+	}
+}
+
+static bool checkColorNames()
+{
+	cout << "Checking the parsing of colors." << endl;
+
+	struct { const char * str; bool valid; Color color; } cases [] =
+	{
+		{ "#FF8000",         true,  Color( 255, 128, 0 ) },
+		{ "ab34EF",          true,  Color( 0xAB, 0x34, 0xEF ) },
+		{ "Red",             true,  Color( 255, 0, 0 ) },
+		{ "green",           true,  Color( 0, 255, 0 ) },
+		{ "CORNFLOWERBLUE",  true,  Color( 100, 149, 237 ) },
+		{ "",                false, Color() },
+		{ "#",               false, Color() },
+		{ "#12345",          false, Color() },
+		{ "#1234567",        false, Color() },
+		{ "12345G",          false, Color() },
+		{ "redd",            false, Color() },
+		{ "notacolor",       false, Color() },
+	};
+
+	bool success = true;
+	for (const auto & testCase : cases)
+	{
+		Color color( 1, 2, 3 );
+		bool parsed = color.fromString( testCase.str );
+		if (parsed != testCase.valid || (parsed && !sameColor( color, testCase.color )))
+		{
+			cout << " -> failed: \"" << testCase.str << "\" was ";
+			if (parsed)
+				cout << "parsed as " << color << endl;
+			else
+				cout << "refused" << endl;
+			success = false;
+		}
+	}
+	return reportResult( success );
+}
+
+static bool checkThreadPool()
+{
+	cout << "Checking that the thread pool calls every task exactly once." << endl;
+
+	ThreadPool pool( 4 );
+	static const size_t taskCounts [] = { 0, 1, 3, 4, 1000, 10007 };
+	size_t wrongCalls = 0;
+	for (unsigned round = 0; round < 20; ++round)
+	{
+		for (size_t taskCount : taskCounts)
+		{
+			vector< uint32_t > calls( taskCount, 0 );
+			pool.parallelFor( taskCount, [ &calls ]( size_t idx )
+			{
+				// a few slow tasks make the threads steal from each other
+				if (idx % 997 == 0)
+					std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+				calls[ idx ]++;
+			});
+			wrongCalls += size_t( std::count_if( calls.begin(), calls.end(), []( uint32_t count ) { return count != 1; } ) );
+		}
+	}
+
+	return reportResult( expect( wrongCalls == 0, "some tasks were skipped or called more times" ) );
+}
+
+static bool checkCodecs()
+{
+	cout << "Checking the serialization of messages against the protocol description." << endl;
+
+	// the generated codecs, both through the stream and through the direct stores
+	ResizeZone resizeZone( 1, 2, 300 );
+	UpdateSingleLED updateSingleLED( 3, 4, Color( 10, 20, 30 ) );
+	SetClientName setClientName( "self test" );
+	RequestControllerData requestControllerData( 5, 3 );
+	ReplyControllerCount replyControllerCount( 7 );
+
+	vector< uint8_t > resizeZoneBytes = ProtocolWriter().header( 1, MessageType::RGBCONTROLLER_RESIZEZONE, 8 ).u32( 2 ).u32( 300 ).bytes;
+	vector< uint8_t > updateSingleLEDBytes = ProtocolWriter().header( 3, MessageType::RGBCONTROLLER_UPDATESINGLELED, 8 ).u32( 4 ).color( Color( 10, 20, 30 ) ).bytes;
+	vector< uint8_t > setClientNameBytes = ProtocolWriter().header( 0, MessageType::SET_CLIENT_NAME, 10 ).str0( "self test" ).bytes;
+	vector< uint8_t > requestControllerDataBytes = ProtocolWriter().header( 5, MessageType::REQUEST_CONTROLLER_DATA, 4 ).u32( 3 ).bytes;
+	vector< uint8_t > replyControllerCountBytes = ProtocolWriter().header( 0, MessageType::REQUEST_CONTROLLER_COUNT, 4 ).u32( 7 ).bytes;
+
+	bool codecsMatch =
+		   expect( serializeToBytes( resizeZone, 3 ) == resizeZoneBytes && streamToBytes( resizeZone, 3 ) == resizeZoneBytes, "ResizeZone" )
+		&& expect( serializeToBytes( updateSingleLED, 3 ) == updateSingleLEDBytes && streamToBytes( updateSingleLED, 3 ) == updateSingleLEDBytes, "UpdateSingleLED" )
+		&& expect( serializeToBytes( setClientName, 3 ) == setClientNameBytes && streamToBytes( setClientName, 3 ) == setClientNameBytes, "SetClientName" )
+		&& expect( serializeToBytes( requestControllerData, 3 ) == requestControllerDataBytes && streamToBytes( requestControllerData, 3 ) == requestControllerDataBytes, "RequestControllerData" )
+		&& expect( serializeToBytes( replyControllerCount, 3 ) == replyControllerCountBytes && streamToBytes( replyControllerCount, 3 ) == replyControllerCountBytes, "ReplyControllerCount" );
+
+	// the hand-written color messages, with the array of colors and with the repeated color
+	vector< Color > colors = { Color( 1, 2, 3 ), Color( 4, 5, 6 ), Color( 7, 8, 9 ) };
+	vector< uint8_t > updateLEDsBytes = ProtocolWriter().header( 1, MessageType::RGBCONTROLLER_UPDATELEDS, 18 ).u32( 18 ).u16( 3 )
+		.color( colors[0] ).color( colors[1] ).color( colors[2] ).bytes;
+	vector< uint8_t > updateZoneLEDsBytes = ProtocolWriter().header( 1, MessageType::RGBCONTROLLER_UPDATEZONELEDS, 22 ).u32( 22 ).u32( 2 ).u16( 3 )
+		.color( colors[1] ).color( colors[1] ).color( colors[1] ).bytes;
+
+	bool colorMessagesMatch =
+		   expect( serializeToBytes( UpdateLEDs( 1, colors ), 3 ) == updateLEDsBytes, "UpdateLEDs" )
+		&& expect( serializeToBytes( UpdateZoneLEDs( 1, 2, colors[1], 3 ), 3 ) == updateZoneLEDsBytes, "UpdateZoneLEDs with a repeated color" );
+
+	return reportResult( codecsMatch && colorMessagesMatch );
+}
+
+static bool checkTrafficLog()
+{
+	cout << "Checking the recording and reading of a traffic log." << endl;
+
+	const string filePath = "orgb-selftest.trafficlog";
+	vector< uint8_t > part1 = serializeToBytes( RequestControllerCount(), 3 );
+	vector< uint8_t > part2 = { 1, 2, 3, 4, 5 };
+
+	TrafficRecorder recorder;
+	if (!expect( recorder.open( filePath ), "the log can't be created" ))
+		return false;
+	recorder.record( TrafficDirection::Sent, part1 );
+	recorder.record( TrafficDirection::Received, part1, part2 );
+	recorder.record( TrafficDirection::Sent, part2 );
+	recorder.close();
+
+	vector< uint8_t > joined = part1;
+	joined.insert( joined.end(), part2.begin(), part2.end() );
+
+	TrafficLogReader reader;
+	TrafficLogReader::Record records [4];
+	bool readBack =
+		   expect( reader.open( filePath ), "the log can't be opened" )
+		&& expect( reader.next( records[0] ) && reader.next( records[1] ) && reader.next( records[2] ), "some records are missing" )
+		&& expect( !reader.next( records[3] ), "there are more records than were recorded" )
+		&& expect( records[0].direction == TrafficDirection::Sent && records[1].direction == TrafficDirection::Received
+		        && records[2].direction == TrafficDirection::Sent, "the directions differ" )
+		&& expect( vector< uint8_t >( records[0].data.begin(), records[0].data.end() ) == part1
+		        && vector< uint8_t >( records[1].data.begin(), records[1].data.end() ) == joined
+		        && vector< uint8_t >( records[2].data.begin(), records[2].data.end() ) == part2, "the data differ" );
+	reader.close();
+
+	// a recording interrupted in the middle of the last record ends before it,
+	// the last 5 bytes are followed by 3 bytes of alignment, so cutting 4 bytes cuts into the data
+	vector< uint8_t > bytes = readFile( filePath );
+	bool truncatedEnds = writeFile( filePath, bytes.data(), bytes.size() - 4 )
+		&& expect( reader.open( filePath ), "the truncated log can't be opened" )
+		&& expect( reader.next( records[0] ) && reader.next( records[1] ) && !reader.next( records[2] ), "the truncated record isn't treated as the end" );
+	reader.close();
+
+	std::remove( filePath.c_str() );
+	return reportResult( readBack && truncatedEnds );
+}
+
+/// Whether all the strings and arrays of a snapshot lie inside its memory and its enums have valid values.
+static bool isSnapshotConsistent( const DeviceListSnapshot & snapshot, const vector< uint8_t > & data )
+{
+	const uint8_t * begin = data.data();
+	const uint8_t * end = data.data() + data.size();
+	auto inside = [ begin, end ]( const void * ptr, size_t size )
+	{
+		const uint8_t * bytes = static_cast< const uint8_t * >( ptr );
+		return bytes >= begin && bytes <= end && size <= size_t( end - bytes );
+	};
+	auto insideString = [ &inside ]( StringView str )
+	{
+		return inside( str.data(), str.size() + 1 ) && str.data()[ str.size() ] == '\0';
+	};
+
+	for (const SnapshotDevice & device : snapshot)
+	{
+		if (!insideString( device.getName() ) || !insideString( device.getVendor() ) || !insideString( device.getDescription() )
+		 || !insideString( device.getVersion() ) || !insideString( device.getSerial() ) || !insideString( device.getLocation() )
+		 || !inside( device.getColors().data(), device.getColors().size() * sizeof(Color) )
+		 || uint32_t( device.type ) > uint32_t( DeviceType::Unknown ))
+			return false;
+		for (const SnapshotMode & mode : device.getModes())
+			if (!inside( &mode, sizeof(mode) ) || !insideString( mode.getName() )
+			 || !inside( mode.getColors().data(), mode.getColors().size() * sizeof(Color) )
+			 || uint32_t( mode.direction ) > uint32_t( Direction::Vertical ) || uint32_t( mode.color_mode ) > uint32_t( ColorMode::Random ))
+				return false;
+		for (const SnapshotZone & zone : device.getZones())
+			if (!inside( &zone, sizeof(zone) ) || !insideString( zone.getName() )
+			 || !inside( zone.getMatrixValues().data(), zone.getMatrixValues().size() * sizeof(uint32_t) )
+			 || uint32_t( zone.type ) > uint32_t( ZoneType::Matrix ))
+				return false;
+		for (const SnapshotLED & led : device.getLEDs())
+			if (!inside( &led, sizeof(led) ) || !insideString( led.getName() ))
+				return false;
+	}
+	return true;
+}
+
+static bool checkSnapshot( const DeviceList & devices )
+{
+	cout << "Checking the device list snapshots, also truncated and damaged ones." << endl;
+
+	vector< uint8_t > data = makeSnapshot( devices, 42 );
+	DeviceListSnapshot snapshot;
+	bool valid =
+		   expect( snapshot.attach( data.data(), data.size() ) == SnapshotStatus::Success, "a snapshot of the devices is refused" )
+		&& expect( snapshot.size() == devices.size() && snapshot.sequence() == 42, "the snapshot has a different size or sequence" )
+		&& expect( snapshot[0].getName() == StringView( devices[0].name )
+		        && snapshot[0].getLEDs().size() == devices[0].leds.size()
+		        && snapshot[0].getZones().size() == devices[0].zones.size()
+		        && snapshot[0].getZones()[1].getMatrixValues().size() == devices[0].zones[1].matrix_values.size()
+		        && sameColors( snapshot[1].getColors(), devices[1].colors ), "the snapshot differs from the devices" )
+		&& expect( snapshot.find( DeviceType::LedStrip ) == &snapshot[1] && snapshot.find( "Test keyboard" ) == &snapshot[0],
+		           "the devices can't be found" )
+		&& expect( isSnapshotConsistent( snapshot, data ), "the snapshot points outside of itself" );
+	snapshot.close();
+
+	// every incomplete snapshot must be refused
+	size_t acceptedPrefixes = 0;
+	for (size_t size = 0; size < data.size(); ++size)
+	{
+		vector< uint8_t > prefix( data.begin(), data.begin() + ptrdiff_t( size ) );
+		if (snapshot.attach( prefix.data(), prefix.size() ) == SnapshotStatus::Success)
+			++acceptedPrefixes;
+		snapshot.close();
+	}
+
+	// a damaged byte may still give a valid snapshot, but one that never points outside of itself
+	static const uint8_t damages [] = { 0x01, 0x80, 0xFF };
+	size_t inconsistentSnapshots = 0;
+	for (size_t pos = 0; pos < data.size(); ++pos)
+	{
+		for (uint8_t damage : damages)
+		{
+			vector< uint8_t > damaged = data;
+			damaged[ pos ] ^= damage;
+			if (snapshot.attach( damaged.data(), damaged.size() ) == SnapshotStatus::Success && !isSnapshotConsistent( snapshot, damaged ))
+				++inconsistentSnapshots;
+			snapshot.close();
+		}
+	}
+
+	const string filePath = "orgb-selftest.snapshot";
+	bool fileWorks =
+		   expect( saveSnapshot( devices, filePath, 7 ) == SnapshotStatus::Success, "the snapshot file can't be saved" )
+		&& expect( snapshot.open( filePath ) == SnapshotStatus::Success && snapshot.sequence() == 7, "the saved snapshot can't be opened" );
+	snapshot.close();
+	bool truncatedFileRefused = fileWorks
+		&& writeFile( filePath, data.data(), data.size() / 2 )
+		&& expect( snapshot.open( filePath ) != SnapshotStatus::Success, "a truncated snapshot file is accepted" );
+	snapshot.close();
+	std::remove( filePath.c_str() );
+
+	return reportResult( valid
+		&& expect( acceptedPrefixes == 0, "an incomplete snapshot is accepted" )
+		&& expect( inconsistentSnapshots == 0, "a damaged snapshot points outside of itself or has invalid enum values" )
+		&& fileWorks && truncatedFileRefused );
+}
+
+static bool checkLayout( const DeviceList & devices )
+{
+	cout << "Checking the layout of the LEDs and the parsing of layout files." << endl;
+
+	// the keyboard has a row of 4 LEDs and a matrix of 2x2 cells with 3 LEDs below it, the strip is below the keyboard
+	Layout layout( devices );
+	const size_t stripFirst = devices[0].leds.size();
+	auto isAt = [ &layout ]( size_t ledIdx, float x, float y, float z )
+	{
+		Point3 position = layout.position( ledIdx );
+		return position.x == x && position.y == y && position.z == z;
+	};
+
+	bool derived = expect( layout.size() == stripFirst + devices[1].leds.size(), "the layout has a different number of LEDs" )
+		&& expect( isAt( 3, 3, 0, 0 ) && isAt( 5, 1, 1, 0 ) && isAt( 6, 0, 2, 0 ) && isAt( stripFirst + 3, 3, 5, 0 ),
+		           "the positions derived from the zones are wrong" );
+
+	LayoutStatus status = layout.parse(
+		"# the keyboard is moved and scaled, one LED of the strip is moved\n"
+		"device \"Test keyboard\" 10 20 0 2\n"
+		"\n"
+		"led \"Test strip\" 1 5 5 5\n"
+	);
+	bool parsed = expect( status == LayoutStatus::Success, enumString( status ) )
+		&& expect( isAt( 6, 10, 24, 0 ) && isAt( stripFirst + 1, 5, 10, 5 ) && isAt( stripFirst + 3, 3, 5, 0 ),
+		           "the layout file was applied wrong" );
+
+	struct { const char * text; LayoutStatus status; uint32_t errorLine; } invalidFiles [] =
+	{
+		{ "device \"Nonexistent\" 0 0 0\n",           LayoutStatus::UnknownDevice, 1 },
+		{ "\n# comment\nled \"Test strip\" 5 0 0 0",  LayoutStatus::LedOutOfRange, 3 },
+		{ "device \"Test strip\" 1 2\n",               LayoutStatus::InvalidSyntax, 1 },
+		{ "led \"Test strip\" x 0 0 0\n",              LayoutStatus::InvalidSyntax, 1 },
+		{ "device \"Test strip 0 0 0\n",               LayoutStatus::InvalidSyntax, 1 },
+	};
+	bool invalidRefused = true;
+	for (const auto & file : invalidFiles)
+	{
+		status = layout.parse( file.text );
+		if (status != file.status || layout.errorLine() != file.errorLine)
+		{
+			cout << " -> failed: " << file.text << " ended with " << enumString( status ) << " at line " << layout.errorLine() << endl;
+			invalidRefused = false;
+		}
+	}
+
+	return reportResult( derived && parsed && invalidRefused );
+}
+
+static bool checkAnimation( const DeviceList & devices )
+{
+	cout << "Checking the recording and playing of animations." << endl;
+
+	size_t ledCount = 0;
+	for (const Device & device : devices)
+		ledCount += device.leds.size();
+
+	const string filePath = "orgb-selftest.animation";
+	AnimationWriter writer;
+	AnimationStatus status = writer.open( filePath, devices, 30.0, 4 );
+	if (!expect( status == AnimationStatus::Success, enumString( status ) ))
+		return false;
+
+	// whole new frames alternate with frames that change a single LED, which are stored as deltas
+	vector< vector< Color > > frames;
+	vector< Color > frame( ledCount, Color( 0, 0, 0 ) );
+	for (uint32_t frameIdx = 0; frameIdx < 10; ++frameIdx)
+	{
+		if (frameIdx % 3 == 0)
+			for (size_t ledIdx = 0; ledIdx < ledCount; ++ledIdx)
+				frame[ ledIdx ] = Color( uint8_t( frameIdx * 20 ), uint8_t( ledIdx * 10 ), 0 );
+		else
+			frame[ frameIdx % ledCount ] = Color( 255, uint8_t( frameIdx ), 1 );
+		frames.push_back( frame );
+		status = writer.addFrame( frame );
+	}
+	status = writer.finish();
+	if (!expect( status == AnimationStatus::Success, enumString( status ) ))
+		return false;
+
+	AnimationPlayer player;
+	status = player.open( filePath );
+	bool opened = expect( status == AnimationStatus::Success, enumString( status ) )
+		&& expect( player.frameCount() == frames.size() && player.ledCount() == ledCount && player.matches( devices ),
+		           "the animation has a different size" );
+
+	size_t wrongFrames = 0;
+	for (uint32_t frameIdx = 0; opened && frameIdx < frames.size(); ++frameIdx)
+		if (!sameColors( player.frame( frameIdx ), frames[ frameIdx ] ))
+			++wrongFrames;
+	for (uint32_t frameIdx = uint32_t( frames.size() ); opened && frameIdx-- > 0; )  // jumping back to the keyframes
+		if (!sameColors( player.frame( frameIdx ), frames[ frameIdx ] ))
+			++wrongFrames;
+	player.close();
+
+	vector< uint8_t > bytes = readFile( filePath );
+	bool truncatedRefused = writeFile( filePath, bytes.data(), bytes.size() - 1 )
+		&& expect( player.open( filePath ) != AnimationStatus::Success, "a truncated animation is accepted" );
+	player.close();
+	std::remove( filePath.c_str() );
+
+	return reportResult( opened && expect( wrongFrames == 0, "some frames are decoded wrong" ) && truncatedRefused );
+}
+
+static bool checkServer( uint16_t port, TestServerHandler & handler, DeviceListResult & devices )
+{
+	cout << "Checking the server of this library with its client." << endl;
+
+	Client testClient( "OpenRGB-cppSDK self test" );
+	ConnectStatus connectStatus = testClient.connect( "127.0.0.1", port );
+	if (!expect( connectStatus == ConnectStatus::Success, enumString( connectStatus ) ))
+		return false;
+
+	devices = testClient.requestDeviceList();
+	bool received = expect( devices.status == RequestStatus::Success, enumString( devices.status ) )
+		&& expect( devices.devices.size() == 2
+		        && devices.devices[0].name == "Test keyboard" && devices.devices[0].leds.size() == 7
+		        && devices.devices[0].zones.size() == 2 && devices.devices[0].zones[1].matrix_values.size() == 4
+		        && devices.devices[1].name == "Test strip" && devices.devices[1].leds.size() == 5,
+		           "the devices differ from those that were sent" );
+	if (!received)
+		return false;
+
+	vector< Color > colors = { Color::Red, Color::Green, Color::Blue, Color::White, Color( 1, 2, 3 ) };
+	RequestStatus setStatus = testClient.setDeviceColors( devices.devices[1], colors );
+	bool colorsArrived = false;
+	for (unsigned attempt = 0; attempt < 100 && setStatus == RequestStatus::Success && !colorsArrived; ++attempt)
+	{
+		// the colors are processed by the thread of the server
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+		std::lock_guard< std::mutex > lock( handler.mutex );
+		colorsArrived = handler.updatedDevice == 1 && sameColors( handler.updatedColors, colors );
+	}
+
+	// the reply to a request that gave up waiting must not be taken for the reply to the next request
+	ProfileListResult lateProfiles = testClient.requestProfileList( RequestLimits( std::chrono::milliseconds( 50 ) ) );
+	DeviceCountResult count = testClient.requestDeviceCount();
+	ProfileListResult profiles = testClient.requestProfileList();
+
+	return reportResult(
+		   expect( colorsArrived, "the colors didn't arrive to the server" )
+		&& expect( lateProfiles.status == RequestStatus::NoReply, "the slow request didn't time out" )
+		&& expect( count.status == RequestStatus::Success && count.count == 2, "the late reply was mistaken for the next one" )
+		&& expect( profiles.status == RequestStatus::Success && profiles.profiles.size() == 1
+		        && profiles.profiles[0] == "Test profile", "the profile list differs" )
+	);
+}
+
+#ifdef __linux__
+
+static bool checkServerFraming( uint16_t port )
+{
+	cout << "Checking that the server splits the incoming bytes into messages." << endl;
+
+	int fd = connectToLoopback( port );
+	if (!expect( fd >= 0, "can't connect to the server" ))
+		return false;
+	setReceiveTimeout( fd );
+
+	auto receiveCount = [ fd ]()
+	{
+		uint8_t reply [20];
+		if (receiveAll( fd, reply, sizeof(reply) ) != sizeof(reply) || memcmp( reply, "ORGB", 4 ) != 0)
+			return uint32_t( -1 );
+		return uint32_t( reply[16] | reply[17] << 8 | reply[18] << 16 | uint32_t( reply[19] ) << 24 );
+	};
+
+	// a message arriving byte by byte
+	vector< uint8_t > request = serializeToBytes( RequestControllerCount(), 0 );
+	bool bytesSent = true;
+	for (uint8_t byte : request)
+	{
+		bytesSent &= sendAll( fd, { byte } );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	bool splitMessageAnswered = bytesSent && receiveCount() == 2;
+
+	// more messages arriving at once
+	vector< uint8_t > twoRequests = request;
+	twoRequests.insert( twoRequests.end(), request.begin(), request.end() );
+	bool joinedMessagesAnswered = sendAll( fd, twoRequests ) && receiveCount() == 2 && receiveCount() == 2;
+
+	// something that isn't a message
+	vector< uint8_t > garbage( 16, 'X' );
+	uint8_t byte;
+	bool garbageRefused = sendAll( fd, garbage ) && ::recv( fd, &byte, 1, 0 ) == 0;
+	::close( fd );
+
+	return reportResult(
+		   expect( splitMessageAnswered, "a message split into more parts wasn't answered" )
+		&& expect( joinedMessagesAnswered, "more messages received at once weren't all answered" )
+		&& expect( garbageRefused, "the server didn't close a connection sending garbage" )
+	);
+}
+
+static bool checkClientResync()
+{
+	cout << "Checking that the client finds the next message after bytes that don't belong to any." << endl;
+
+	uint16_t port = 0;
+	int listenFd = listenOnLoopback( port );
+	if (!expect( listenFd >= 0, "can't listen on the loopback" ))
+		return false;
+	setReceiveTimeout( listenFd );  // doesn't let accept(...) wait forever when the client fails
+
+	// a fake server sending garbage before the reply, including an incomplete magic
+	std::thread fakeServer( [ listenFd ]()
+	{
+		int fd = ::accept( listenFd, nullptr, nullptr );
+		if (fd < 0)
+			return;
+		setReceiveTimeout( fd );
+		if (receiveMessage( fd ) == int64_t( MessageType::REQUEST_PROTOCOL_VERSION )
+		 && sendAll( fd, serializeToBytes( ReplyProtocolVersion( implementedProtocolVersion ), 0 ) )
+		 && receiveMessage( fd ) == int64_t( MessageType::SET_CLIENT_NAME )
+		 && receiveMessage( fd ) == int64_t( MessageType::REQUEST_CONTROLLER_COUNT ))
+		{
+			vector< uint8_t > reply = { 'g', 'a', 'r', 'b', 'a', 'g', 'e', ' ', 'O', 'R', 'G' };
+			vector< uint8_t > count = serializeToBytes( ReplyControllerCount( 7 ), 0 );
+			reply.insert( reply.end(), count.begin(), count.end() );
+			sendAll( fd, reply );
+		}
+		::close( fd );
+	});
+
+	Client testClient( "OpenRGB-cppSDK self test" );
+	ConnectStatus connectStatus = testClient.connect( "127.0.0.1", port );
+	DeviceCountResult count = { RequestStatus::NotConnected, 0 };
+	if (connectStatus == ConnectStatus::Success)
+		count = testClient.requestDeviceCount();
+	testClient.disconnect();
+	fakeServer.join();
+	::close( listenFd );
+
+	return reportResult(
+		   expect( connectStatus == ConnectStatus::Success, enumString( connectStatus ) )
+		&& expect( count.status == RequestStatus::Success && count.count == 7, enumString( count.status ) )
+	);
+}
+
+#endif // __linux__
+
+static bool selftest( const ArgList & )
+{
+	bool success = true;
+	success &= checkColorNames();
+	success &= checkThreadPool();
+	success &= checkCodecs();
+	success &= checkTrafficLog();
+
+	TestServerHandler handler;
+	handler.devices.push_back( makeTestDevice( 0, DeviceType::Keyboard, "Test keyboard", { 4, 3 }, true ) );
+	handler.devices.push_back( makeTestDevice( 1, DeviceType::LedStrip, "Test strip", { 5 }, false ) );
+	if (!handler.devices[0] || !handler.devices[1])
+	{
+		cout << "The test devices can't be parsed." << endl;
+		return false;
+	}
+
+	// the devices can only be received, so the checks that need them get them from the server of this library
+	Server server( handler );
+	ServerStatus serverStatus = server.start( 0, "127.0.0.1" );
+	if (serverStatus == ServerStatus::Success)
+	{
+		std::thread serverThread( [ &server ]() { server.run(); } );
+
+		DeviceListResult devices = { RequestStatus::NotConnected, {} };
+		bool serverWorks = checkServer( server.port(), handler, devices );
+		success &= serverWorks;
+		if (serverWorks)
+		{
+			success &= checkSnapshot( devices.devices );
+			success &= checkLayout( devices.devices );
+			success &= checkAnimation( devices.devices );
+		}
+	#ifdef __linux__
+		success &= checkServerFraming( server.port() );
+	#endif
+
+		server.interrupt();
+		serverThread.join();
+		server.stop();
+	}
+	else
+	{
+		cout << "Skipping the checks that need devices, the server can't start: " << enumString( serverStatus ) << endl;
+	}
+
+#ifdef __linux__
+	success &= checkClientResync();
+#endif
+
+	cout << (success ? "All the checks have passed." : "Some checks have failed.") << endl;
+	return success;
+}
+
 
 //======================================================================================================================
 
@@ -791,6 +1710,10 @@ static void executeCommand( const Command & command, const ArgList & args )
 		handler = loadprofile;
 	else if (command.name == "delprofile")
 		handler = delprofile;
+	else if (command.name == "checkconv")
+		handler = checkconv;
+	else if (command.name == "selftest")
+		handler = selftest;
 	else
 	{
 		cout << "Unknown command. Use 'help' to see the list of all possible commands" << endl;
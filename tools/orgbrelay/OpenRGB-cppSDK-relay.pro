@@ -0,0 +1,23 @@
+TARGET = orgbrelay
+
+TEMPLATE = app
+CONFIG += console
+CONFIG += c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+release: CONFIG += static
+
+QMAKE_CXXFLAGS += -Wno-old-style-cast
+
+INCLUDEPATH += ../../include
+INCLUDEPATH += ../../external
+
+HEADERS += \
+	src/Relay.hpp
+
+SOURCES += \
+	src/Relay.cpp \
+	src/main.cpp
+
+LIBS += -L"../../../build-linux64-release" -lorgbsdk
+LIBS += -lcppnet -lcppbase
@@ -0,0 +1,264 @@
+#include "Relay.hpp"
+
+#include <cstdio>
+#include <algorithm>  // min, copy
+using namespace std;
+using namespace std::chrono;
+using namespace orgb;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const seconds reconnectPeriod( 1 );
+
+Relay::Relay( const string & clientName, const string & host, uint16_t port )
+:
+	_upstream( clientName ),
+	_server( *this ),  // the server only stores the reference
+	_host( host ),
+	_port( port ),
+	_upstreamLost( true ),
+	_nextReconnect( steady_clock::now() )
+{}
+
+bool Relay::connectUpstream()
+{
+	_upstream.disconnect();
+
+	ConnectStatus status = _upstream.connect( _host, _port );
+	if (status != ConnectStatus::Success)
+	{
+		printf( "cannot connect to %s:%u: %s\n", _host.c_str(), unsigned( _port ), enumString( status ) );
+		return false;
+	}
+
+	if (!refreshDevices())
+	{
+		return false;
+	}
+
+	_upstreamLost = false;
+	return true;
+}
+
+bool Relay::refreshDevices()
+{
+	DeviceListResult result = _upstream.requestDeviceList();
+	if (result.status != RequestStatus::Success)
+	{
+		printf( "cannot get the device list: %s\n", enumString( result.status ) );
+		checkStatus( result.status );
+		return false;
+	}
+
+	_devices = move( result.devices );
+
+	// the pending colors were meant for the old devices
+	_frames.clear();
+	_frames.resize( _devices.size() );
+	for (const Device & device : _devices)
+	{
+		DeviceFrame & frame = _frames[ device.idx ];
+		frame.colors = device.colors;
+	}
+
+	// the local clients need to download the new list from us
+	_server.notifyDeviceListUpdated();
+	return true;
+}
+
+void Relay::refreshDevice( uint32_t deviceIdx )
+{
+	DeviceInfoResult result = _upstream.requestDeviceInfo( deviceIdx );
+	checkStatus( result.status );
+	if (result.status == RequestStatus::Success)
+	{
+		_devices.replace( deviceIdx, move( result.device ) );
+	}
+}
+
+void Relay::checkStatus( RequestStatus status )
+{
+	if (status == RequestStatus::NotConnected || status == RequestStatus::SendRequestFailed
+	 || status == RequestStatus::ConnectionClosed)
+	{
+		if (!_upstreamLost)
+			printf( "lost the connection to the upstream server\n" );
+		_upstreamLost = true;
+	}
+}
+
+void Relay::flush()
+{
+	if (_upstreamLost)
+		return;  // the colors stay dirty until we reconnect
+
+	for (uint32_t deviceIdx = 0; deviceIdx < _frames.size(); ++deviceIdx)
+	{
+		DeviceFrame & frame = _frames[ deviceIdx ];
+		if (!frame.dirty)
+			continue;
+
+		RequestStatus status = _upstream.setDeviceColors( _devices[ deviceIdx ], frame.colors );
+		checkStatus( status );
+		if (_upstreamLost)
+			return;
+
+		frame.dirty = false;
+		_stats.upstreamUpdates++;
+	}
+}
+
+void Relay::checkUpstream()
+{
+	if (_upstreamLost)
+	{
+		auto now = steady_clock::now();
+		if (now >= _nextReconnect)
+		{
+			_nextReconnect = now + reconnectPeriod;
+			if (connectUpstream())
+				printf( "reconnected to the upstream server\n" );
+		}
+		return;
+	}
+
+	UpdateStatus status = _upstream.checkForDeviceUpdates();
+	if (status == UpdateStatus::OutOfDate)
+	{
+		refreshDevices();
+	}
+	else if (status == UpdateStatus::ConnectionClosed)
+	{
+		checkStatus( RequestStatus::ConnectionClosed );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+//  enumeration served from the cache
+
+uint32_t Relay::deviceCount()
+{
+	return uint32_t( _devices.size() );
+}
+
+const Device * Relay::device( uint32_t deviceIdx )
+{
+	if (deviceIdx >= _devices.size())
+		return nullptr;
+
+	_stats.enumerations++;
+	return &_devices[ deviceIdx ];
+}
+
+void Relay::clientConnected( const ServerClientInfo & client )
+{
+	printf( "client %llu connected from %s\n", (unsigned long long)client.id, client.address.c_str() );
+}
+
+void Relay::clientDisconnected( const ServerClientInfo & client )
+{
+	printf( "client %llu (%s) disconnected\n", (unsigned long long)client.id, client.name.c_str() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+//  colors merged into the device frames
+
+void Relay::updateLEDs( const ServerClientInfo &, uint32_t deviceIdx, Span< const Color > colors )
+{
+	DeviceFrame & frame = _frames[ deviceIdx ];
+	size_t count = min( colors.size(), frame.colors.size() );
+	copy( colors.begin(), colors.begin() + count, frame.colors.begin() );
+	frame.dirty = true;
+	_stats.localUpdates++;
+}
+
+void Relay::updateZoneLEDs( const ServerClientInfo &, uint32_t deviceIdx, uint32_t zoneIdx, Span< const Color > colors )
+{
+	const Device & device = _devices[ deviceIdx ];
+	if (zoneIdx >= device.zones.size())
+		return;
+
+	DeviceFrame & frame = _frames[ deviceIdx ];
+	uint32_t offset = device.zones[ zoneIdx ].start_idx;
+	if (offset >= frame.colors.size())
+		return;
+	size_t count = min( { colors.size(), size_t( device.zones[ zoneIdx ].leds_count ), frame.colors.size() - offset } );
+	copy( colors.begin(), colors.begin() + count, frame.colors.begin() + offset );
+	frame.dirty = true;
+	_stats.localUpdates++;
+}
+
+void Relay::updateSingleLED( const ServerClientInfo &, uint32_t deviceIdx, uint32_t ledIdx, Color color )
+{
+	DeviceFrame & frame = _frames[ deviceIdx ];
+	if (ledIdx >= frame.colors.size())
+		return;
+
+	frame.colors[ ledIdx ] = color;
+	frame.dirty = true;
+	_stats.localUpdates++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+//  other requests are forwarded immediately
+
+void Relay::resizeZone( const ServerClientInfo &, uint32_t deviceIdx, uint32_t zoneIdx, uint32_t newSize )
+{
+	const Device & device = _devices[ deviceIdx ];
+	if (zoneIdx >= device.zones.size())
+		return;
+
+	checkStatus( _upstream.setZoneSize( device.zones[ zoneIdx ], newSize ) );
+	// the LEDs of the device have changed
+	if (!_upstreamLost)
+		refreshDevices();
+}
+
+void Relay::setCustomMode( const ServerClientInfo &, uint32_t deviceIdx )
+{
+	checkStatus( _upstream.switchToCustomMode( _devices[ deviceIdx ] ) );
+	if (!_upstreamLost)
+		refreshDevice( deviceIdx );
+}
+
+void Relay::updateMode( const ServerClientInfo &, uint32_t deviceIdx, const Mode & mode )
+{
+	checkStatus( _upstream.changeMode( _devices[ deviceIdx ], mode ) );
+	// keep the active mode and the mode parameters in the cache up to date
+	if (!_upstreamLost)
+		refreshDevice( deviceIdx );
+}
+
+void Relay::saveMode( const ServerClientInfo &, uint32_t deviceIdx, const Mode & mode )
+{
+	checkStatus( _upstream.saveMode( _devices[ deviceIdx ], mode ) );
+}
+
+vector< string > Relay::profileList( const ServerClientInfo & )
+{
+	ProfileListResult result = _upstream.requestProfileList();
+	checkStatus( result.status );
+	return move( result.profiles );
+}
+
+void Relay::saveProfile( const ServerClientInfo &, const string & profileName )
+{
+	checkStatus( _upstream.saveProfile( profileName ) );
+}
+
+void Relay::loadProfile( const ServerClientInfo &, const string & profileName )
+{
+	checkStatus( _upstream.loadProfile( profileName ) );
+	// loading a profile changes the modes and colors of all devices
+	if (!_upstreamLost)
+		refreshDevices();
+}
+
+void Relay::deleteProfile( const ServerClientInfo &, const string & profileName )
+{
+	checkStatus( _upstream.deleteProfile( profileName ) );
+}
@@ -0,0 +1,98 @@
+#ifndef RELAY_INCLUDED
+#define RELAY_INCLUDED
+
+#include <OpenRGB/Server.hpp>
+#include <OpenRGB/Client.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Serves the local clients from a cached device list and forwards their requests through one upstream connection.
+/** The colors from all the local clients are merged into one frame per device, the latest update of each LED wins.
+  * The frames of the devices that changed are sent upstream only on flush(), one message per device. */
+class Relay : public orgb::ServerHandler
+{
+
+ public:
+
+	struct Stats
+	{
+		uint64_t localUpdates = 0;     ///< color updates received from the local clients
+		uint64_t upstreamUpdates = 0;  ///< color updates sent to the upstream server
+		uint64_t enumerations = 0;     ///< device descriptions served from the cache
+	};
+
+	Relay( const std::string & clientName, const std::string & host, uint16_t port );
+
+	/// The server for the local clients, start it after connecting upstream.
+	orgb::Server & server()  { return _server; }
+
+	/// Connects to the upstream server and downloads the device list into the cache.
+	bool connectUpstream();
+
+	/// Sends the latest colors of every device that changed since the last flush.
+	void flush();
+
+	/// Refreshes the cache when the upstream device list has changed and reconnects a lost upstream connection.
+	void checkUpstream();
+
+	bool isUpstreamConnected() const  { return !_upstreamLost; }
+
+	const Stats & stats() const  { return _stats; }
+
+	//-- ServerHandler -------------------------------------------------------------------------------------------------
+
+	uint32_t deviceCount() override;
+	const orgb::Device * device( uint32_t deviceIdx ) override;
+
+	void clientConnected( const orgb::ServerClientInfo & client ) override;
+	void clientDisconnected( const orgb::ServerClientInfo & client ) override;
+
+	void resizeZone( const orgb::ServerClientInfo & client, uint32_t deviceIdx, uint32_t zoneIdx, uint32_t newSize ) override;
+	void updateLEDs( const orgb::ServerClientInfo & client, uint32_t deviceIdx, orgb::Span< const orgb::Color > colors ) override;
+	void updateZoneLEDs( const orgb::ServerClientInfo & client, uint32_t deviceIdx, uint32_t zoneIdx, orgb::Span< const orgb::Color > colors ) override;
+	void updateSingleLED( const orgb::ServerClientInfo & client, uint32_t deviceIdx, uint32_t ledIdx, orgb::Color color ) override;
+	void setCustomMode( const orgb::ServerClientInfo & client, uint32_t deviceIdx ) override;
+	void updateMode( const orgb::ServerClientInfo & client, uint32_t deviceIdx, const orgb::Mode & mode ) override;
+	void saveMode( const orgb::ServerClientInfo & client, uint32_t deviceIdx, const orgb::Mode & mode ) override;
+
+	std::vector< std::string > profileList( const orgb::ServerClientInfo & client ) override;
+	void saveProfile( const orgb::ServerClientInfo & client, const std::string & profileName ) override;
+	void loadProfile( const orgb::ServerClientInfo & client, const std::string & profileName ) override;
+	void deleteProfile( const orgb::ServerClientInfo & client, const std::string & profileName ) override;
+
+ private:
+
+	/// Latest colors of a device merged from all the local clients.
+	struct DeviceFrame
+	{
+		std::vector< orgb::Color > colors;
+		bool dirty = false;
+	};
+
+	bool refreshDevices();
+	void refreshDevice( uint32_t deviceIdx );
+	void checkStatus( orgb::RequestStatus status );
+
+	orgb::Client _upstream;
+	orgb::Server _server;
+	std::string _host;
+	uint16_t _port;
+
+	orgb::DeviceList _devices;
+	std::vector< DeviceFrame > _frames;
+
+	bool _upstreamLost;
+	std::chrono::steady_clock::time_point _nextReconnect;
+
+	Stats _stats;
+
+};
+
+
+#endif // RELAY_INCLUDED
@@ -0,0 +1,194 @@
+#include "Relay.hpp"
+
+#include <OpenRGB/Server.hpp>
+#include <OpenRGB/Client.hpp>
+using namespace orgb;
+
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <string>
+using namespace std;
+#include <chrono>
+using namespace std::chrono;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define APP_FULL_NAME "OpenRGB C++ SDK relay"
+#define CLIENT_NAME "OpenRGB-cppSDK relay"
+
+#define EXECUTABLE_NAME "orgbrelay"
+#define USAGE EXECUTABLE_NAME " [--listen [<address>:]<port>] [--upstream <host_name>[:<port>]] [--rate <updates_per_second>] [--stats]"
+#define EXAMPLE EXECUTABLE_NAME " --listen 6743 --upstream localhost:6742 --rate 60"
+
+static const uint16_t defaultListenPort = 6743;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Options
+{
+	string listenAddress = "127.0.0.1";
+	uint16_t listenPort = defaultListenPort;
+	string upstreamHost = "127.0.0.1";
+	uint16_t upstreamPort = defaultPort;
+	double rate = 60.0;
+	bool printStats = false;
+};
+
+static bool parsePort( const string & str, uint16_t & port )
+{
+	char * end = nullptr;
+	long value = strtol( str.c_str(), &end, 10 );
+	if (str.empty() || *end != '\0' || value <= 0 || value > 65535)
+		return false;
+	port = uint16_t( value );
+	return true;
+}
+
+// parses [<host>:]<port> when portOnlyAllowed, otherwise <host>[:<port>]
+static bool parseEndpoint( const string & str, bool portOnlyAllowed, string & host, uint16_t & port )
+{
+	size_t colonPos = str.find(':');
+	if (colonPos == string::npos)
+	{
+		if (portOnlyAllowed)
+			return parsePort( str, port );
+		host = str;
+		return !host.empty();
+	}
+	host = str.substr( 0, colonPos );
+	return !host.empty() && parsePort( str.substr( colonPos + 1 ), port );
+}
+
+static bool parseArgs( int argc, char * argv [], Options & options )
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--listen" && hasValue)
+		{
+			if (!parseEndpoint( argv[++i], true, options.listenAddress, options.listenPort ))
+				return false;
+		}
+		else if (arg == "--upstream" && hasValue)
+		{
+			if (!parseEndpoint( argv[++i], false, options.upstreamHost, options.upstreamPort ))
+				return false;
+		}
+		else if (arg == "--rate" && hasValue)
+		{
+			options.rate = atof( argv[++i] );
+			if (options.rate <= 0.0)
+				return false;
+		}
+		else if (arg == "--stats")
+		{
+			options.printStats = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static volatile sig_atomic_t keepRunning = 1;
+static Server * g_server = nullptr;
+
+static void signalFunc( int )
+{
+	keepRunning = 0;
+	if (g_server)
+		g_server->interrupt();  // wakes up processEvents()
+}
+
+int main( int argc, char * argv [] )
+{
+	Options options;
+	if (!parseArgs( argc, argv, options ))
+	{
+		printf(
+			APP_FULL_NAME "\n"
+			"\n"
+			"Merges the connections of many local clients into one connection to the OpenRGB server.\n"
+			"  Usage is as follows: " USAGE "\n"
+			"          For example: " EXAMPLE "\n"
+		);
+		return 1;
+	}
+
+	Relay relay( CLIENT_NAME, options.upstreamHost, options.upstreamPort );
+	Server & server = relay.server();
+
+	// the device list must be cached before the first local client asks for it
+	if (!relay.connectUpstream())
+	{
+		return 1;
+	}
+
+	ServerStatus status = server.start( options.listenPort, options.listenAddress );
+	if (status != ServerStatus::Success)
+	{
+		printf( "cannot listen on %s:%u: %s (error code: %d)\n", options.listenAddress.c_str(), unsigned( options.listenPort ),
+		        enumString( status ), int( server.getLastSystemError() ) );
+		return 1;
+	}
+	printf( "relaying %s:%u to %s:%u\n", options.listenAddress.c_str(), unsigned( server.port() ),
+	        options.upstreamHost.c_str(), unsigned( options.upstreamPort ) );
+
+	// a clean way to quit the application without killing it by force
+	g_server = &server;
+	signal( SIGINT, signalFunc );
+	signal( SIGTERM, signalFunc );
+
+	auto flushPeriod = duration_cast< steady_clock::duration >( duration< double >( 1.0 / options.rate ) );
+	auto nextFlush = steady_clock::now() + flushPeriod;
+	auto nextStats = steady_clock::now() + seconds( 10 );
+	Relay::Stats lastStats;
+
+	while (keepRunning)
+	{
+		auto now = steady_clock::now();
+		if (now >= nextFlush)
+		{
+			relay.flush();
+			relay.checkUpstream();
+			nextFlush += flushPeriod;
+			if (nextFlush <= now)  // don't try to catch up after a stall
+				nextFlush = now + flushPeriod;
+		}
+
+		if (options.printStats && now >= nextStats)
+		{
+			const Relay::Stats & stats = relay.stats();
+			printf( "clients: %zu, local updates: %llu/s, upstream updates: %llu/s, enumerations: %llu\n",
+				server.clientCount(),
+				(unsigned long long)(stats.localUpdates - lastStats.localUpdates) / 10,
+				(unsigned long long)(stats.upstreamUpdates - lastStats.upstreamUpdates) / 10,
+				(unsigned long long)(stats.enumerations - lastStats.enumerations)
+			);
+			lastStats = stats;
+			nextStats += seconds( 10 );
+		}
+
+		// round up, so that we don't spin during the last millisecond
+		auto timeout = duration_cast< milliseconds >( nextFlush - now + microseconds( 999 ) );
+		status = server.processEvents( timeout );
+		if (status != ServerStatus::Success)
+		{
+			printf( "server failed: %s (error code: %d)\n", enumString( status ), int( server.getLastSystemError() ) );
+			break;
+		}
+	}
+
+	g_server = nullptr;
+	server.stop();
+	return 0;
+}
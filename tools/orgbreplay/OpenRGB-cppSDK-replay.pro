@@ -0,0 +1,20 @@
+TARGET = orgbreplay
+
+TEMPLATE = app
+CONFIG += console
+CONFIG += c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+release: CONFIG += static
+
+QMAKE_CXXFLAGS += -Wno-old-style-cast
+
+INCLUDEPATH += ../../include
+INCLUDEPATH += ../../external
+
+SOURCES += \
+	src/main.cpp
+
+LIBS += -L"../../../build-linux64-release" -lorgbsdk
+LIBS += -lcppnet -lcppbase
+LIBS += -lpthread
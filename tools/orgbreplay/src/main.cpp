@@ -0,0 +1,393 @@
+//======================================================================================================================
+// Project: OpenRGB - C++ SDK
+//----------------------------------------------------------------------------------------------------------------------
+// Author:      Jan Broz (Youda008)
+// Description: replays a recorded traffic log to measure the throughput of the protocol handling
+//======================================================================================================================
+
+#include <OpenRGB/TrafficLog.hpp>
+using namespace orgb;
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+using namespace std;
+using namespace std::chrono;
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define EXECUTABLE_NAME "orgbreplay"
+#define USAGE EXECUTABLE_NAME " <traffic_log> [--max-speed] [--target <host_name>[:<port>]]"
+
+static const uint16_t defaultPort = 6742;
+
+static const size_t headerSize = 16;  // magic, device_idx, message_type, message_size
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Options
+{
+	string logPath;
+	bool maxSpeed = false;
+	bool hasTarget = false;
+	string targetHost;
+	uint16_t targetPort = defaultPort;
+};
+
+static bool parseArgs( int argc, char * argv [], Options & options )
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if (arg == "--max-speed")
+		{
+			options.maxSpeed = true;
+		}
+		else if (arg == "--target" && i + 1 < argc)
+		{
+			string target = argv[++i];
+			options.hasTarget = true;
+			size_t colonPos = target.find(':');
+			options.targetHost = target.substr( 0, colonPos );
+			if (colonPos != string::npos)
+			{
+				long port = strtol( target.c_str() + colonPos + 1, nullptr, 10 );
+				if (port <= 0 || port > 65535)
+					return false;
+				options.targetPort = uint16_t( port );
+			}
+		}
+		else if (options.logPath.empty() && !arg.empty() && arg[0] != '-')
+		{
+			options.logPath = arg;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return !options.logPath.empty();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+//  socket helpers
+
+static bool sendAll( int sock, const uint8_t * data, size_t size )
+{
+	while (size > 0)
+	{
+		ssize_t sent = ::send( sock, data, size, MSG_NOSIGNAL );
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return false;
+		data += sent;
+		size -= size_t( sent );
+	}
+	return true;
+}
+
+static int connectTo( const string & host, uint16_t port )
+{
+	addrinfo hints;
+	memset( &hints, 0, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo * addresses = nullptr;
+	if (getaddrinfo( host.c_str(), to_string( port ).c_str(), &hints, &addresses ) != 0)
+		return -1;
+
+	int sock = -1;
+	for (addrinfo * addr = addresses; addr; addr = addr->ai_next)
+	{
+		sock = ::socket( addr->ai_family, addr->ai_socktype, addr->ai_protocol );
+		if (sock < 0)
+			continue;
+		if (::connect( sock, addr->ai_addr, addr->ai_addrlen ) == 0)
+			break;
+		::close( sock );
+		sock = -1;
+	}
+	freeaddrinfo( addresses );
+
+	if (sock >= 0)
+	{
+		// the recorded messages are already whole, don't let the kernel delay them
+		int one = 1;
+		setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+	}
+	return sock;
+}
+
+/// Counts whole protocol messages in a stream of bytes that arrives in arbitrary pieces.
+class MessageCounter
+{
+ public:
+
+	void feed( const uint8_t * data, size_t size )
+	{
+		bytes += size;
+		while (size > 0)
+		{
+			if (_headerFilled < headerSize)
+			{
+				size_t part = min( headerSize - _headerFilled, size );
+				memcpy( _header + _headerFilled, data, part );
+				_headerFilled += part;
+				data += part;
+				size -= part;
+				if (_headerFilled == headerSize)
+				{
+					uint32_t bodySize;
+					memcpy( &bodySize, _header + 12, sizeof(bodySize) );  // the protocol is little endian as x86
+					_bodyLeft = bodySize;
+				}
+			}
+			else
+			{
+				size_t part = size_t( min< uint64_t >( _bodyLeft, size ) );
+				_bodyLeft -= part;
+				data += part;
+				size -= part;
+			}
+			if (_headerFilled == headerSize && _bodyLeft == 0)
+			{
+				messages++;
+				_headerFilled = 0;
+			}
+		}
+	}
+
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+
+ private:
+
+	uint8_t _header [headerSize];
+	size_t _headerFilled = 0;
+	uint64_t _bodyLeft = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+//  stand-in server
+
+/// Answers with the recorded replies, each one after the client has sent all the requests that preceded it.
+static void serveRecording( int listenSock, const vector< TrafficLogReader::Record > & records )
+{
+	int sock = ::accept( listenSock, nullptr, nullptr );
+	if (sock < 0)
+	{
+		perror( "accept" );
+		return;
+	}
+	int one = 1;
+	setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+
+	vector< uint8_t > scratch( 64 * 1024 );
+	uint64_t receivedBytes = 0;
+	uint64_t expectedBytes = 0;
+	bool clientClosed = false;
+
+	auto receiveSome = [&]()
+	{
+		ssize_t received = ::recv( sock, scratch.data(), scratch.size(), 0 );
+		if (received < 0 && errno == EINTR)
+			return;
+		if (received <= 0)
+			clientClosed = true;
+		else
+			receivedBytes += uint64_t( received );
+	};
+
+	for (const TrafficLogReader::Record & record : records)
+	{
+		if (record.direction == TrafficDirection::Sent)
+		{
+			expectedBytes += record.data.size();
+			continue;
+		}
+		while (receivedBytes < expectedBytes && !clientClosed)
+			receiveSome();
+		if (clientClosed || !sendAll( sock, record.data.data(), record.data.size() ))
+			break;
+	}
+
+	// drain the rest of the requests until the client finishes
+	while (!clientClosed)
+		receiveSome();
+
+	::close( sock );
+}
+
+static int startServer( uint16_t & port )
+{
+	int sock = ::socket( AF_INET, SOCK_STREAM, 0 );
+	if (sock < 0)
+		return -1;
+
+	sockaddr_in addr;
+	memset( &addr, 0, sizeof(addr) );
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	addr.sin_port = 0;  // let the system choose a free one
+	socklen_t addrLen = sizeof(addr);
+	if (::bind( sock, reinterpret_cast< sockaddr * >( &addr ), sizeof(addr) ) != 0
+	 || ::listen( sock, 1 ) != 0
+	 || ::getsockname( sock, reinterpret_cast< sockaddr * >( &addr ), &addrLen ) != 0)
+	{
+		::close( sock );
+		return -1;
+	}
+
+	port = ntohs( addr.sin_port );
+	return sock;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main( int argc, char * argv [] )
+{
+	Options options;
+	if (!parseArgs( argc, argv, options ))
+	{
+		printf( "Usage: " USAGE "\n" );
+		printf( "  --max-speed  send the requests as fast as possible instead of with the recorded timing\n" );
+		printf( "  --target     replay the requests against a real server instead of the recorded replies\n" );
+		return 1;
+	}
+
+	TrafficLogReader reader;
+	if (!reader.open( options.logPath ))
+	{
+		printf( "cannot open %s as a traffic log (error code: %d)\n", options.logPath.c_str(), int( reader.getLastSystemError() ) );
+		return 1;
+	}
+
+	vector< TrafficLogReader::Record > records;
+	TrafficLogReader::Record record;
+	while (reader.next( record ))
+		records.push_back( record );
+
+	// start the stand-in server if there is no real one
+	thread serverThread;
+	int listenSock = -1;
+	string host = options.targetHost;
+	uint16_t port = options.targetPort;
+	if (!options.hasTarget)
+	{
+		listenSock = startServer( port );
+		if (listenSock < 0)
+		{
+			perror( "cannot start the stand-in server" );
+			return 1;
+		}
+		host = "127.0.0.1";
+		serverThread = thread( serveRecording, listenSock, cref( records ) );
+	}
+
+	int sock = connectTo( host, port );
+	if (sock < 0)
+	{
+		printf( "cannot connect to %s:%u\n", host.c_str(), unsigned( port ) );
+		if (listenSock >= 0)
+		{
+			::shutdown( listenSock, SHUT_RDWR );
+			serverThread.join();
+			::close( listenSock );
+		}
+		return 1;
+	}
+
+	if (options.hasTarget)
+	{
+		// a real server never closes the connection, consider the replay finished when it stops replying
+		timeval timeout;
+		timeout.tv_sec = 1;
+		timeout.tv_usec = 0;
+		setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+	}
+
+	auto start = steady_clock::now();
+
+	// drain the replies concurrently, so that neither side blocks on a full socket buffer
+	MessageCounter replies;
+	auto lastReply = start;
+	thread replyThread( [&]()
+	{
+		vector< uint8_t > buffer( 64 * 1024 );
+		for (;;)
+		{
+			ssize_t received = ::recv( sock, buffer.data(), buffer.size(), 0 );
+			if (received < 0 && errno == EINTR)
+				continue;
+			if (received <= 0)
+				break;
+			replies.feed( buffer.data(), size_t( received ) );
+			lastReply = steady_clock::now();
+		}
+	});
+
+	uint64_t sentMessages = 0;
+	uint64_t sentBytes = 0;
+	for (const TrafficLogReader::Record & rec : records)
+	{
+		if (rec.direction != TrafficDirection::Sent)
+			continue;
+		if (!options.maxSpeed)
+			this_thread::sleep_until( start + rec.time );
+		if (!sendAll( sock, rec.data.data(), rec.data.size() ))
+		{
+			perror( "sending failed" );
+			break;
+		}
+		sentMessages++;
+		sentBytes += rec.data.size();
+	}
+
+	auto sendEnd = steady_clock::now();
+
+	// tell the server we're done and wait for the remaining replies
+	::shutdown( sock, SHUT_WR );
+	replyThread.join();
+	if (!options.hasTarget)
+		serverThread.join();
+	auto elapsed = max( sendEnd, lastReply ) - start;
+
+	::close( sock );
+	if (listenSock >= 0)
+		::close( listenSock );
+
+	double seconds = duration_cast< duration< double > >( elapsed ).count();
+	uint64_t totalMessages = sentMessages + replies.messages;
+	uint64_t totalBytes = sentBytes + replies.bytes;
+	printf( "elapsed:  %.3f s\n", seconds );
+	printf( "sent:     %llu messages, %llu bytes\n", (unsigned long long)sentMessages, (unsigned long long)sentBytes );
+	printf( "received: %llu messages, %llu bytes\n", (unsigned long long)replies.messages, (unsigned long long)replies.bytes );
+	if (seconds > 0.0)
+	{
+		printf( "rate:     %.0f msgs/s, %.2f MB/s\n", double( totalMessages ) / seconds, double( totalBytes ) / seconds / 1e6 );
+	}
+
+	return 0;
+}